@@ -0,0 +1,296 @@
+#include <winsock2.h>
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//
+//  UDP query load generator
+//
+//  Keeps a window of A queries outstanding against a DNS server and
+//  reports the answer rate.  Used to measure the server's UDP receive
+//  path (UdpRecvDepth, recv thread placement) over loopback.
+//
+
+#define DNS_PORT            (53)
+#define QUERY_BUFFER_SIZE   (512)
+#define RECV_TIMEOUT_MS     (1000)
+
+#define DEFAULT_SERVER      "127.0.0.1"
+#define DEFAULT_NAME        "localhost"
+#define DEFAULT_QUERIES     (100000)
+#define DEFAULT_WINDOW      (64)
+
+
+VOID
+PrintUsage(
+    VOID )
+{
+    printf(
+        "usage: udpload [server-ip] [name] [queries] [window]\n"
+        "   server-ip   -- DNS server to query (default %s)\n"
+        "   name        -- name to query for A records (default %s)\n"
+        "   queries     -- total number of queries to send (default %d)\n"
+        "   window      -- queries kept outstanding (default %d)\n",
+        DEFAULT_SERVER,
+        DEFAULT_NAME,
+        DEFAULT_QUERIES,
+        DEFAULT_WINDOW );
+}
+
+
+INT
+BuildQuery(
+    OUT     PCHAR       pchBuffer,
+    IN      PCHAR       pszName )
+/*++
+
+Routine Description:
+
+    Build a recursive A query for pszName in pchBuffer.
+    Caller fills in the XID (first two bytes) before each send.
+
+Return Value:
+
+    Length of query, or zero if name does not fit.
+
+--*/
+{
+    PCHAR   pch = pchBuffer;
+    PCHAR   pchLabel;
+    INT     cchLabel;
+
+    //  header -- XID, RD flag, one question
+
+    memset( pch, 0, 12 );
+    pch[2] = 0x01;
+    pch[5] = 0x01;
+    pch += 12;
+
+    //  name as length prefixed labels
+
+    while ( *pszName )
+    {
+        pchLabel = strchr( pszName, '.' );
+        cchLabel = pchLabel
+                        ? (INT)( pchLabel - pszName )
+                        : (INT) strlen( pszName );
+
+        if ( cchLabel == 0 || cchLabel > 63 ||
+             pch + cchLabel + 1 + 5 > pchBuffer + QUERY_BUFFER_SIZE )
+        {
+            return( 0 );
+        }
+        *pch++ = (CHAR) cchLabel;
+        memcpy( pch, pszName, cchLabel );
+        pch += cchLabel;
+        pszName += cchLabel;
+        if ( *pszName == '.' )
+        {
+            pszName++;
+        }
+    }
+    *pch++ = 0;
+
+    //  type A, class IN
+
+    *pch++ = 0;
+    *pch++ = 1;
+    *pch++ = 0;
+    *pch++ = 1;
+
+    return( (INT)( pch - pchBuffer ) );
+}
+
+
+_cdecl
+main(int argc, char **argv)
+{
+    WSADATA         wsaData;
+    SOCKET          s = INVALID_SOCKET;
+    SOCKADDR_IN     sockaddr;
+    CHAR            query[ QUERY_BUFFER_SIZE ];
+    CHAR            response[ QUERY_BUFFER_SIZE ];
+    INT             cbQuery;
+    PCHAR           pszServer = DEFAULT_SERVER;
+    PCHAR           pszName = DEFAULT_NAME;
+    DWORD           cQueries = DEFAULT_QUERIES;
+    DWORD           cWindow = DEFAULT_WINDOW;
+    DWORD           cSent = 0;
+    DWORD           cAnswered = 0;
+    DWORD           cLost = 0;
+    DWORD           cOutstanding = 0;
+    DWORD           startTime;
+    DWORD           elapsed;
+    WORD            xid = 0;
+    fd_set          readSet;
+    struct timeval  timeout;
+    INT             status;
+
+    if ( argc > 1 && ( argv[1][0] == '-' || argv[1][0] == '/' ) )
+    {
+        PrintUsage();
+        return( 1 );
+    }
+    if ( argc > 1 )
+    {
+        pszServer = argv[1];
+    }
+    if ( argc > 2 )
+    {
+        pszName = argv[2];
+    }
+    if ( argc > 3 )
+    {
+        cQueries = strtoul( argv[3], NULL, 10 );
+    }
+    if ( argc > 4 )
+    {
+        cWindow = strtoul( argv[4], NULL, 10 );
+    }
+    if ( cQueries == 0 || cWindow == 0 )
+    {
+        PrintUsage();
+        return( 1 );
+    }
+
+    cbQuery = BuildQuery( query, pszName );
+    if ( !cbQuery )
+    {
+        printf( "Invalid query name %s.\n", pszName );
+        return( 1 );
+    }
+
+    status = WSAStartup( MAKEWORD( 2, 0 ), &wsaData );
+    if ( status != 0 )
+    {
+        printf( "WSAStartup failed %d.\n", status );
+        return( 1 );
+    }
+
+    memset( &sockaddr, 0, sizeof(sockaddr) );
+    sockaddr.sin_family = AF_INET;
+    sockaddr.sin_port = htons( DNS_PORT );
+    sockaddr.sin_addr.s_addr = inet_addr( pszServer );
+    if ( sockaddr.sin_addr.s_addr == INADDR_NONE )
+    {
+        printf( "Invalid server address %s.\n", pszServer );
+        goto Done;
+    }
+
+    //  connected socket, so only this server's answers are received
+
+    s = socket( AF_INET, SOCK_DGRAM, 0 );
+    if ( s == INVALID_SOCKET ||
+         connect( s, (PSOCKADDR) &sockaddr, sizeof(sockaddr) ) == SOCKET_ERROR )
+    {
+        printf( "Socket setup failed %d.\n", WSAGetLastError() );
+        goto Done;
+    }
+
+    printf(
+        "Sending %d queries for %s to %s, %d outstanding . . .\n",
+        cQueries,
+        pszName,
+        pszServer,
+        cWindow );
+
+    startTime = GetTickCount();
+
+    while ( cAnswered + cLost < cQueries )
+    {
+        //  fill the window
+
+        while ( cOutstanding < cWindow && cSent < cQueries )
+        {
+            xid++;
+            query[0] = (CHAR)( xid >> 8 );
+            query[1] = (CHAR)( xid & 0xff );
+
+            if ( send( s, query, cbQuery, 0 ) == SOCKET_ERROR )
+            {
+                printf( "send failed %d.\n", WSAGetLastError() );
+                goto Done;
+            }
+            cSent++;
+            cOutstanding++;
+        }
+
+        FD_ZERO( &readSet );
+        FD_SET( s, &readSet );
+        timeout.tv_sec = RECV_TIMEOUT_MS / 1000;
+        timeout.tv_usec = ( RECV_TIMEOUT_MS % 1000 ) * 1000;
+
+        status = select( 0, &readSet, NULL, NULL, &timeout );
+        if ( status == SOCKET_ERROR )
+        {
+            printf( "select failed %d.\n", WSAGetLastError() );
+            goto Done;
+        }
+
+        //  nothing back in the timeout, everything outstanding is lost
+
+        if ( status == 0 )
+        {
+            cLost += cOutstanding;
+            cOutstanding = 0;
+            continue;
+        }
+
+        //  drain what has arrived
+
+        while ( cOutstanding )
+        {
+            status = recv( s, response, sizeof(response), 0 );
+            if ( status == SOCKET_ERROR )
+            {
+                status = WSAGetLastError();
+                if ( status == WSAECONNRESET )
+                {
+                    printf( "No server listening on %s.\n", pszServer );
+                    goto Done;
+                }
+                printf( "recv failed %d.\n", status );
+                goto Done;
+            }
+            cAnswered++;
+            cOutstanding--;
+
+            FD_ZERO( &readSet );
+            FD_SET( s, &readSet );
+            timeout.tv_sec = 0;
+            timeout.tv_usec = 0;
+            if ( select( 0, &readSet, NULL, NULL, &timeout ) != 1 )
+            {
+                break;
+            }
+        }
+    }
+
+    elapsed = GetTickCount() - startTime;
+    if ( elapsed == 0 )
+    {
+        elapsed = 1;
+    }
+
+    printf(
+        "Sent      %d\n"
+        "Answered  %d\n"
+        "Lost      %d\n"
+        "Elapsed   %d ms\n"
+        "Rate      %d answers/sec\n",
+        cSent,
+        cAnswered,
+        cLost,
+        elapsed,
+        (DWORD)( (ULONGLONG)cAnswered * 1000 / elapsed ) );
+
+Done:
+
+    if ( s != INVALID_SOCKET )
+    {
+        closesocket( s );
+    }
+    WSACleanup();
+    return( 0 );
+}
@@ -179,9 +179,13 @@ on return from that routine.
 #define UDPMESSAGEMEMORY_OFFSET     CACHINGMEMORY_OFFSET        + sizeof(DWORD)
 #define TCPMESSAGEMEMORY_OFFSET     UDPMESSAGEMEMORY_OFFSET     + sizeof(DWORD)
 #define NBSTATMEMORY_OFFSET         TCPMESSAGEMEMORY_OFFSET     + sizeof(DWORD)
+#define DATABASELOCKCONTENTION_OFFSET \
+                                    NBSTATMEMORY_OFFSET         + sizeof(DWORD)
+#define DATABASELOCKWAITTIME_OFFSET \
+                                    DATABASELOCKCONTENTION_OFFSET + sizeof(DWORD)
 
 #define SIZE_OF_DNS_PERFORMANCE_DATA \
-                                    NBSTATMEMORY_OFFSET         + sizeof(DWORD)
+                                    DATABASELOCKWAITTIME_OFFSET + sizeof(DWORD)
 
 
 
@@ -256,6 +260,9 @@ typedef struct _DNS_DATA_DEFINITION
     PERF_COUNTER_DEFINITION     UdpMessageMemory;
     PERF_COUNTER_DEFINITION     TcpMessageMemory;
     PERF_COUNTER_DEFINITION     NbstatMemory;
+    PERF_COUNTER_DEFINITION     DatabaseLockContention;
+    PERF_COUNTER_DEFINITION     DatabaseLockContention_s;
+    PERF_COUNTER_DEFINITION     DatabaseLockWaitTime;
 
 } DNS_DATA_DEFINITION;
 
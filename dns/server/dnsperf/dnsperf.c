@@ -505,6 +505,15 @@ Return Value:
         DnsDataDefinition.NbstatMemory.CounterNameTitleIndex += dwFirstCounter;
         DnsDataDefinition.NbstatMemory.CounterHelpTitleIndex += dwFirstHelp;
 
+        DnsDataDefinition.DatabaseLockContention.CounterNameTitleIndex += dwFirstCounter;
+        DnsDataDefinition.DatabaseLockContention.CounterHelpTitleIndex += dwFirstHelp;
+
+        DnsDataDefinition.DatabaseLockContention_s.CounterNameTitleIndex += dwFirstCounter;
+        DnsDataDefinition.DatabaseLockContention_s.CounterHelpTitleIndex += dwFirstHelp;
+
+        DnsDataDefinition.DatabaseLockWaitTime.CounterNameTitleIndex += dwFirstCounter;
+        DnsDataDefinition.DatabaseLockWaitTime.CounterHelpTitleIndex += dwFirstHelp;
+
         RegCloseKey( hKeyDriverPerf ); // close key to registry
 
         bInitOK = TRUE; // ok to use this function
@@ -1576,6 +1585,45 @@ DNS_DATA_DEFINITION DnsDataDefinition =
         NBSTATMEMORY_OFFSET                     // CounterOffset
     },
 
+    // database lock contention
+    {   sizeof(PERF_COUNTER_DEFINITION),        // ByteLength
+        DATABASELOCKCONTENTION,                 // CounterNameTitleIndex
+        0,                                      // CounterNameTitle
+        DATABASELOCKCONTENTION,                 // CounterHelpTitleIndex
+        0,                                      // CounterHelpTitle
+        0,                                      // DefaultScale
+        PERF_DETAIL_NOVICE,                     // DetailLevel
+        PERF_COUNTER_RAWCOUNT,                  // CounterType
+        sizeof(DWORD),                          // CounterSize
+        DATABASELOCKCONTENTION_OFFSET           // CounterOffset
+    },
+
+    // database lock contention/sec
+    {   sizeof(PERF_COUNTER_DEFINITION),        // ByteLength
+        DATABASELOCKCONTENTION_S,               // CounterNameTitleIndex
+        0,                                      // CounterNameTitle
+        DATABASELOCKCONTENTION_S,               // CounterHelpTitleIndex
+        0,                                      // CounterHelpTitle
+        0,                                      // DefaultScale
+        PERF_DETAIL_NOVICE,                     // DetailLevel
+        PERF_COUNTER_COUNTER,                   // CounterType
+        sizeof(DWORD),                          // CounterSize
+        DATABASELOCKCONTENTION_OFFSET           // CounterOffset
+    },
+
+    // database lock wait time
+    {   sizeof(PERF_COUNTER_DEFINITION),        // ByteLength
+        DATABASELOCKWAITTIME,                   // CounterNameTitleIndex
+        0,                                      // CounterNameTitle
+        DATABASELOCKWAITTIME,                   // CounterHelpTitleIndex
+        0,                                      // CounterHelpTitle
+        0,                                      // DefaultScale
+        PERF_DETAIL_NOVICE,                     // DetailLevel
+        PERF_COUNTER_RAWCOUNT,                  // CounterType
+        sizeof(DWORD),                          // CounterSize
+        DATABASELOCKWAITTIME_OFFSET             // CounterOffset
+    },
+
 
 };
 
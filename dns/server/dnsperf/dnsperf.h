@@ -81,6 +81,9 @@
 #define UDPMESSAGEMEMORY                120
 #define TCPMESSAGEMEMORY                122
 #define NBSTATMEMORY                    124
+#define DATABASELOCKCONTENTION          126
+#define DATABASELOCKCONTENTION_S        128
+#define DATABASELOCKWAITTIME            130
 
 #define DNS_PERF_COUNTER_BLOCK  TEXT("Global\\Microsoft.Windows.DNS.Perf")
 
@@ -130,6 +133,8 @@ extern volatile unsigned long * pcCachingMemory;
 extern volatile unsigned long * pcUdpMessageMemory;
 extern volatile unsigned long * pcTcpMessageMemory;
 extern volatile unsigned long * pcNbstatMemory;
+extern volatile unsigned long * pcDatabaseLockContention;
+extern volatile unsigned long * pcDatabaseLockWaitTime;
 
 
 #define PERF_INC(p)         ( ++(*(p)) )
@@ -139,5 +144,5 @@ extern volatile unsigned long * pcNbstatMemory;
 #define PERF_SET(p, c)      ( (*(p)) =  (c) )
 
 
-#define DNS_PERFORMANCE_COUNTER_VERSION 1
+#define DNS_PERFORMANCE_COUNTER_VERSION 2
 
@@ -0,0 +1,856 @@
+/*++
+
+Copyright (c) 2003 Microsoft Corporation
+
+Module Name:
+
+    anscache.c
+
+Abstract:
+
+    Domain Name System (DNS) Server
+
+    Pre-built answer cache.
+
+    Authoritative answers to popular questions are saved in wire format
+    as they are sent, so repeats of the same question can be answered
+    with a hash lookup and a copy rather than a database walk and a
+    complete rewrite of every record.
+
+Author:
+
+Revision History:
+
+--*/
+
+
+#include "dnssrv.h"
+
+
+//
+//  Answer cache
+//
+//  Only answers which depend on nothing but the question and the zone
+//  data are saved:
+//      - UDP, NOERROR, authoritative, not truncated
+//      - no CNAME chain (may cross zones or into the cache)
+//      - no recursion or WINS lookup while answering
+//      - no round robin or local net reordering of the RR set
+//          (Wire_ routines flag the message when they do this)
+//
+//  Key is question name (case-insensitive), type, class, RD bit, DNSSEC
+//  inclusion and usable UDP buffer length.  Since the question name is
+//  identical in length, the saved body (everything after the question)
+//  is dropped in behind the client's own question;  compressed names in
+//  the body point back at it, so the client sees its own name casing.
+//
+//  An entry is dropped when
+//      - its age exceeds AnswerCacheMaxAge seconds
+//      - the zone's answer cache version has moved (update, reload)
+//      - the cache is flushed (zone created or removed)
+//
+//  Additional data may come from other zones or the cache;  this is
+//  only as stale as the entry age, which is why the age is kept short
+//  and is capped well below the timeout free delay -- the entry holds
+//  a zone pointer and zone blocks are only freed through timeout free.
+//
+
+#define ANSCACHE_HASH_SIZE          (4096)      //  power of two
+#define ANSCACHE_HASH_MASK          (ANSCACHE_HASH_SIZE - 1)
+
+#define ANSCACHE_LOCK_COUNT         (32)        //  power of two
+#define ANSCACHE_LOCK_FOR_HASH( h ) ( &g_AnsCacheLock[ (h) & (ANSCACHE_LOCK_COUNT-1) ] )
+
+#define ANSCACHE_MAX_ENTRIES        (8192)
+#define ANSCACHE_MAX_AGE_LIMIT      (60)
+
+#define ANSCACHE_FLAG_RD            (0x01)
+#define ANSCACHE_FLAG_DNSSEC        (0x02)
+
+
+typedef struct _AnswerCacheEntry
+{
+    struct _AnswerCacheEntry *  pNext;
+    PZONE_INFO      pZone;
+    DWORD           dwZoneVersion;
+    DWORD           dwFlushGeneration;
+    DWORD           dwExpireTime;
+    DWORD           dwHash;
+    DWORD           cbAlloc;
+    WORD            wType;
+    WORD            wClass;
+    WORD            wBufferLength;
+    WORD            cchName;
+    WORD            cbBody;
+    UCHAR           fFlags;
+    UCHAR           Pad;
+    DNS_HEADER      Head;               //  counts in host order
+    CHAR            Data[1];            //  question name, then body
+}
+ANSCACHE_ENTRY, *PANSCACHE_ENTRY;
+
+
+typedef struct _AnswerCacheKey
+{
+    PCHAR           pchName;
+    DWORD           dwHash;
+    WORD            cchName;
+    WORD            wType;
+    WORD            wClass;
+    WORD            wBufferLength;
+    UCHAR           fFlags;
+}
+ANSCACHE_KEY, *PANSCACHE_KEY;
+
+
+//
+//  Cache globals
+//
+
+BOOL                g_AnsCacheInitialized = FALSE;
+
+PANSCACHE_ENTRY     g_AnsCacheTable[ ANSCACHE_HASH_SIZE ];
+
+CRITICAL_SECTION    g_AnsCacheLock[ ANSCACHE_LOCK_COUNT ];
+
+LONG                g_AnsCacheEntryCount;
+
+//  moves on every invalidation;  query snapshot guards against saving
+//  an answer built from data that changed while it was being built
+
+LONG                g_AnsCacheGeneration;
+
+//  moves on flush;  entries of earlier generation are dead
+
+LONG                g_AnsCacheFlushGeneration;
+
+//  stats
+
+LONG                g_AnsCacheHits;
+LONG                g_AnsCacheMisses;
+LONG                g_AnsCacheInserts;
+LONG                g_AnsCacheStale;
+
+
+#define ANSCACHE_MAX_AGE() \
+            ( min( SrvCfg_dwAnswerCacheMaxAge, ANSCACHE_MAX_AGE_LIMIT ) )
+
+
+
+//
+//  Private utilities
+//
+
+WORD
+ansCacheBufferLength(
+    IN      PDNS_MSGINFO    pMsg
+    )
+/*++
+
+Routine Description:
+
+    Get usable UDP buffer length for response.
+
+    Must match the buffer length set in Answer_QuestionFromDatabase().
+
+Arguments:
+
+    pMsg -- query
+
+Return Value:
+
+    Buffer length response will be written to.
+
+--*/
+{
+    WORD    payload = pMsg->Opt.wOriginalQueryPayloadSize;
+
+    if ( payload > DNS_RFC_MAX_UDP_PACKET_LENGTH )
+    {
+        return (WORD) min( SrvCfg_dwMaxUdpPacketSize, payload );
+    }
+    return DNS_RFC_MAX_UDP_PACKET_LENGTH;
+}
+
+
+
+BOOL
+ansCacheBuildKey(
+    IN      PDNS_MSGINFO    pMsg,
+    OUT     PANSCACHE_KEY   pKey
+    )
+/*++
+
+Routine Description:
+
+    Build answer cache key for query.
+
+Arguments:
+
+    pMsg -- query, question already parsed
+
+    pKey -- key to fill in
+
+Return Value:
+
+    TRUE if query can be keyed.
+    FALSE if not (compressed or odd question name).
+
+--*/
+{
+    PUCHAR  pch = (PUCHAR) pMsg->MessageBody;
+    PUCHAR  pchend = (PUCHAR) pMsg->pQuestion;
+    DWORD   hash = 0;
+    UCHAR   ch;
+    UCHAR   labelLength;
+
+    if ( !pchend || pchend <= pch || pchend - pch > DNS_MAX_NAME_LENGTH + 1 )
+    {
+        return FALSE;
+    }
+
+    //
+    //  walk the labels
+    //      - no compression or extended labels
+    //      - name must end exactly at the question
+    //      - hash on lower case, length bytes can't be letters
+    //
+
+    while ( pch < pchend )
+    {
+        labelLength = *pch;
+        if ( labelLength & 0xC0 )
+        {
+            return FALSE;
+        }
+        if ( labelLength == 0 )
+        {
+            pch++;
+            break;
+        }
+        pch += labelLength + 1;
+    }
+    if ( pch != pchend )
+    {
+        return FALSE;
+    }
+
+    for ( pch = (PUCHAR) pMsg->MessageBody; pch < pchend; pch++ )
+    {
+        ch = *pch;
+        if ( ch >= 'A' && ch <= 'Z' )
+        {
+            ch += 'a' - 'A';
+        }
+        hash = ( hash << 5 ) + hash + ch;
+    }
+
+    pKey->pchName       = pMsg->MessageBody;
+    pKey->cchName       = (WORD) ( pchend - (PUCHAR) pMsg->MessageBody );
+    pKey->wType         = pMsg->wQuestionType;
+    pKey->wClass        = pMsg->pQuestion->QuestionClass;
+    pKey->wBufferLength = ansCacheBufferLength( pMsg );
+    pKey->fFlags        = 0;
+
+    if ( pMsg->Head.RecursionDesired )
+    {
+        pKey->fFlags |= ANSCACHE_FLAG_RD;
+    }
+    if ( DNSMSG_INCLUDE_DNSSEC_IN_RESPONSE( pMsg ) )
+    {
+        pKey->fFlags |= ANSCACHE_FLAG_DNSSEC;
+    }
+
+    pKey->dwHash = hash + pKey->wType;
+
+    return TRUE;
+}
+
+
+
+BOOL
+ansCacheKeyMatch(
+    IN      PANSCACHE_ENTRY pEntry,
+    IN      PANSCACHE_KEY   pKey
+    )
+/*++
+
+Routine Description:
+
+    Check if entry matches key.
+
+Arguments:
+
+    pEntry -- cache entry
+
+    pKey -- key
+
+Return Value:
+
+    TRUE if match.
+    FALSE otherwise.
+
+--*/
+{
+    PUCHAR  pch1;
+    PUCHAR  pch2;
+    UCHAR   ch1;
+    UCHAR   ch2;
+    DWORD   i;
+
+    if ( pEntry->dwHash != pKey->dwHash ||
+         pEntry->wType != pKey->wType ||
+         pEntry->wClass != pKey->wClass ||
+         pEntry->wBufferLength != pKey->wBufferLength ||
+         pEntry->fFlags != pKey->fFlags ||
+         pEntry->cchName != pKey->cchName )
+    {
+        return FALSE;
+    }
+
+    pch1 = (PUCHAR) pEntry->Data;
+    pch2 = (PUCHAR) pKey->pchName;
+
+    for ( i = 0; i < pKey->cchName; i++ )
+    {
+        ch1 = pch1[i];
+        ch2 = pch2[i];
+        if ( ch1 == ch2 )
+        {
+            continue;
+        }
+        if ( ch1 >= 'A' && ch1 <= 'Z' )
+        {
+            ch1 += 'a' - 'A';
+        }
+        if ( ch2 >= 'A' && ch2 <= 'Z' )
+        {
+            ch2 += 'a' - 'A';
+        }
+        if ( ch1 != ch2 )
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+
+
+BOOL
+ansCacheIsEntryValid(
+    IN      PANSCACHE_ENTRY pEntry
+    )
+/*++
+
+Routine Description:
+
+    Check if entry may still be used.
+
+    Age is checked first, so zone is never touched on entry old enough
+    that the zone block might have been freed.
+
+Arguments:
+
+    pEntry -- cache entry
+
+Return Value:
+
+    TRUE if entry is valid.
+    FALSE if entry is stale.
+
+--*/
+{
+    PZONE_INFO  pzone;
+
+    if ( DNS_TIME() > pEntry->dwExpireTime ||
+         pEntry->dwFlushGeneration != (DWORD) g_AnsCacheFlushGeneration )
+    {
+        return FALSE;
+    }
+
+    pzone = pEntry->pZone;
+
+    if ( pzone->dwAnswerCacheVersion != pEntry->dwZoneVersion ||
+         IS_ZONE_INACTIVE( pzone ) )
+    {
+        return FALSE;
+    }
+    return TRUE;
+}
+
+
+
+VOID
+ansCacheFreeEntry(
+    IN OUT  PANSCACHE_ENTRY pEntry
+    )
+/*++
+
+Routine Description:
+
+    Free cache entry.
+
+Arguments:
+
+    pEntry -- cache entry, already cut from table
+
+Return Value:
+
+    None
+
+--*/
+{
+    InterlockedDecrement( &g_AnsCacheEntryCount );
+    FREE_TAGHEAP( pEntry, pEntry->cbAlloc, MEMTAG_STUFF );
+}
+
+
+
+//
+//  Public answer cache routines
+//
+
+BOOL
+AnsCache_Initialize(
+    VOID
+    )
+/*++
+
+Routine Description:
+
+    Initialize answer cache.
+
+Arguments:
+
+    None
+
+Return Value:
+
+    TRUE if successful.
+    FALSE on error.
+
+--*/
+{
+    DWORD   i;
+
+    g_AnsCacheInitialized = FALSE;
+
+    RtlZeroMemory( g_AnsCacheTable, sizeof(g_AnsCacheTable) );
+
+    g_AnsCacheEntryCount        = 0;
+    g_AnsCacheGeneration        = 0;
+    g_AnsCacheFlushGeneration   = 0;
+    g_AnsCacheHits              = 0;
+    g_AnsCacheMisses            = 0;
+    g_AnsCacheInserts           = 0;
+    g_AnsCacheStale             = 0;
+
+    for ( i = 0; i < ANSCACHE_LOCK_COUNT; i++ )
+    {
+        if ( DnsInitializeCriticalSection( &g_AnsCacheLock[i] ) != ERROR_SUCCESS )
+        {
+            return FALSE;
+        }
+    }
+
+    g_AnsCacheInitialized = TRUE;
+    return TRUE;
+}
+
+
+
+BOOL
+AnsCache_Lookup(
+    IN OUT  PDNS_MSGINFO    pMsg
+    )
+/*++
+
+Routine Description:
+
+    Answer query from answer cache.
+
+    Query must be fully set up for response (as for Answer_Question()).
+    On hit the response is sent and the message freed.
+
+Arguments:
+
+    pMsg -- query
+
+Return Value:
+
+    TRUE if answered from cache -- message is gone.
+    FALSE if not in cache -- answer normally.
+
+--*/
+{
+    ANSCACHE_KEY        key;
+    PANSCACHE_ENTRY     pentry;
+    LPCRITICAL_SECTION  plock;
+    WORD                xid;
+    WORD                cbbody = 0;
+    BOOL                fhit = FALSE;
+
+    //  snapshot generation for AnsCache_Insert() of answer built by
+    //  normal lookup
+
+    pMsg->dwAnswerCacheGeneration = (DWORD) g_AnsCacheGeneration;
+
+    if ( !g_AnsCacheInitialized ||
+         !SrvCfg_dwAnswerCacheMaxAge ||
+         pMsg->fTcp ||
+         !ansCacheBuildKey( pMsg, &key ) )
+    {
+        return FALSE;
+    }
+
+    plock = ANSCACHE_LOCK_FOR_HASH( key.dwHash );
+    EnterCriticalSection( plock );
+
+    for ( pentry = g_AnsCacheTable[ key.dwHash & ANSCACHE_HASH_MASK ];
+          pentry;
+          pentry = pentry->pNext )
+    {
+        if ( !ansCacheKeyMatch( pentry, &key ) )
+        {
+            continue;
+        }
+        if ( !ansCacheIsEntryValid( pentry ) )
+        {
+            InterlockedIncrement( &g_AnsCacheStale );
+            break;
+        }
+
+        //
+        //  copy in saved response
+        //      - header, keeping client's XID
+        //      - body after client's question
+        //
+
+        xid = pMsg->Head.Xid;
+        RtlCopyMemory( &pMsg->Head, &pentry->Head, sizeof(DNS_HEADER) );
+        pMsg->Head.Xid = xid;
+
+        cbbody = pentry->cbBody;
+        RtlCopyMemory(
+            (PCHAR) (pMsg->pQuestion + 1),
+            pentry->Data + pentry->cchName,
+            cbbody );
+        fhit = TRUE;
+        break;
+    }
+
+    LeaveCriticalSection( plock );
+
+    if ( !fhit )
+    {
+        InterlockedIncrement( &g_AnsCacheMisses );
+        return FALSE;
+    }
+
+    InterlockedIncrement( &g_AnsCacheHits );
+
+    DNS_DEBUG( LOOKUP, (
+        "Answered query %p from answer cache (%d byte body)\n",
+        pMsg,
+        cbbody ));
+
+    //
+    //  set message as normal answer would be before Send_QueryResponse()
+    //
+
+    pMsg->BufferLength = key.wBufferLength;
+    pMsg->pBufferEnd = DNSMSG_PTR_FOR_OFFSET( pMsg, pMsg->BufferLength );
+    pMsg->pCurrent = (PCHAR) (pMsg->pQuestion + 1) + cbbody;
+    ASSERT( pMsg->pCurrent <= pMsg->pBufferEnd );
+
+    pMsg->fDelete = TRUE;
+    SET_OPT_BASED_ON_ORIGINAL_QUERY( pMsg );
+
+    Send_Msg( pMsg, 0 );
+    return TRUE;
+}
+
+
+
+VOID
+AnsCache_Insert(
+    IN OUT  PDNS_MSGINFO    pMsg
+    )
+/*++
+
+Routine Description:
+
+    Save response in answer cache, if it qualifies.
+
+    Called with completed response, before Send_Msg() adds OPT and
+    flips counts.
+
+Arguments:
+
+    pMsg -- response about to be sent
+
+Return Value:
+
+    None
+
+--*/
+{
+    ANSCACHE_KEY        key;
+    PANSCACHE_ENTRY     pentry;
+    PANSCACHE_ENTRY     pnew;
+    PANSCACHE_ENTRY *   ppprev;
+    LPCRITICAL_SECTION  plock;
+    PZONE_INFO          pzone;
+    PCHAR               pbody;
+    DWORD               cbbody;
+    DWORD               length;
+
+    if ( !g_AnsCacheInitialized ||
+         !SrvCfg_dwAnswerCacheMaxAge ||
+         pMsg->fTcp )
+    {
+        return;
+    }
+
+    //
+    //  only answers that depend on question and zone data alone
+    //
+
+    if ( !pMsg->Head.Authoritative ||
+         pMsg->Head.Truncation ||
+         pMsg->Head.ResponseCode != DNS_RCODE_NOERROR ||
+         pMsg->Head.AnswerCount == 0 ||
+         pMsg->fNoAnswerCache ||
+         pMsg->fQuestionRecursed ||
+         pMsg->cCnameAnswerCount ||
+         pMsg->Opt.wOptOffset ||
+         !pMsg->pNodeQuestion )
+    {
+        return;
+    }
+
+    pzone = pMsg->pNodeQuestion->pZone;
+    if ( !pzone ||
+         IS_ZONE_CACHE( pzone ) ||
+         IS_ZONE_INACTIVE( pzone ) )
+    {
+        return;
+    }
+
+    //  zone data changed while this answer was built?
+
+    if ( pMsg->dwAnswerCacheGeneration != (DWORD) g_AnsCacheGeneration )
+    {
+        return;
+    }
+
+    if ( g_AnsCacheEntryCount >= ANSCACHE_MAX_ENTRIES )
+    {
+        return;
+    }
+
+    if ( !ansCacheBuildKey( pMsg, &key ) )
+    {
+        return;
+    }
+
+    pbody = (PCHAR) (pMsg->pQuestion + 1);
+    cbbody = (DWORD) ( (PCHAR)pMsg->pCurrent - pbody );
+    if ( cbbody == 0 || cbbody > key.wBufferLength )
+    {
+        return;
+    }
+
+    //
+    //  build entry
+    //
+
+    length = sizeof(ANSCACHE_ENTRY) + key.cchName + cbbody;
+
+    pnew = (PANSCACHE_ENTRY) ALLOC_TAGHEAP( length, MEMTAG_STUFF );
+    IF_NOMEM( !pnew )
+    {
+        return;
+    }
+    pnew->pNext             = NULL;
+    pnew->pZone             = pzone;
+    pnew->dwZoneVersion     = pzone->dwAnswerCacheVersion;
+    pnew->dwFlushGeneration = (DWORD) g_AnsCacheFlushGeneration;
+    pnew->dwExpireTime      = DNS_TIME() + ANSCACHE_MAX_AGE();
+    pnew->dwHash            = key.dwHash;
+    pnew->cbAlloc           = length;
+    pnew->wType             = key.wType;
+    pnew->wClass            = key.wClass;
+    pnew->wBufferLength     = key.wBufferLength;
+    pnew->cchName           = key.cchName;
+    pnew->cbBody            = (WORD) cbbody;
+    pnew->fFlags            = key.fFlags;
+    pnew->Pad               = 0;
+
+    RtlCopyMemory( &pnew->Head, &pMsg->Head, sizeof(DNS_HEADER) );
+    RtlCopyMemory( pnew->Data, key.pchName, key.cchName );
+    RtlCopyMemory( pnew->Data + key.cchName, pbody, cbbody );
+
+    InterlockedIncrement( &g_AnsCacheEntryCount );
+
+    //
+    //  replace any existing entry for key, drop stale entries in bucket
+    //
+
+    plock = ANSCACHE_LOCK_FOR_HASH( key.dwHash );
+    EnterCriticalSection( plock );
+
+    ppprev = &g_AnsCacheTable[ key.dwHash & ANSCACHE_HASH_MASK ];
+
+    while ( pentry = *ppprev )
+    {
+        if ( ansCacheKeyMatch( pentry, &key ) ||
+             !ansCacheIsEntryValid( pentry ) )
+        {
+            *ppprev = pentry->pNext;
+            ansCacheFreeEntry( pentry );
+            continue;
+        }
+        ppprev = &pentry->pNext;
+    }
+
+    pnew->pNext = g_AnsCacheTable[ key.dwHash & ANSCACHE_HASH_MASK ];
+    g_AnsCacheTable[ key.dwHash & ANSCACHE_HASH_MASK ] = pnew;
+
+    LeaveCriticalSection( plock );
+
+    InterlockedIncrement( &g_AnsCacheInserts );
+}
+
+
+
+VOID
+AnsCache_InvalidateZone(
+    IN OUT  PZONE_INFO      pZone
+    )
+/*++
+
+Routine Description:
+
+    Invalidate saved answers for zone.
+
+    Call AFTER zone data is changed.
+
+Arguments:
+
+    pZone -- zone whose data changed
+
+Return Value:
+
+    None
+
+--*/
+{
+    if ( !pZone )
+    {
+        return;
+    }
+    InterlockedIncrement( (PLONG) &pZone->dwAnswerCacheVersion );
+    InterlockedIncrement( &g_AnsCacheGeneration );
+}
+
+
+
+VOID
+AnsCache_Flush(
+    VOID
+    )
+/*++
+
+Routine Description:
+
+    Invalidate all saved answers.
+
+    Used when zones come or go, as this changes which zone is
+    authoritative for a name.
+
+Arguments:
+
+    None
+
+Return Value:
+
+    None
+
+--*/
+{
+    InterlockedIncrement( &g_AnsCacheFlushGeneration );
+    InterlockedIncrement( &g_AnsCacheGeneration );
+}
+
+
+
+VOID
+AnsCache_Cleanup(
+    VOID
+    )
+/*++
+
+Routine Description:
+
+    Free stale answer cache entries.
+
+    Called periodically by timeout thread.
+
+Arguments:
+
+    None
+
+Return Value:
+
+    None
+
+--*/
+{
+    PANSCACHE_ENTRY     pentry;
+    PANSCACHE_ENTRY *   ppprev;
+    DWORD               i;
+
+    if ( !g_AnsCacheInitialized )
+    {
+        return;
+    }
+
+    DNS_DEBUG( TIMEOUT, (
+        "Answer cache cleanup:  entries %d, hits %d, misses %d, inserts %d, stale %d\n",
+        g_AnsCacheEntryCount,
+        g_AnsCacheHits,
+        g_AnsCacheMisses,
+        g_AnsCacheInserts,
+        g_AnsCacheStale ));
+
+    for ( i = 0; i < ANSCACHE_HASH_SIZE; i++ )
+    {
+        if ( !g_AnsCacheTable[i] )
+        {
+            continue;
+        }
+
+        EnterCriticalSection( ANSCACHE_LOCK_FOR_HASH( i ) );
+
+        ppprev = &g_AnsCacheTable[i];
+
+        while ( pentry = *ppprev )
+        {
+            if ( !ansCacheIsEntryValid( pentry ) )
+            {
+                *ppprev = pentry->pNext;
+                ansCacheFreeEntry( pentry );
+                continue;
+            }
+            ppprev = &pentry->pNext;
+        }
+
+        LeaveCriticalSection( ANSCACHE_LOCK_FOR_HASH( i ) );
+    }
+}
+
+//
+//  End anscache.c
+//
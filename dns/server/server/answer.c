@@ -553,6 +553,16 @@ Return Value:
 
     pMsg->Opt.wOriginalQueryPayloadSize = pMsg->Opt.wUdpPayloadSize;
 
+    //
+    //  try saved answer first
+    //      - on hit response is sent and message freed
+    //
+
+    if ( AnsCache_Lookup( pMsg ) )
+    {
+        goto Done;
+    }
+
     Answer_Question( pMsg );
     goto Done;
 
@@ -77,17 +77,64 @@ PDB_NODE    g_pCacheLocalNode;
 //  Simple solution is ONE database lock.  Causes a few more thread context
 //  switches, but simple and effective.
 //
+//  Lockless authoritative answers:
+//  Answers from authoritative nodes for types that are not round robined
+//  walk the RR list without this lock (Wire_WriteRecordsAtNodeToMessage).
+//  This is safe because
+//      - code changing a list -- including the update swap of a temporary
+//          node's list onto the real node -- marks the lock hold as a write
+//          to the node's zone (MARK_RR_LIST_WRITE);  a lockless reader that
+//          overlaps a write to its zone throws away what it read and
+//          answers under the lock instead
+//      - zone records freed during a marked hold, and lists swapped out by
+//          update, go through the timeout slow free, so a record cut from
+//          a list stays valid for the rest of the walk;  the reader gives
+//          up at the first record of any other rank
+//  Round robin relinks the list it answers from, and cache records time
+//  out and are cut by readers, so those answers still take the lock.
+//
 
 
 CRITICAL_SECTION    DbaseLockCs;
 DWORD               DbaseLockCount;
 DWORD               DbaseLockThread;
 
+//  Zones whose RR lists the lock holder is changing (MARK_RR_LIST_WRITE).
+//  The sequence of each is odd until final unlock.  If more zones are
+//  marked than fit, g_DbaseRRListSequence is made odd instead.
+
+#define DBASE_MAX_RR_LIST_WRITE_ZONES   (8)
+
+PZONE_INFO          DbaseRRListWriteZones[ DBASE_MAX_RR_LIST_WRITE_ZONES ];
+DWORD               DbaseRRListWriteZoneCount;
+
+volatile LONG       g_DbaseRRListSequence = 0;
+
 LPSTR               DbaseLockFile;
 DWORD               DbaseLockLine;
 PDB_NODE            DbaseLockNode;
 PVOID               pDbaseLockHistory;
 
+//
+//  Contention tracking
+//
+//  Lock is taken on every lookup, so before splitting it we want to know
+//  how often threads actually queue behind it and who they queue behind.
+//  All fields are updated while holding the lock, so no interlocked ops.
+//
+//  Waits are timed with the performance counter, since most of them are
+//  far shorter than a GetTickCount() tick.  They are kept in counter
+//  ticks and only converted for display.
+//
+
+DWORD               DbaseLockAcquired;
+DWORD               DbaseLockContended;
+ULONGLONG           DbaseLockWaitTicks;
+ULONGLONG           DbaseLockMaxWaitTicks;
+ULONGLONG           DbaseLockTicksPerSec;
+LPSTR               DbaseLockContendedFile;
+DWORD               DbaseLockContendedLine;
+
 
 
 VOID
@@ -111,6 +158,7 @@ Return Value:
 --*/
 {
     PDB_NODE    pnode = DbaseLockNode;
+    ULONGLONG   ticksPerSec = DbaseLockTicksPerSec ? DbaseLockTicksPerSec : 1;
 
     DnsPrintf(
         "Database locking info:\n"
@@ -118,13 +166,23 @@ Return Value:
         "\tcount    = %d\n"
         "\tfile     = %s\n"
         "\tline     = %d\n"
-        "\tnode     = %p (%s)\n",
+        "\tnode     = %p (%s)\n"
+        "\tacquired = %d\n"
+        "\tcontended= %d\n"
+        "\twait us  = %I64u (max %I64u)\n"
+        "\tlast contended holder = %s, line %d\n",
         DbaseLockThread,
         DbaseLockCount,
         DbaseLockFile,
         DbaseLockLine,
         pnode,
-        ( pnode ? pnode->szLabel : "none" )
+        ( pnode ? pnode->szLabel : "none" ),
+        DbaseLockAcquired,
+        DbaseLockContended,
+        DbaseLockWaitTicks * 1000000 / ticksPerSec,
+        DbaseLockMaxWaitTicks * 1000000 / ticksPerSec,
+        DbaseLockContendedFile,
+        DbaseLockContendedLine
         );
 }
 
@@ -156,11 +214,62 @@ Return Value:
 
 --*/
 {
-    EnterCriticalSection( &DbaseLockCs );
+    LPSTR           pszholderFile;
+    DWORD           holderLine;
+    LARGE_INTEGER   startTime;
+    LARGE_INTEGER   endTime;
+    ULONGLONG       waitTicks;
+
+    //
+    //  try for the lock first so the uncontended path costs no more
+    //  than before;  if we have to wait, note who we waited behind
+    //  (unlocked read, but it's only a hint) and for how long
+    //
+
+    if ( !TryEnterCriticalSection( &DbaseLockCs ) )
+    {
+        pszholderFile = DbaseLockFile;
+        holderLine = DbaseLockLine;
+        QueryPerformanceCounter( &startTime );
+
+        EnterCriticalSection( &DbaseLockCs );
+
+        QueryPerformanceCounter( &endTime );
+        waitTicks = endTime.QuadPart - startTime.QuadPart;
+
+        DbaseLockContended++;
+        DbaseLockWaitTicks += waitTicks;
+        if ( waitTicks > DbaseLockMaxWaitTicks )
+        {
+            DbaseLockMaxWaitTicks = waitTicks;
+        }
+        DbaseLockContendedFile = pszholderFile;
+        DbaseLockContendedLine = holderLine;
+
+        //  PerfMon hook;  set the total rather than add each wait so
+        //  that sub-millisecond waits are not rounded away
+
+        PERF_INC( pcDatabaseLockContention );
+        if ( DbaseLockTicksPerSec )
+        {
+            PERF_SET(
+                pcDatabaseLockWaitTime,
+                (DWORD) ( DbaseLockWaitTicks * 1000 / DbaseLockTicksPerSec ) );
+        }
+
+        DNS_DEBUG( LOCK2, (
+            "Database LOCK contention (thread=%d) waited %I64u ticks behind %s, line %d\n",
+            GetCurrentThreadId(),
+            waitTicks,
+            pszholderFile,
+            holderLine ));
+    }
+
     DbaseLockCount++;
 
     if ( DbaseLockCount == 1 )
     {
+        DbaseLockAcquired++;
         DbaseLockFile = pszFile;
         DbaseLockLine = dwLine;
         DbaseLockNode = pNode;
@@ -229,10 +338,110 @@ Return Value:
 
     DbaseLockCount--;
 
+    //  end of RR list writes on final unlock
+
+    if ( DbaseLockCount == 0 )
+    {
+        while ( DbaseRRListWriteZoneCount )
+        {
+            PZONE_INFO  pzone = DbaseRRListWriteZones[ --DbaseRRListWriteZoneCount ];
+
+            InterlockedIncrement( (PLONG) &pzone->lRRListSequence );
+        }
+        if ( g_DbaseRRListSequence & 1 )
+        {
+            InterlockedIncrement( (PLONG) &g_DbaseRRListSequence );
+        }
+    }
+
     LeaveCriticalSection( &DbaseLockCs );
 }
 
 
+
+VOID
+Dbase_MarkRRListWrite(
+    IN      PDB_NODE        pNode
+    )
+/*++
+
+Routine Description:
+
+    Mark the current database lock hold as changing RR lists in the zone
+    of node.
+
+    Must be called with the database lock held, before the first change.
+    The write ends when the lock is finally released.
+
+Arguments:
+
+    pNode -- node whose RR list is about to change
+
+Return Value:
+
+    None
+
+--*/
+{
+    PZONE_INFO  pzone = (PZONE_INFO) pNode->pZone;
+
+    ASSERT( DbaseLockCount > 0 && DbaseLockThread == GetCurrentThreadId() );
+
+    //  lockless readers only walk authoritative lists
+
+    if ( !pzone || !IS_AUTH_NODE( pNode ) )
+    {
+        return;
+    }
+
+    //  odd zone sequence is only set by the lock holder, so already ours
+
+    if ( pzone->lRRListSequence & 1 )
+    {
+        return;
+    }
+
+    if ( DbaseRRListWriteZoneCount < DBASE_MAX_RR_LIST_WRITE_ZONES )
+    {
+        DbaseRRListWriteZones[ DbaseRRListWriteZoneCount++ ] = pzone;
+        InterlockedIncrement( (PLONG) &pzone->lRRListSequence );
+    }
+    else if ( !( g_DbaseRRListSequence & 1 ) )
+    {
+        InterlockedIncrement( (PLONG) &g_DbaseRRListSequence );
+    }
+}
+
+
+
+BOOL
+Dbase_IsRRListWriteByThread(
+    VOID
+    )
+/*++
+
+Routine Description:
+
+    Check if this thread holds the database lock and has marked an RR list
+    write (MARK_RR_LIST_WRITE).
+
+Arguments:
+
+    None
+
+Return Value:
+
+    TRUE if marked RR list write in progress on this thread.
+    FALSE otherwise.
+
+--*/
+{
+    return  DbaseLockCount > 0 &&
+            DbaseLockThread == GetCurrentThreadId() &&
+            ( DbaseRRListWriteZoneCount || ( g_DbaseRRListSequence & 1 ) );
+}
+
+
 
 BOOL
 Dbase_IsLockedByThread(
@@ -298,6 +507,8 @@ Return Value:
 
 --*/
 {
+    LARGE_INTEGER   frequency;
+
     //
     //  cache zone
     //
@@ -316,6 +527,18 @@ Return Value:
     DbaseLockNode      = NULL;
     pDbaseLockHistory  = NULL;
 
+    DbaseLockAcquired       = 0;
+    DbaseLockContended      = 0;
+    DbaseLockWaitTicks      = 0;
+    DbaseLockMaxWaitTicks   = 0;
+    DbaseLockTicksPerSec    = 0;
+    if ( QueryPerformanceFrequency( &frequency ) )
+    {
+        DbaseLockTicksPerSec = frequency.QuadPart;
+    }
+    DbaseLockContendedFile  = NULL;
+    DbaseLockContendedLine  = 0;
+
     if ( DnsInitializeCriticalSection( &DbaseLockCs ) != ERROR_SUCCESS )
     {
         goto fail;
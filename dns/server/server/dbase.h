@@ -503,6 +503,42 @@ Dbase_UnlockEx(
 #define DUMMY_LOCK_RR_LIST(pNode)       DNS_DEBUG( LOCK, ( "DummyRR_LOCK(%p)\n", pNode ));
 #define DUMMY_UNLOCK_RR_LIST(pNode)     DNS_DEBUG( LOCK, ( "DummyRR_UNLOCK(%p)\n", pNode ));
 
+//
+//  RR list write sequence
+//
+//  Authoritative answers may walk an RR list without the database lock
+//  (see Wire_WriteRecordsAtNodeToMessage).  Code that changes a node's list
+//  must hold the lock and call MARK_RR_LIST_WRITE(pNode) before the first
+//  change.  The node's zone sequence then stays odd until the lock is
+//  released, so lockless readers in that zone that overlap the change see
+//  it and retry under the lock;  readers in other zones carry on.
+//
+//  Non-authoritative nodes are not marked;  lockless readers never walk
+//  those lists.
+//
+//  g_DbaseRRListSequence covers all zones;  it is only used when one lock
+//  hold marks more zones than are tracked.
+//
+
+extern volatile LONG    g_DbaseRRListSequence;
+
+VOID
+Dbase_MarkRRListWrite(
+    IN      PDB_NODE        pNode
+    );
+
+BOOL
+Dbase_IsRRListWriteByThread(
+    VOID
+    );
+
+#define MARK_RR_LIST_WRITE(pNode)       Dbase_MarkRRListWrite(pNode)
+#define IS_RR_LIST_WRITE_BY_THREAD()    Dbase_IsRRListWriteByThread()
+
+#define ZONE_RR_LIST_SEQUENCE(pZone)    ( ((PZONE_INFO)(pZone))->lRRListSequence )
+#define RR_LIST_SEQUENCE()              ( g_DbaseRRListSequence )
+#define IS_RR_LIST_WRITE_ACTIVE(seq)    ( (seq) & 1 )
+
 //
 //  Lock verification
 //
@@ -1920,6 +1920,11 @@ Return Value:
         return ERROR_INVALID_DATA;
     }
 
+    if ( !AnsCache_Initialize() )
+    {
+        return ERROR_NOT_ENOUGH_MEMORY;
+    }
+
     //
     //  Directory partition initialization
     //
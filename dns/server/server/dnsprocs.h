@@ -165,6 +165,41 @@ Answer_ParseAndStripOpt(
     IN OUT  PDNS_MSGINFO    pMsg );
 
 
+//
+//  Answer cache (anscache.c)
+//
+
+BOOL
+AnsCache_Initialize(
+    VOID
+    );
+
+BOOL
+AnsCache_Lookup(
+    IN OUT  PDNS_MSGINFO    pMsg
+    );
+
+VOID
+AnsCache_Insert(
+    IN OUT  PDNS_MSGINFO    pMsg
+    );
+
+VOID
+AnsCache_InvalidateZone(
+    IN OUT  PZONE_INFO      pZone
+    );
+
+VOID
+AnsCache_Flush(
+    VOID
+    );
+
+VOID
+AnsCache_Cleanup(
+    VOID
+    );
+
+
 //
 //  Booting (boot.c)
 //
@@ -1201,6 +1236,11 @@ RR_ListFree(
     IN OUT  PDB_RECORD      pRRList
     );
 
+VOID
+RR_ListSlowFree(
+    IN OUT  PDB_RECORD      pRRList
+    );
+
 BOOL
 RR_ListExtractInfo(
     IN      PDB_RECORD      pNewList,
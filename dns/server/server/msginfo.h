@@ -204,6 +204,12 @@ typedef struct _DNS_MSGINFO
     DWORD           dwQueuingTime;      //  time queued
     DWORD           dwExpireTime;       //  queue timeout
 
+    //  queue index links (packetq.c), Flink NULL when not indexed
+
+    LIST_ENTRY      XidHashEntry;       //  XID hash bucket
+    LIST_ENTRY      TimerEntry;         //  timer wheel slot
+    LIST_ENTRY      QuestionHashEntry;  //  duplicate question bucket
+
     //  Opt RR info
 
     //  116
@@ -388,6 +394,15 @@ typedef struct _DNS_MSGINFO
 
     BOOLEAN         fWins;                  //  WINS lookup
 
+    //
+    //  Answer cache
+    //      - set fNoAnswerCache when answer depends on more than the
+    //      question and zone data (RR set reordered, etc.)
+    //
+
+    BOOLEAN         fNoAnswerCache;
+    DWORD           dwAnswerCacheGeneration;
+
     //
     //  Wildcarding
     //
@@ -63,6 +63,144 @@ extern  PPACKET_QUEUE   pNbstatPrivateQueue;
 //  searching for new matching responses is best done from the rear
 //  of the queue.
 //
+//  Queues created with QUEUE_XID_INDEX or QUEUE_QUESTION_INDEX also
+//  link packets into hash buckets (and XID packets into a timer wheel),
+//  so response matching, duplicate checks and timeout do not walk the
+//  whole queue.  All links are made and broken under the queue lock;
+//  every removal from the queue MUST go through unlinkPacketFromQueue().
+//
+
+#define PQ_XID_HASH( xid ) \
+            ( ( (xid) ^ ((xid) >> 10) ) & (PQ_XID_HASH_SIZE - 1) )
+
+#define PQ_QUESTION_HASH( pMsg ) \
+            ( ( (pMsg)->Head.Xid ^ (pMsg)->RemoteAddr.SockaddrIn6.sin6_port ) \
+                & (PQ_QUESTION_HASH_SIZE - 1) )
+
+#define PQ_TIMER_SLOT( pIndex, dwTime ) \
+            ( &(pIndex)->TimerWheel[ (dwTime) % PQ_TIMER_SLOTS ] )
+
+
+
+VOID
+linkPacketToIndexes(
+    IN OUT  PPACKET_QUEUE       pQueue,
+    IN OUT  PDNS_MSGINFO        pMsg,
+    IN      BOOL                fXidIndex
+    )
+/*++
+
+Routine Description:
+
+    Link newly queued packet into queue's indexes.
+
+    The caller must have the queue locked.
+
+Arguments:
+
+    pQueue -- packet queue
+
+    pMsg -- packet just put on queue
+
+    fXidIndex -- TRUE if packet queued with XID and expire time
+
+Return Value:
+
+    None.
+
+--*/
+{
+    PPACKET_QUEUE_XID_INDEX pindex;
+    DWORD                   slotTime;
+
+    //  links may hold garbage if message was copied from queued message
+
+    pMsg->XidHashEntry.Flink = NULL;
+    pMsg->TimerEntry.Flink = NULL;
+    pMsg->QuestionHashEntry.Flink = NULL;
+
+    if ( pQueue->pQuestionHash )
+    {
+        InsertTailList(
+            &pQueue->pQuestionHash[ PQ_QUESTION_HASH( pMsg ) ],
+            &pMsg->QuestionHashEntry );
+    }
+
+    pindex = pQueue->pXidIndex;
+    if ( !pindex || !fXidIndex )
+    {
+        return;
+    }
+
+    InsertTailList(
+        &pindex->XidHash[ PQ_XID_HASH( pMsg->wQueuingXid ) ],
+        &pMsg->XidHashEntry );
+
+    //
+    //  timer wheel
+    //      - slot by expire time, but never behind the drain cursor, or
+    //      it would not be seen until the wheel came round again
+    //
+
+    slotTime = pMsg->dwExpireTime;
+    if ( slotTime < pindex->dwTimerCursor )
+    {
+        slotTime = pindex->dwTimerCursor;
+    }
+    InsertTailList(
+        PQ_TIMER_SLOT( pindex, slotTime ),
+        &pMsg->TimerEntry );
+    pindex->cTimerCount++;
+}
+
+
+
+VOID
+unlinkPacketFromQueue(
+    IN OUT  PPACKET_QUEUE       pQueue,
+    IN OUT  PDNS_MSGINFO        pMsg
+    )
+/*++
+
+Routine Description:
+
+    Remove packet from queue list and indexes.
+
+    The caller must have the queue locked.  Counters and queued flag
+    are left to the caller.
+
+Arguments:
+
+    pQueue -- packet queue
+
+    pMsg -- packet to remove
+
+Return Value:
+
+    None.
+
+--*/
+{
+    RemoveEntryList( &pMsg->ListEntry );
+
+    if ( pMsg->XidHashEntry.Flink )
+    {
+        RemoveEntryList( &pMsg->XidHashEntry );
+        pMsg->XidHashEntry.Flink = NULL;
+    }
+    if ( pMsg->TimerEntry.Flink )
+    {
+        ASSERT( pQueue->pXidIndex && pQueue->pXidIndex->cTimerCount );
+        RemoveEntryList( &pMsg->TimerEntry );
+        pMsg->TimerEntry.Flink = NULL;
+        pQueue->pXidIndex->cTimerCount--;
+    }
+    if ( pMsg->QuestionHashEntry.Flink )
+    {
+        RemoveEntryList( &pMsg->QuestionHashEntry );
+        pMsg->QuestionHashEntry.Flink = NULL;
+    }
+}
 
 
 
@@ -125,6 +263,60 @@ Return Value:
         LOCK_QUEUE( pQueue );
     }
 
+    //
+    //  with question index, only packets with same XID and port
+    //  can be duplicates, check just that bucket
+    //
+
+    if ( pQueue->pQuestionHash )
+    {
+        PLIST_ENTRY     pbucket;
+        PLIST_ENTRY     pentry;
+
+        pbucket = &pQueue->pQuestionHash[ PQ_QUESTION_HASH( pMsgNew ) ];
+        pmsg = NULL;
+
+        for ( pentry = pbucket->Flink;
+              pentry != pbucket;
+              pentry = pentry->Flink )
+        {
+            pmsg = CONTAINING_RECORD( pentry, DNS_MSGINFO, QuestionHashEntry );
+
+            if ( DnsAddr_IsEqual(
+                    &pmsg->RemoteAddr,
+                    &pMsgNew->RemoteAddr,
+                    DNSADDR_MATCH_SOCKADDR ) &&
+                 RtlEqualMemory(
+                    &pmsg->Head,
+                    &pMsgNew->Head,
+                    pmsg->MessageLength ) )
+            {
+                break;
+            }
+            pmsg = NULL;
+        }
+
+        if ( pmsg )
+        {
+            pQueue->cDequeued++;
+            pQueue->cLength--;
+
+            DNS_DEBUG( UPDATE, (
+                "Discarding duplicate of new packet in queue %s\n"
+                "    remote IP    = %s:%d\n"
+                "    XID          = %d\n",
+                pQueue->pszName,
+                DNSADDR_STRING( &pmsg->RemoteAddr ),
+                pmsg->RemoteAddr.SockaddrIn6.sin6_port,
+                pmsg->Head.Xid ));
+
+            unlinkPacketFromQueue( pQueue, pmsg );
+            SET_MSG_DEQUEUED( pmsg );
+            Packet_Free( pmsg );
+        }
+        goto Unlock;
+    }
+
     pmsg = (PDNS_MSGINFO) pQueue->listHead.Flink;
 
     while ( (PLIST_ENTRY)pmsg != &pQueue->listHead )
@@ -150,7 +342,7 @@ Return Value:
                 pmsg->RemoteAddr.SockaddrIn6.sin6_port,
                 pmsg->Head.Xid ));
 
-            RemoveEntryList( (PLIST_ENTRY)pmsg );
+            unlinkPacketFromQueue( pQueue, pmsg );
             SET_MSG_DEQUEUED( pmsg );
             Packet_Free( pmsg );
             break;
@@ -159,6 +351,8 @@ Return Value:
         continue;
     }
 
+    Unlock:
+
     if ( !fAlreadyLocked )
     {
         UNLOCK_QUEUE( pQueue );
@@ -246,7 +440,7 @@ Return Value:
             pQueue->cLength--;
 
             pmsgNext = (PDNS_MSGINFO) ((PLIST_ENTRY)pmsg)->Flink;
-            RemoveEntryList( (PLIST_ENTRY)pmsg );
+            unlinkPacketFromQueue( pQueue, pmsg );
             SET_MSG_DEQUEUED( pmsg );
             Packet_Free( pmsg );
             pmsg = pmsgNext;
@@ -270,7 +464,8 @@ Return Value:
 BOOL
 addPacketToQueue(
     IN OUT  PPACKET_QUEUE       pQueue,
-    IN OUT  PDNS_MSGINFO        pMsg
+    IN OUT  PDNS_MSGINFO        pMsg,
+    IN      BOOL                fXidIndex
     )
 /*++
 
@@ -284,6 +479,8 @@ Arguments:
 
     pMsg -- packet to enqueue
 
+    fXidIndex -- TRUE to index packet by queuing XID and expire time
+
 Return Value:
 
     TRUE if queued, FALSE on error.
@@ -307,6 +504,7 @@ Return Value:
     }
     
     InsertTailList( &pQueue->listHead, ( PLIST_ENTRY ) pMsg );
+    linkPacketToIndexes( pQueue, pMsg, fXidIndex );
 
     pQueue->cQueued++;
     pQueue->cLength++;
@@ -343,7 +541,7 @@ Return Value:
     
     LOCK_QUEUE( pQueue );
 
-    bqueued = addPacketToQueue( pQueue, pMsg );
+    bqueued = addPacketToQueue( pQueue, pMsg, FALSE );
 
     if ( bqueued )
     {
@@ -385,7 +583,7 @@ Return Value:
 
     LOCK_QUEUE( pQueue );
 
-    bqueued = addPacketToQueue( pQueue, pMsg );
+    bqueued = addPacketToQueue( pQueue, pMsg, FALSE );
 
     MSG_ASSERT( pMsg, !IS_MSG_QUEUED( pMsg ) );
     SET_MSG_QUEUED( pMsg );
@@ -517,6 +715,7 @@ Return Value:
         {
             InsertTailList( &pQueue->listHead, (PLIST_ENTRY)pMsg );
         }
+        linkPacketToIndexes( pQueue, pMsg, FALSE );
 
         pQueue->cQueued++;
         pQueue->cLength++;
@@ -595,7 +794,7 @@ Return Value:
         pQueue->cDequeued++;
         pQueue->cLength--;
 
-        RemoveEntryList( (PLIST_ENTRY)pmsg );
+        unlinkPacketFromQueue( pQueue, pmsg );
         MSG_ASSERT( pmsg, IS_MSG_QUEUED(pmsg) );
         SET_MSG_DEQUEUED(pmsg);
     }
@@ -639,7 +838,7 @@ Return Value:
 {
     LOCK_QUEUE( pQueue );
 
-    RemoveEntryList( &pMsg->ListEntry );
+    unlinkPacketFromQueue( pQueue, pMsg );
 
     //  treat as if packet never on queue
 
@@ -856,7 +1055,7 @@ Return Value:
     //  from tail so it will checking most recent packets first.
     //
 
-    bqueued = addPacketToQueue( pQueue, pMsg );
+    bqueued = addPacketToQueue( pQueue, pMsg, TRUE );
 
     UNLOCK_QUEUE( pQueue );
 
@@ -981,6 +1180,43 @@ Return Value:
 {
     PDNS_MSGINFO    pmsg;
 
+    LOCK_QUEUE( pQueue );
+
+    //
+    //  XID index -- check just the XID's bucket
+    //      - XID is unique among queued packets, but still walk from
+    //      back to match the most recent as the list walk does
+    //
+
+    if ( pQueue->pXidIndex )
+    {
+        PLIST_ENTRY     pbucket;
+        PLIST_ENTRY     pentry;
+
+        pbucket = &pQueue->pXidIndex->XidHash[ PQ_XID_HASH( wMatchXid ) ];
+
+        for ( pentry = pbucket->Blink;
+              pentry != pbucket;
+              pentry = pentry->Blink )
+        {
+            pmsg = CONTAINING_RECORD( pentry, DNS_MSGINFO, XidHashEntry );
+
+            if ( pmsg->wQueuingXid == wMatchXid )
+            {
+                goto Found;
+            }
+        }
+
+        //  packets queued without XID are not indexed, fall through
+        //  to list walk only if there might be some
+
+        if ( pQueue->pXidIndex->cTimerCount == pQueue->cLength )
+        {
+            UNLOCK_QUEUE( pQueue );
+            return NULL;
+        }
+    }
+
     //
     //  walk backwards through queue looking for packet
     //
@@ -988,8 +1224,6 @@ Return Value:
     //  and avoid build up of timed out packets
     //
 
-    LOCK_QUEUE( pQueue );
-
     pmsg = (PDNS_MSGINFO) pQueue->listHead.Blink;
 
     while ( (PLIST_ENTRY)pmsg != &pQueue->listHead )
@@ -1000,15 +1234,7 @@ Return Value:
 
         if ( pmsg->wQueuingXid == wMatchXid )
         {
-            pQueue->cDequeued++;
-            pQueue->cLength--;
-
-            RemoveEntryList( (PLIST_ENTRY)pmsg );
-            UNLOCK_QUEUE( pQueue );
-
-            MSG_ASSERT( pmsg, IS_MSG_QUEUED(pmsg) );
-            SET_MSG_DEQUEUED(pmsg);
-            return pmsg;
+            goto Found;
         }
 
         //  get next packet
@@ -1018,6 +1244,18 @@ Return Value:
 
     UNLOCK_QUEUE( pQueue );
     return NULL;
+
+Found:
+
+    pQueue->cDequeued++;
+    pQueue->cLength--;
+
+    unlinkPacketFromQueue( pQueue, pmsg );
+    UNLOCK_QUEUE( pQueue );
+
+    MSG_ASSERT( pmsg, IS_MSG_QUEUED(pmsg) );
+    SET_MSG_DEQUEUED(pmsg);
+    return pmsg;
 }
 
 
@@ -1075,6 +1313,41 @@ Return Value:
         LOCK_QUEUE( pQueue );
     }
 
+    //
+    //  question index -- matches must share XID and port, so only
+    //  that bucket need be checked
+    //
+
+    if ( pQueue->pQuestionHash )
+    {
+        PLIST_ENTRY     pbucket;
+        PLIST_ENTRY     pentry;
+
+        pbucket = &pQueue->pQuestionHash[ PQ_QUESTION_HASH( pMsg ) ];
+
+        for ( pentry = pbucket->Flink;
+              pentry != pbucket;
+              pentry = pentry->Flink )
+        {
+            pmsg = CONTAINING_RECORD( pentry, DNS_MSGINFO, QuestionHashEntry );
+
+            if ( pmsg->Head.Xid == pMsg->Head.Xid &&
+                 DnsAddr_IsEqual(
+                    &pmsg->RemoteAddr,
+                    &pMsg->RemoteAddr,
+                    DNSADDR_MATCH_SOCKADDR ) &&
+                 pmsg->wQuestionType == pMsg->wQuestionType &&
+                 Name_CompareLookupNames(
+                    pmsg->pLooknameQuestion,
+                    pMsg->pLooknameQuestion ) )
+            {
+                isQueued = TRUE;
+                break;
+            }
+        }
+        goto Unlock;
+    }
+
     for ( pmsg = ( PDNS_MSGINFO ) pQueue->listHead.Flink;
           ( PLIST_ENTRY ) pmsg != &pQueue->listHead;
           pmsg = ( PDNS_MSGINFO ) ( ( PLIST_ENTRY ) pmsg )->Flink )
@@ -1102,6 +1375,8 @@ Return Value:
         }
     }
 
+    Unlock:
+
     if ( !fAlreadyLocked )
     {
         UNLOCK_QUEUE( pQueue );
@@ -1114,6 +1389,125 @@ Return Value:
 
 
 
+PDNS_MSGINFO
+dequeueTimedOutPacketFromWheel(
+    IN OUT  PPACKET_QUEUE   pQueue,
+    IN      DWORD           dwTime,
+    IN OUT  PDWORD          pdwSmallestTimeout
+    )
+/*++
+
+Routine Description:
+
+    Dequeue next timed out packet using queue's timer wheel.
+
+    The caller must have the queue locked.
+
+    Slots behind the current time are drained in order;  the cursor
+    records the first slot that may still hold a timed out packet, so
+    repeated calls do not rescan.  Slots are shared by times a wheel
+    turn apart, hence expire time is checked on each packet.
+
+Arguments:
+
+    pQueue -- packet queue with XID index
+
+    dwTime -- current time
+
+    pdwSmallestTimeout -- on entry default interval to next timeout;
+        reset to smaller interval if found, or zero if packet returned
+
+Return Value:
+
+    Ptr to timed out packet, if any.
+    NULL if no timed out packets on queue.
+
+--*/
+{
+    PPACKET_QUEUE_XID_INDEX pindex = pQueue->pXidIndex;
+    PDNS_MSGINFO            pmsg;
+    PLIST_ENTRY             pslot;
+    PLIST_ENTRY             pentry;
+    DWORD                   cursor;
+    DWORD                   lastTime;
+
+    //
+    //  cursor lagging more than a wheel turn (or time went back)
+    //      - every slot will be visited in the last turn anyway
+    //
+
+    cursor = pindex->dwTimerCursor;
+
+    if ( cursor > dwTime || dwTime - cursor > PQ_TIMER_SLOTS )
+    {
+        cursor = ( dwTime > PQ_TIMER_SLOTS ) ? dwTime - PQ_TIMER_SLOTS : 0;
+    }
+
+    //
+    //  drain slots for times already past
+    //      - same "<" test as list walk, see bug 23177 note below
+    //
+
+    for ( ; cursor < dwTime; cursor++ )
+    {
+        pslot = PQ_TIMER_SLOT( pindex, cursor );
+
+        for ( pentry = pslot->Flink;
+              pentry != pslot;
+              pentry = pentry->Flink )
+        {
+            pmsg = CONTAINING_RECORD( pentry, DNS_MSGINFO, TimerEntry );
+
+            if ( pmsg->dwExpireTime < dwTime )
+            {
+                pindex->dwTimerCursor = cursor;
+
+                pQueue->cDequeued++;
+                pQueue->cTimedOut++;
+                pQueue->cLength--;
+                unlinkPacketFromQueue( pQueue, pmsg );
+                *pdwSmallestTimeout = 0;
+
+                MSG_ASSERT( pmsg, IS_MSG_QUEUED(pmsg) );
+                SET_MSG_DEQUEUED(pmsg);
+                return pmsg;
+            }
+        }
+    }
+    pindex->dwTimerCursor = cursor;
+
+    //
+    //  no timed out packet -- find next expire within minimum timeout
+    //
+
+    lastTime = dwTime + pQueue->dwMinimumTimeout;
+
+    for ( ; cursor <= lastTime; cursor++ )
+    {
+        pslot = PQ_TIMER_SLOT( pindex, cursor );
+
+        for ( pentry = pslot->Flink;
+              pentry != pslot;
+              pentry = pentry->Flink )
+        {
+            pmsg = CONTAINING_RECORD( pentry, DNS_MSGINFO, TimerEntry );
+
+            if ( pmsg->dwExpireTime >= dwTime &&
+                 pmsg->dwExpireTime - dwTime < *pdwSmallestTimeout )
+            {
+                *pdwSmallestTimeout = pmsg->dwExpireTime - dwTime;
+            }
+        }
+        if ( *pdwSmallestTimeout <= cursor - dwTime )
+        {
+            break;
+        }
+    }
+    return NULL;
+}
+
+
+
 PDNS_MSGINFO
 PQ_DequeueTimedOutPacket(
     IN OUT  PPACKET_QUEUE   pQueue,
@@ -1187,6 +1581,20 @@ Return Value:
 
     LOCK_QUEUE( pQueue );
 
+    //
+    //  timer wheel -- if every queued packet is on it
+    //
+
+    if ( pQueue->pXidIndex &&
+         pQueue->pXidIndex->cTimerCount == pQueue->cLength )
+    {
+        pmsg = dequeueTimedOutPacketFromWheel(
+                    pQueue,
+                    dwTime,
+                    &dwSmallestTimeout );
+        goto Unlock;
+    }
+
     pmsg = (PDNS_MSGINFO) pQueue->listHead.Flink;
 
     while ( 1 )
@@ -1220,7 +1628,7 @@ Return Value:
             pQueue->cDequeued++;
             pQueue->cTimedOut++;
             pQueue->cLength--;
-            RemoveEntryList( (PLIST_ENTRY)pmsg );
+            unlinkPacketFromQueue( pQueue, pmsg );
             dwSmallestTimeout = 0;
 
             MSG_ASSERT( pmsg, IS_MSG_QUEUED(pmsg) );
@@ -1251,6 +1659,8 @@ Return Value:
         pmsg = (PDNS_MSGINFO) ((PLIST_ENTRY)pmsg)->Flink;
     }
 
+    Unlock:
+
     UNLOCK_QUEUE( pQueue );
 
     *pdwTimeout = dwSmallestTimeout;
@@ -1332,7 +1742,7 @@ Return Value:
         pQueue->cDequeued++;
         pQueue->cLength--;
 
-        RemoveEntryList( (PLIST_ENTRY)pmsg );
+        unlinkPacketFromQueue( pQueue, pmsg );
         UNLOCK_QUEUE( pQueue );
 
         MSG_ASSERT( pmsg, IS_MSG_QUEUED(pmsg) );
@@ -1373,6 +1783,8 @@ Arguments:
             QUEUE_DISCARD_EXPIRED
             QUEUE_DISCARD_DUPLICATES
             QUEUE_QUERY_TIME_ORDER
+            QUEUE_XID_INDEX
+            QUEUE_QUESTION_INDEX
 
     dwDefaultTimeout -- default timeout on queue
 
@@ -1445,6 +1857,47 @@ Return Value:
         pqueue->fQueryTimeOrder = TRUE;
     }
 
+    //
+    //  indexes
+    //
+
+    if ( dwFlags & QUEUE_XID_INDEX )
+    {
+        PPACKET_QUEUE_XID_INDEX pindex;
+        DWORD                   i;
+
+        pindex = ALLOC_TAGHEAP_ZERO( sizeof( PACKET_QUEUE_XID_INDEX ), MEMTAG_SAFE );
+        IF_NOMEM( !pindex )
+        {
+            goto Failed;
+        }
+        for ( i = 0; i < PQ_XID_HASH_SIZE; i++ )
+        {
+            InitializeListHead( &pindex->XidHash[ i ] );
+        }
+        for ( i = 0; i < PQ_TIMER_SLOTS; i++ )
+        {
+            InitializeListHead( &pindex->TimerWheel[ i ] );
+        }
+        pqueue->pXidIndex = pindex;
+    }
+    if ( dwFlags & QUEUE_QUESTION_INDEX )
+    {
+        PLIST_ENTRY     phash;
+        DWORD           i;
+
+        phash = ALLOC_TAGHEAP( PQ_QUESTION_HASH_SIZE * sizeof( LIST_ENTRY ), MEMTAG_SAFE );
+        IF_NOMEM( !phash )
+        {
+            goto Failed;
+        }
+        for ( i = 0; i < PQ_QUESTION_HASH_SIZE; i++ )
+        {
+            InitializeListHead( &phash[ i ] );
+        }
+        pqueue->pQuestionHash = phash;
+    }
+
     //
     //  fill in callers info
     //
@@ -1478,6 +1931,24 @@ Return Value:
             dwMaximumElements : QUEUE_DEFAULT_MAX_ELEMENTS;
 
     return pqueue;
+
+Failed:
+
+    DNS_PRINT((
+        "ERROR:  could not allocate index for packet queue %s\n",
+        pszQueueName ));
+
+    if ( pqueue->pXidIndex )
+    {
+        FREE_HEAP( pqueue->pXidIndex );
+    }
+    if ( pqueue->hEvent )
+    {
+        CloseHandle( pqueue->hEvent );
+    }
+    DeleteCriticalSection( &pqueue->csQueue );
+    FREE_HEAP( pqueue );
+    return NULL;
 }
 
 
@@ -1654,6 +2125,14 @@ Return Value:
     //  delete queue structure itself
     //
 
+    if ( pQueue->pXidIndex )
+    {
+        FREE_HEAP( pQueue->pXidIndex );
+    }
+    if ( pQueue->pQuestionHash )
+    {
+        FREE_HEAP( pQueue->pQuestionHash );
+    }
     FREE_HEAP( pQueue );
 }
 
@@ -28,6 +28,34 @@ Revision History:
 #define _DNS_PACKETQ_INCLUDED_
 
 
+//
+//  Packet queue indexes
+//
+//  XID index -- packets queued with XID (PQ_QueuePacketWithXid)
+//      - hash by queuing XID for response matching
+//      - timer wheel by expire time, one slot per second;  slots
+//      must exceed the longest packet timeout (five minutes)
+//
+//  Question index -- all packets, hashed by client XID and port
+//      for duplicate suppression
+//
+//  Both are protected by queue lock.
+//
+
+#define PQ_XID_HASH_SIZE        (1024)      //  power of two
+#define PQ_QUESTION_HASH_SIZE   (1024)      //  power of two
+#define PQ_TIMER_SLOTS          (512)
+
+typedef struct _packet_queue_xid_index
+{
+    LIST_ENTRY          XidHash[ PQ_XID_HASH_SIZE ];
+    LIST_ENTRY          TimerWheel[ PQ_TIMER_SLOTS ];
+    DWORD               dwTimerCursor;  //  first second not yet drained
+    DWORD               cTimerCount;    //  packets on wheel
+}
+PACKET_QUEUE_XID_INDEX, *PPACKET_QUEUE_XID_INDEX;
+
+
 //
 //  Packet queue structure
 //
@@ -39,6 +67,11 @@ typedef struct _packet_queue
     LPSTR               pszName;        //  queue name
     HANDLE              hEvent;         //  event for queue
 
+    //  indexes, NULL if queue not created with index flag
+
+    PPACKET_QUEUE_XID_INDEX pXidIndex;
+    PLIST_ENTRY             pQuestionHash;
+
     //  flags
 
     BOOL        fQueryTimeOrder;
@@ -75,6 +108,8 @@ PACKET_QUEUE, *PPACKET_QUEUE;
 #define QUEUE_DISCARD_EXPIRED       (0x00000002)
 #define QUEUE_DISCARD_DUPLICATES    (0x00000004)
 #define QUEUE_QUERY_TIME_ORDER      (0x00000008)
+#define QUEUE_XID_INDEX             (0x00000010)
+#define QUEUE_QUESTION_INDEX        (0x00000020)
 
 #define QUEUE_DEFAULT_MAX_ELEMENTS  5000
 
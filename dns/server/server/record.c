@@ -160,9 +160,13 @@ UCHAR  RecordTypePropertyTable[][5] =
 
 
 //
-//  Slow free for NS and SOA
+//  Slow free for NS and SOA, and for zone records freed during an RR list
+//  write (MARK_RR_LIST_WRITE)
 //      - NS just added protection on recurse, delegation walking
 //      - SOA as PTR is outstanding
+//      - zone records cut from a live list may still be read by lockless
+//          authoritative answers (see dbase.c);  zone reload and delete
+//          free whole trees without marking, so they don't come here
 //
 //  Note:  if change this to allow substantial SLOW frees, them MUST
 //          change timeout thread to run cleanup more frequently
@@ -174,7 +178,9 @@ UCHAR  RecordTypePropertyTable[][5] =
 //
 
 #define DO_SLOW_FREE_ON_RR(pRR)     ((pRR)->wType == DNS_TYPE_NS || \
-                                     (pRR)->wType == DNS_TYPE_SOA)
+                                     (pRR)->wType == DNS_TYPE_SOA || \
+                                     (IS_ZONE_RR(pRR) && \
+                                        IS_RR_LIST_WRITE_BY_THREAD()))
 
 
 
@@ -521,6 +521,7 @@ Return Value:
     }
 
     pQuery->fQuestionRecursed = TRUE;
+    pQuery->fNoAnswerCache = TRUE;
     STAT_INC( RecurseStats.TotalQuestionsRecursed );
 
     return TRUE;
@@ -1638,7 +1639,8 @@ Return Value:
 
     g_pRecursionQueue = PQ_CreatePacketQueue(
                             "Recursion",
-                            0,                              //  flags
+                            QUEUE_XID_INDEX |
+                                QUEUE_QUESTION_INDEX,
                             SrvCfg_dwRecursionRetry,        //  timeout
                             RECURSION_QUEUE_MAX_LENGTH );
     if ( !g_pRecursionQueue )
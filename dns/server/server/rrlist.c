@@ -765,6 +765,7 @@ Return Value:
     //
 
     LOCK_WRITE_RR_LIST( pNode );
+    MARK_RR_LIST_WRITE( pNode );
 
     if ( pNode->pRRList )
     {
@@ -936,6 +937,7 @@ Return Value:
     //
 
     LOCK_WRITE_RR_LIST( pNode );
+    MARK_RR_LIST_WRITE( pNode );
 
     if ( pNode->pRRList )
     {
@@ -1055,6 +1057,7 @@ Return Value:
         fForceRemove ));
 
     LOCK_WRITE_RR_LIST( pNode );
+    MARK_RR_LIST_WRITE( pNode );
 
     RR_ListVerify( pNode );
 
@@ -1208,6 +1211,7 @@ Return Value:
         dwQueryTime ));
 
     LOCK_WRITE_RR_LIST( pNode );
+    MARK_RR_LIST_WRITE( pNode );
 
     IF_DEBUG( READ )
     {
@@ -1480,6 +1484,7 @@ Return Value:
         pNode->cReferenceCount ));
 
     LOCK_WRITE_RR_LIST( pNode );
+    MARK_RR_LIST_WRITE( pNode );
 
     //
     //  Check cached NAME_ERROR node.
@@ -1620,6 +1625,7 @@ Return Value:
         pRR ));
 
     LOCK_WRITE_RR_LIST( pNode );
+    MARK_RR_LIST_WRITE( pNode );
     RR_ListVerify( pNode );
 
     if ( IS_NOEXIST_NODE( pNode ) )
@@ -1718,6 +1724,7 @@ Return Value:
         pNode->cReferenceCount ));
 
     LOCK_WRITE_RR_LIST( pNode );
+    MARK_RR_LIST_WRITE( pNode );
 
     RR_ListVerify( pNode );
 
@@ -1835,6 +1842,7 @@ Return Value:
         pNode->cReferenceCount ));
 
     LOCK_WRITE_RR_LIST( pNode );
+    MARK_RR_LIST_WRITE( pNode );
 
     RR_ListVerify( pNode );
 
@@ -2431,6 +2439,7 @@ Return Value:
         pRR ));
 
     LOCK_WRITE_RR_LIST( pNode );
+    MARK_RR_LIST_WRITE( pNode );
 
     RR_ListVerify( pNode );
 
@@ -2600,6 +2609,7 @@ Return Value:
     }
 
     LOCK_WRITE_RR_LIST( pNode );
+    MARK_RR_LIST_WRITE( pNode );
 
     RR_ListVerify( pNode );
 
@@ -2762,6 +2772,7 @@ Return Value:
     ASSERT( !IS_COMPOUND_TYPE_EXCEPT_ANY(wDeleteType) );
 
     LOCK_WRITE_RR_LIST( pNode );
+    MARK_RR_LIST_WRITE( pNode );
 
     RR_ListVerify( pNode );
 
@@ -3027,6 +3038,7 @@ Return Value:
     //
 
     LOCK_WRITE_RR_LIST( pNode );
+    MARK_RR_LIST_WRITE( pNode );
     RR_ListVerify( pNode );
 
     //  for zone update, clear cached data
@@ -3220,6 +3232,7 @@ Return Value:
     type = pRR->wType;
 
     LOCK_WRITE_RR_LIST( pNode );
+    MARK_RR_LIST_WRITE( pNode );
 
     RR_ListVerify( pNode );
 
@@ -3557,6 +3570,7 @@ Return Value:
         pRR ));
 
     LOCK_WRITE_RR_LIST( pNode );
+    MARK_RR_LIST_WRITE( pNode );
 
     RR_ListVerify( pNode );
 
@@ -4114,6 +4128,7 @@ Return Value:
         Flag ));
 
     LOCK_WRITE_RR_LIST( pNode );
+    MARK_RR_LIST_WRITE( pNode );
 
     RR_ListVerify( pNode );
 
@@ -4836,6 +4851,7 @@ Return Value:
     {
         if ( IS_CACHE_RR(prr) )
         {
+            MARK_RR_LIST_WRITE( pNode );
             pback->pRRNext = prr->pRRNext;
             RR_Free( prr );
             prr = pback;
@@ -5226,6 +5242,7 @@ Return Value:
     }
 
     LOCK_WRITE_RR_LIST( pNode );
+    MARK_RR_LIST_WRITE( pNode );
     RR_ListVerify( pNode );
 
     //
@@ -6151,6 +6168,47 @@ Return Value:
     return count;
 }
 
+
+
+VOID
+rrListFreeForTimeout(
+    IN OUT  PVOID           pRRList
+    )
+{
+    RR_ListFree( (PDB_RECORD) pRRList );
+}
+
+
+
+VOID
+RR_ListSlowFree(
+    IN OUT  PDB_RECORD      pRRList
+    )
+/*++
+
+Routine Description:
+
+    Free records in RR list after the timeout free delay.
+
+    For lists lockless answers may still be walking (see dbase.c).  The
+    whole list is queued as one delayed free, rather than one per record.
+
+Arguments:
+
+    pRRList -- ptr to first record in list to free
+
+Return Value:
+
+    None
+
+--*/
+{
+    if ( pRRList )
+    {
+        Timeout_FreeWithFunction( pRRList, rrListFreeForTimeout );
+    }
+}
+
 //
 //  End rrlist.c
 //
@@ -1342,6 +1342,180 @@ Truncate:
 }
 
 
+
+//
+//  Lockless authoritative answers
+//
+//  Bounds on the list walk and on the records collected, so a reader
+//  overlapping a list change can't run away before it notices.
+//
+
+#define LOCKLESS_MAX_RR_WALK        (256)
+#define LOCKLESS_MAX_RR_WRITE       (32)
+
+
+
+BOOL
+writeAuthRecordsWithoutLock(
+    IN OUT  PDNS_MSGINFO    pMsg,
+    IN      PDB_NODE        pNode,
+    IN      WORD            wType,
+    IN      WORD            wNameOffset,    OPTIONAL
+    IN      DWORD           flags,
+    OUT     PWORD           pCountRR
+    )
+/*++
+
+Routine Description:
+
+    Write matching authoritative RRs at node without the database lock.
+
+    Only handles simple queries at authoritative nodes whose RR set is
+    not round robined;  see dbase.c for why the list can be walked.
+    The matching records are collected first and the zone's RR list write
+    sequence is checked before writing, so the answer is a consistent
+    snapshot of the list.
+
+Arguments:
+
+    pMsg - message to write to
+
+    pNode - node being looked up
+
+    wType - type being looked up
+
+    wNameOffset - offset to previous name in packet, to write as compressed
+                    RR name, instead of writing node name
+
+    flags - control specifics of records written
+
+    pCountRR - receives count of resource records written
+
+Return Value:
+
+    TRUE if answer written.
+    FALSE if caller must write the answer under the lock.
+
+--*/
+{
+    PDB_RECORD  rgprr[ LOCKLESS_MAX_RR_WRITE ];
+    PDB_RECORD  prr;
+    PDB_NODE    pnodeUseName;
+    WORD        startOffset = 0;
+    WORD        countRR = 0;
+    DWORD       countFound = 0;
+    DWORD       countWalked = 0;
+    DWORD       i;
+    PZONE_INFO  pzone = (PZONE_INFO) pNode->pZone;
+    LONG        sequence;
+    LONG        sequenceAll;
+
+    //
+    //  only simple authoritative answers
+    //      - round robin relinks the list it answers from
+    //      - DNSSEC pulls in SIG and KEY records of other types
+    //
+
+    if ( !pzone ||
+         !IS_AUTH_NODE( pNode ) ||
+         IS_NOEXIST_NODE( pNode ) ||
+         IS_COMPOUND_TYPE( wType ) ||
+         ( SrvCfg_fRoundRobin && IS_ROUND_ROBIN_TYPE( wType ) ) ||
+         DNSMSG_INCLUDE_DNSSEC_IN_RESPONSE( pMsg ) )
+    {
+        return FALSE;
+    }
+
+    sequence = ZONE_RR_LIST_SEQUENCE( pzone );
+    sequenceAll = RR_LIST_SEQUENCE();
+    if ( IS_RR_LIST_WRITE_ACTIVE( sequence ) ||
+         IS_RR_LIST_WRITE_ACTIVE( sequenceAll ) )
+    {
+        return FALSE;
+    }
+
+    //
+    //  collect matching records
+    //      - bail on any non-zone record;  only zone records are slow
+    //          freed, so never follow a link out of anything else
+    //
+
+    prr = START_RR_TRAVERSE( pNode );
+
+    while ( prr = NEXT_RR( prr ) )
+    {
+        if ( !IS_ZONE_RR( prr ) || ++countWalked > LOCKLESS_MAX_RR_WALK )
+        {
+            return FALSE;
+        }
+        if ( prr->wType < wType )
+        {
+            continue;
+        }
+        if ( prr->wType > wType )
+        {
+            break;
+        }
+        if ( IS_EMPTY_AUTH_RR( prr ) || countFound == LOCKLESS_MAX_RR_WRITE )
+        {
+            return FALSE;
+        }
+        rgprr[ countFound++ ] = prr;
+    }
+
+    //  zone's lists changed under us -- answer under the lock
+
+    if ( ZONE_RR_LIST_SEQUENCE( pzone ) != sequence ||
+         RR_LIST_SEQUENCE() != sequenceAll )
+    {
+        return FALSE;
+    }
+
+    //
+    //  write records
+    //      - same owner name handling as locked write
+    //      - zone records don't time out, so only failure is truncation
+    //
+
+    if ( wNameOffset )
+    {
+        pnodeUseName = NULL;
+    }
+    else
+    {
+        pnodeUseName = pNode;
+        startOffset = DNSMSG_OFFSET( pMsg, pMsg->pCurrent );
+    }
+
+    for ( i = 0; i < countFound; i++ )
+    {
+        if ( !Wire_AddResourceRecordToMessage(
+                    pMsg,
+                    pnodeUseName,
+                    wNameOffset,
+                    rgprr[ i ],
+                    flags & 0xF ) )
+        {
+            break;
+        }
+
+        countRR++;
+        if ( ! wNameOffset )
+        {
+            pnodeUseName = NULL;
+            wNameOffset = startOffset;
+        }
+    }
+
+    pMsg->fWins = FALSE;
+    CURRENT_RR_SECTION_COUNT( pMsg ) += countRR;
+
+    *pCountRR = countRR;
+    return TRUE;
+}
+
+
+
 
 WORD
 Wire_WriteRecordsAtNodeToMessage(
@@ -1408,6 +1582,21 @@ Return Value:
         wNameOffset = 0;
     }
 
+    //
+    //  authoritative answer without the lock, when possible
+    //
+
+    if ( writeAuthRecordsWithoutLock(
+                pMsg,
+                pNode,
+                wType,
+                wNameOffset,
+                flags,
+                &countRR ) )
+    {
+        return countRR;
+    }
+
     //
     //  cached name error node
     //
@@ -1793,6 +1982,10 @@ Return Value:
         prrBeforeMatch->pRRNext = prrFirstMatch->pRRNext;
         prrFirstMatch->pRRNext = prrLastMatch->pRRNext;
         prrLastMatch->pRRNext = prrFirstMatch;
+
+        //  next query gets different order, don't save this answer
+
+        pMsg->fNoAnswerCache = TRUE;
     }
 
     //
@@ -2409,6 +2602,14 @@ Done:
         pMsg->fWins = FALSE;
         pMsg->pCurrent = (PCHAR) pCAR;
 
+        //  order depends on client address or rotates -- don't save answer
+
+        if ( countWritten > 1 &&
+             ( SrvCfg_fLocalNetPriority || SrvCfg_fRoundRobin ) )
+        {
+            pMsg->fNoAnswerCache = TRUE;
+        }
+
         //
         //  more than one A -- round robin
         //
@@ -1554,6 +1554,7 @@ Return Value:
 
     if ( pMsg->Head.AnswerCount != 0 || pMsg->Head.NameServerCount != 0 )
     {
+        AnsCache_Insert( pMsg );
         Send_Msg( pMsg, 0 );
         return;
     }
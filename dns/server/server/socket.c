@@ -81,6 +81,13 @@ INT     g_UdpBoundSocketCount;
 
 #define UDP_MAX_RECV_BUFFER_SIZE    (0x10000)  // 64k max buffer
 
+//
+//  Receives posted per UDP listen socket
+//
+
+#define UDP_MIN_RECV_DEPTH          (2)
+#define UDP_MAX_RECV_DEPTH          (64)
+
 DWORD   g_UdpRecvBufferSize;
 
 //
@@ -384,13 +391,29 @@ Return Value:
     g_TcpListenSocketV6 = 0;
     g_UdpListenSocketV6 = 0;
 
-    if ( g_ProcessorCount == 1 )
+    //
+    //  receives posted on each UDP socket
+    //
+    //  with several receives down, a burst completes straight to the
+    //  completion port and recv threads pick up packets without waiting
+    //  for a re-post;  default two per recv thread, admin may override
+    //
+
+    if ( SrvCfg_dwUdpRecvDepth )
     {
-        g_OverlapCount = 2;
+        g_OverlapCount = SrvCfg_dwUdpRecvDepth;
     }
     else
     {
-        g_OverlapCount = g_ProcessorCount;
+        g_OverlapCount = g_ProcessorCount * 2;
+    }
+    if ( g_OverlapCount < UDP_MIN_RECV_DEPTH )
+    {
+        g_OverlapCount = UDP_MIN_RECV_DEPTH;
+    }
+    else if ( g_OverlapCount > UDP_MAX_RECV_DEPTH )
+    {
+        g_OverlapCount = UDP_MAX_RECV_DEPTH;
     }
 
     //
@@ -698,6 +698,10 @@ SERVER_PROPERTY ServerPropertyTable[] =
         &SrvCfg_dwCacheEmptyAuthResponses           ,
             TRUE                                    ,
                 NULL                                ,
+    DNS_REGKEY_ANSWER_CACHE_MAX_AGE                 ,
+        &SrvCfg_dwAnswerCacheMaxAge                 ,
+            DNS_DEFAULT_ANSWER_CACHE_MAX_AGE        ,
+                NULL                                ,
 
     //  SOA overrides
 
@@ -734,6 +738,10 @@ SERVER_PROPERTY ServerPropertyTable[] =
         &SrvCfg_dwTcpRecvPacketSize                 ,
             DNS_DEFAULT_TCP_RECEIVE_PACKET_SIZE     ,
                 cfg_SetTcpRecvPacketSize            ,
+    DNS_REGKEY_UDP_RECV_DEPTH                       ,
+        &SrvCfg_dwUdpRecvDepth                      ,
+            0                                       ,
+                NULL                                ,
 
     //  EDNS
 
@@ -111,6 +111,7 @@ typedef struct _DNS_SERVER_INFO
     DWORD               dwSendPort;
     DWORD               dwXfrConnectTimeout;        // connection timeout for dial out
     DWORD               dwTcpRecvPacketSize;
+    DWORD               dwUdpRecvDepth;             // receives posted per UDP socket
 
     //  forwarders
 
@@ -227,6 +228,7 @@ typedef struct _DNS_SERVER_INFO
 
     DWORD       dwMaxCacheSize;
     DWORD       dwCacheEmptyAuthResponses;
+    DWORD       dwAnswerCacheMaxAge;
 
     //  Round robin - types that won't be round-robined (default is ALL)
 
@@ -363,6 +365,7 @@ extern  DNS_SERVER_INFO     SrvInfo;
 #define SrvCfg_dwAdditionalRecursionTimeout ( SrvInfo.dwAdditionalRecursionTimeout )
 #define SrvCfg_dwXfrConnectTimeout          ( SrvInfo.dwXfrConnectTimeout )
 #define SrvCfg_dwTcpRecvPacketSize          ( SrvInfo.dwTcpRecvPacketSize )
+#define SrvCfg_dwUdpRecvDepth               ( SrvInfo.dwUdpRecvDepth )
 #define SrvCfg_dwMaxCacheTtl                ( SrvInfo.dwMaxCacheTtl )
 #define SrvCfg_dwMaxNegativeCacheTtl        ( SrvInfo.dwMaxNegativeCacheTtl)
 #define SrvCfg_dwLameDelegationTtl          ( SrvInfo.dwLameDelegationTtl)
@@ -414,6 +417,17 @@ extern  DNS_SERVER_INFO     SrvInfo;
 
 #define SrvCfg_dwMaxCacheSize               ( SrvInfo.dwMaxCacheSize )
 #define SrvCfg_dwCacheEmptyAuthResponses    ( SrvInfo.dwCacheEmptyAuthResponses )
+#define SrvCfg_dwAnswerCacheMaxAge          ( SrvInfo.dwAnswerCacheMaxAge )
+
+#define DNS_REGKEY_ANSWER_CACHE_MAX_AGE     "AnswerCacheMaxAge"
+
+//  saved answer lifetime in seconds (0 disables), capped in anscache.c
+
+#define DNS_DEFAULT_ANSWER_CACHE_MAX_AGE    (1)
+
+//  receives kept posted on each UDP listen socket (0 for default)
+
+#define DNS_REGKEY_UDP_RECV_DEPTH           "UdpRecvDepth"
 
 #define SrvCfg_dwForceSoaSerial             ( SrvInfo.dwForceSoaSerial )
 #define SrvCfg_dwForceSoaMinimumTtl         ( SrvInfo.dwForceSoaMinimumTtl )
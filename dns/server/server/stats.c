@@ -650,6 +650,8 @@ volatile unsigned long * pcCachingMemory;
 volatile unsigned long * pcUdpMessageMemory;
 volatile unsigned long * pcTcpMessageMemory;
 volatile unsigned long * pcNbstatMemory;
+volatile unsigned long * pcDatabaseLockContention;
+volatile unsigned long * pcDatabaseLockWaitTime;
 
 //
 //  Dummy counter to point counter pointers at if unable to open counter block
@@ -1134,6 +1136,10 @@ Return Values:
                 (TCPMESSAGEMEMORY_OFFSET - TOTALQUERYRECEIVED_OFFSET)/4;
         pcNbstatMemory   = pCounterBlock + 1 +
                 (NBSTATMEMORY_OFFSET - TOTALQUERYRECEIVED_OFFSET)/4;
+        pcDatabaseLockContention   = pCounterBlock + 1 +
+                (DATABASELOCKCONTENTION_OFFSET - TOTALQUERYRECEIVED_OFFSET)/4;
+        pcDatabaseLockWaitTime   = pCounterBlock + 1 +
+                (DATABASELOCKWAITTIME_OFFSET - TOTALQUERYRECEIVED_OFFSET)/4;
 
 
         // SANITY CHECK (RsRaghav) - we seem to have allocated this magic(?) 4096
@@ -1141,7 +1147,7 @@ Return Values:
         // counter added to the perf block.
 
         //ASSERT(((TCPCLICONN/2) * sizeof(unsigned long)) <= 4096);
-        ASSERT(((pcNbstatMemory-pCounterBlock+1) * sizeof(unsigned long)) <= 4096);
+        ASSERT(((pcDatabaseLockWaitTime-pCounterBlock+1) * sizeof(unsigned long)) <= 4096);
 
         memset(pCounterBlock, 0, 4096);
     }
@@ -1169,6 +1175,7 @@ Return Values:
             pcSecureUpdateReceived =  pcSecureUpdateFailure =
             pcDatabaseNodeMemory =  pcRecordFlowMemory =  pcCachingMemory =
             pcUdpMessageMemory =  pcTcpMessageMemory =  pcNbstatMemory =
+            pcDatabaseLockContention =  pcDatabaseLockWaitTime =
          &DummyCounter;
     }
 
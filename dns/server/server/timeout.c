@@ -1190,6 +1190,7 @@ Return Value:
         if ( now > nextDelayedCleanup )
         {
             Timeout_CleanupDelayedFreeList();
+            AnsCache_Cleanup();
             nextDelayedCleanup = now + TIMEOUT_FREE_DELAY;
         }
 #if DBG
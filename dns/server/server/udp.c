@@ -349,7 +349,7 @@ Return Value:
 
 BOOL
 Udp_RecvThread(
-    IN      LPVOID  pvDummy
+    IN      LPVOID  pvThreadIndex
     )
 /*++
 
@@ -361,7 +361,7 @@ Routine Description:
 
 Arguments:
 
-    pvDummy -- unused
+    pvThreadIndex -- index of this recv thread, used to pick processor
 
 Return Value:
 
@@ -379,6 +379,21 @@ Return Value:
 
     DNS_DEBUG( INIT, ( "\nStart UDP receive thread\n" ));
 
+    //
+    //  spread recv threads across processors
+    //      - one thread per processor, each prefers its own, so the packet
+    //      and its answer stay in one processor's cache
+    //      - ideal processor only, scheduler may still move us if our
+    //      processor is busy
+    //
+
+    if ( g_ProcessorCount > 1 )
+    {
+        SetThreadIdealProcessor(
+            GetCurrentThread(),
+            (DWORD) ( (ULONG_PTR) pvThreadIndex % g_ProcessorCount ) );
+    }
+
     //  hold off processing until started
 
     if ( ! Thread_ServiceCheck() )
@@ -1034,7 +1049,7 @@ Return Value:
         if ( ! Thread_Create(
                     "UDP Listen",
                     Udp_RecvThread,
-                    (PVOID) 0,
+                    (PVOID) (ULONG_PTR) i,
                     0 ) )
         {
             DNS_PRINT((
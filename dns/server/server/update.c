@@ -1422,10 +1422,19 @@ Return Value:
         //      (if update was successful)
 
         //  delete temp node
-        //      - first record list
+        //      - first record list;  if executed, this is the list swapped
+        //          off the real node, which lockless answers may still be
+        //          walking, so free it after the timeout
         //      - then node itself
 
-        RR_ListFree( pnodeTemp->pRRList );
+        if ( fexecuted )
+        {
+            RR_ListSlowFree( pnodeTemp->pRRList );
+        }
+        else
+        {
+            RR_ListFree( pnodeTemp->pRRList );
+        }
         NTree_FreeNode( pnodeTemp );
 
         pnodeTemp = pnodeTempNext;
@@ -2985,6 +2994,12 @@ Return Value:
         return;
     }
 
+    //
+    //  new data is in the zone, drop saved answers
+    //
+
+    AnsCache_InvalidateZone( pZone );
+
     //
     //  if zone root is dirty, update zone info
     //
@@ -3177,7 +3192,8 @@ Return Value:
                         QUEUE_SET_EVENT |
                             QUEUE_DISCARD_EXPIRED |
                             QUEUE_DISCARD_DUPLICATES |
-                            QUEUE_QUERY_TIME_ORDER,
+                            QUEUE_QUERY_TIME_ORDER |
+                            QUEUE_QUESTION_INDEX,
                         UPDATE_TIMEOUT,
                         0 );                        //  maximum elements
     if ( !g_UpdateQueue )
@@ -3198,7 +3214,9 @@ Return Value:
                                 "UpdateForwarding",
                                 QUEUE_DISCARD_EXPIRED |
                                     QUEUE_DISCARD_DUPLICATES |
-                                    QUEUE_QUERY_TIME_ORDER,
+                                    QUEUE_QUERY_TIME_ORDER |
+                                    QUEUE_XID_INDEX |
+                                    QUEUE_QUESTION_INDEX,
                                 UPDATE_TIMEOUT,
                                 0 );                //  maximum elements
     if ( !g_UpdateForwardingQueue )
@@ -3221,7 +3239,8 @@ Return Value:
                                 QUEUE_SET_EVENT |
                                     QUEUE_DISCARD_EXPIRED |
                                     QUEUE_DISCARD_DUPLICATES |
-                                    QUEUE_QUERY_TIME_ORDER,
+                                    QUEUE_QUERY_TIME_ORDER |
+                                    QUEUE_QUESTION_INDEX,
                                 UPDATE_TIMEOUT,
                                 0 );                //  maximum elements
     if ( !g_SecureNegoQueue )
@@ -6497,6 +6516,7 @@ Return Value:
         }
 
         LOCK_RR_LIST( pnodeReal );
+        MARK_RR_LIST_WRITE( pnodeReal );
 
         poriginalRR = pnodeReal->pRRList;
         pnodeReal->pRRList = pnodeTemp->pRRList;
@@ -120,7 +120,7 @@ Return Value:
 
     g_pWinsQueue = PQ_CreatePacketQueue(
                     "WINS",
-                    0,                              //  flags
+                    QUEUE_XID_INDEX,
                     WINS_DEFAULT_LOOKUP_TIMEOUT,    //  default timeout
                     0 );                            //  maximum elements
     if ( !g_pWinsQueue )
@@ -558,6 +558,7 @@ Return Value:
         pQuery->fQuestionRecursed = TRUE;
         pQuery->fQuestionCompleted = FALSE;
         pQuery->fWins = TRUE;
+        pQuery->fNoAnswerCache = TRUE;
         pQuery->U.Wins.cchWinsName = cchlabel;
         pQuery->U.Wins.pWinsRR = pWinsRR;
         pQuery->pzoneCurrent = pZone;
@@ -994,6 +994,7 @@ Return Value:
         Timeout_FreeWithFunction( pZone->pLoadTreeRoot, NTree_DeleteSubtree );
         pZone->pLoadTreeRoot = NULL;
     }
+    AnsCache_InvalidateZone( pZone );
 }   //  Zone_DeleteZoneNodes
 
 
@@ -1504,7 +1505,13 @@ Return Value:
         //  Steal the pointer to the children of the zone's own node
         //  and delete the tree from the zone.
         //
-        
+        //  Lockless answers may be walking the root's RR list, so mark
+        //  the move as an RR list write for the whole swap.
+        //
+
+        Dbase_LockDatabase();
+        MARK_RR_LIST_WRITE( pZoneNode );
+
         pChildren = pZoneNode->pChildren;
         cChildren = pZoneNode->cChildren;
         pRRList = pZoneNode->pRRList;
@@ -1532,6 +1539,8 @@ Return Value:
         pZoneNode->cChildren = cChildren;
         pZoneNode->pRRList = pRRList;
         pZone->pZoneRoot = pZoneNode;
+
+        Dbase_UnlockDatabase();
     }
 
     //
@@ -4937,6 +4946,8 @@ Return Value:
     pZone->pLoadZoneRoot = NULL;
     pZone->pLoadOrigin = NULL;
 
+    AnsCache_InvalidateZone( pZone );
+
     if ( IS_ZONE_CACHE(pZone) )
     {
         g_pCacheLocalNode = Lookup_ZoneNodeFromDotted(
@@ -5384,6 +5395,8 @@ Return Value:
     pZone->pTreeRoot = NULL;
     pZone->pZoneRoot = NULL;
 
+    AnsCache_InvalidateZone( pZone );
+
     //  if cache, rebuild functioning cache tree
 
     if ( pZone == g_pCacheZone )
@@ -185,6 +185,15 @@ typedef struct
     DWORD           dwLoadSerialNo;
     DWORD           dwLastXfrSerialNo;
 
+    //  bumped on any change to zone data, drops saved answers (anscache.c)
+
+    DWORD           dwAnswerCacheVersion;
+
+    //  odd while a database lock holder changes the zone's RR lists in
+    //  place;  checked by lockless authoritative answers (dbase.c)
+
+    volatile LONG   lRRListSequence;
+
     //
     //  Adding new RR
     //      - file load, admin tool, zone transfer
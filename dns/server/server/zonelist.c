@@ -152,6 +152,10 @@ Return Value:
 
     LeaveCriticalSection( &csZoneList );
 
+    //  new zone may take over names from parent zone's saved answers
+
+    AnsCache_Flush();
+
     IF_DEBUG( OFF )
     {
         Dbg_ZoneList( "Zone list after insert.\n" );
@@ -201,6 +205,8 @@ Return Value:
     }
     ASSERT( pzoneCurrent == pZone );
     LeaveCriticalSection( &csZoneList );
+
+    AnsCache_Flush();
 }
 
 
@@ -46,6 +46,48 @@ DWORD               gTaskSchedulerTID = 0;  // task scheduler thread id
                                             // init here because its exported
 RTL_AVL_TABLE       gTaskQueue;             // task queue
 
+// A task handed off by the scheduler thread to the worker of its class.  It is
+// out of gTaskQueue by then, so cancellation and dampening also look through
+// the ready lists until the worker picks it up.
+typedef struct _TQ_READY_ENTRY {
+    struct _TQ_READY_ENTRY *    pNext;
+    pTQEntry                    ptqe;
+} TQ_READY_ENTRY;
+
+// The worker thread of a concurrency class and the tasks ready for it.
+// Protected by gcsTaskQueue.
+typedef struct _TQ_CLASS_WORKER {
+    HANDLE              hThread;
+    HANDLE              hevReady;       // signalled when pHead becomes non-NULL
+    TQ_READY_ENTRY *    pHead;
+    TQ_READY_ENTRY *    pTail;
+} TQ_CLASS_WORKER;
+
+TQ_CLASS_WORKER     grgTqWorkers[TASKQ_MAX_CLASSES];   // [TASKQ_CLASS_DEFAULT] unused
+
+// Concurrency class assignments made by SetTaskQueueClass().  Protected by
+// gcsTaskQueue.
+typedef struct _TQ_CLASS_ASSIGNMENT {
+    PTASKQFN    pfnTaskFn;
+    DWORD       iClass;
+} TQ_CLASS_ASSIGNMENT;
+
+#define TQ_MAX_CLASS_ASSIGNMENTS    ( 32 )
+TQ_CLASS_ASSIGNMENT grgTqClassAssignments[TQ_MAX_CLASS_ASSIGNMENTS];
+DWORD               gcTqClassAssignments = 0;
+
+// Per-task statistics, by function name.  Protected by gcsTaskQueue.
+#define TQ_MAX_STATS                ( 64 )
+TASKQ_STATS         grgTqStats[TQ_MAX_STATS];
+DWORD               gcTqStats = 0;
+
+typedef struct {
+    PTASKQFN    pfnTaskQFn;
+    void *      pvParm;
+    PCHAR       pfnName;
+    HANDLE      hevDone;
+} TASK_TRIGGER_INFO;
+
 // The array of handles to events that the task scheduler waits on, and the
 // corresponding array of functions it calls when each event is triggered.
 // The only "unique" event/function pair is at index 0 -- the event signals an
@@ -55,7 +97,11 @@ HANDLE              grgWaitHandles[MAXIMUM_WAIT_OBJECTS];
 DWORD               gcWaitHandles = 0;
 
 unsigned __stdcall TaskScheduler( void * pv );
+unsigned __stdcall TaskClassWorker( void * pv );
+void TQExecuteTask( pTQEntry ptqe, DWORD iClass, PEVENT_TRACE_HEADER traceHeader, DWORD clientID );
 void RemoveFromTaskQueueInternal( pTQEntry pTQOld );
+BOOL TQRemoveReadyTask( PTASKQFN pfnTaskFn, void * pvParm, pTQEntry ptqeExact );
+BOOL TQFindMatchingReadyTask( pTQEntry pTQNew, PISMATCHED pfnIsMatched, void * pContext );
 void TriggerCallback(void*, void**, DWORD*);
 
 #if DBG
@@ -251,6 +297,9 @@ InitTaskScheduler(
 
         gfTqShutdownRequested = FALSE;
         gpfnTqCurrentTask     = NULL;
+        gcTqClassAssignments  = 0;
+        gcTqStats             = 0;
+        memset(grgTqWorkers, 0, sizeof(grgTqWorkers));
         ghTqWakeUp            = NULL;
         ghTaskSchedulerThread = NULL;
         gTaskSchedulerTID     = 0;
@@ -335,8 +384,16 @@ ShutdownTaskSchedulerTrigger()
 {
     if ( gfIsTqRunning ) {
 
+        DWORD iClass;
+
         gfTqShutdownRequested = TRUE;
         SetEvent( ghTqWakeUp );
+
+        for (iClass = 0; iClass < TASKQ_MAX_CLASSES; iClass++) {
+            if (NULL != grgTqWorkers[iClass].hevReady) {
+                SetEvent(grgTqWorkers[iClass].hevReady);
+            }
+        }
     }
 }
 
@@ -349,7 +406,10 @@ ShutdownTaskSchedulerWait(
 {
     if ( gfIsTqRunning )
     {
-        DWORD dwWaitStatus;
+        DWORD               dwWaitStatus;
+        DWORD               iClass;
+        DWORD               cTickStart, cTickElapsed, cMSecWait;
+        TQ_READY_ENTRY *    pReady;
 
         Assert(gfTqShutdownRequested);
 
@@ -360,6 +420,8 @@ ShutdownTaskSchedulerWait(
             StartTaskScheduler();
         }
 
+        cTickStart = GetTickCount();
+
         dwWaitStatus = WaitForSingleObject(
                             ghTaskSchedulerThread,
                             dwWaitTimeInMilliseconds
@@ -367,8 +429,51 @@ ShutdownTaskSchedulerWait(
 
         gfIsTqRunning = ( WAIT_OBJECT_0 != dwWaitStatus );
 
+        // The class workers must be gone too before we can tear down the
+        // queue; give them whatever is left of the caller's wait.
+        for (iClass = 0;
+             !gfIsTqRunning && (iClass < TASKQ_MAX_CLASSES);
+             iClass++) {
+
+            if (NULL == grgTqWorkers[iClass].hThread) {
+                continue;
+            }
+
+            cMSecWait = dwWaitTimeInMilliseconds;
+            if (INFINITE != dwWaitTimeInMilliseconds) {
+                cTickElapsed = GetTickCount() - cTickStart;
+                cMSecWait = (cTickElapsed < dwWaitTimeInMilliseconds)
+                                ? dwWaitTimeInMilliseconds - cTickElapsed
+                                : 0;
+            }
+
+            dwWaitStatus = WaitForSingleObject(grgTqWorkers[iClass].hThread,
+                                               cMSecWait);
+            gfIsTqRunning = ( WAIT_OBJECT_0 != dwWaitStatus );
+        }
+
         if ( !gfIsTqRunning )
         {
+            for (iClass = 0; iClass < TASKQ_MAX_CLASSES; iClass++) {
+                TQ_CLASS_WORKER * pWorker = &grgTqWorkers[iClass];
+
+                // Tasks handed off but never run are dropped, just like the
+                // tasks still in the queue.
+                while (NULL != (pReady = pWorker->pHead)) {
+                    pWorker->pHead = pReady->pNext;
+                    free(pReady->ptqe);
+                    free(pReady);
+                }
+
+                if (NULL != pWorker->hThread) {
+                    CloseHandle(pWorker->hThread);
+                }
+                if (NULL != pWorker->hevReady) {
+                    CloseHandle(pWorker->hevReady);
+                }
+            }
+            memset(grgTqWorkers, 0, sizeof(grgTqWorkers));
+
             DeleteCriticalSection( &gcsTaskQueue );
 
             CloseHandle( ghTaskSchedulerThread );
@@ -449,11 +554,18 @@ InsertInTaskQueueHelperDamped(
     EnterCriticalSection(&gcsTaskQueue);
     __try
     {
+        // Tasks handed off to a class worker but not yet started are due
+        // now, so they always fall within the dampening window.
+        fFoundMatch = TQFindMatchingReadyTask(pTQNew, pfnIsMatched, pContext);
+        if( fFoundMatch ) {
+            DPRINT(1, "Dampening: Found matching task ready to execute\n");
+        }
+
         //
         // Traverse table looking for our entry
         //
         for ( ptqe = RtlEnumerateGenericTableWithoutSplayingAvl(&gTaskQueue, &Restart);
-             (NULL != ptqe) && !gfTqShutdownRequested;
+             !fFoundMatch && (NULL != ptqe) && !gfTqShutdownRequested;
               ptqe = RtlEnumerateGenericTableWithoutSplayingAvl(&gTaskQueue, &Restart))
         {
 
@@ -685,6 +797,9 @@ Remarks:
         if (fFound) {
             // remove old one
             RemoveFromTaskQueueInternal( ptqe );
+        } else {
+            // It may have been handed off to a class worker already.
+            fFound = TQRemoveReadyTask( pfnTaskQFn, pvParm, NULL );
         }
 
 #if DBG
@@ -741,7 +856,11 @@ RemoveFromTaskQueue(
         EnterCriticalSection(&gcsTaskQueue);
         __try
         {
-            RemoveFromTaskQueueInternal( pTQOld );
+            if (!TQRemoveReadyTask( pTQOld->pfnTaskFn,
+                                    pTQOld->pvTaskParm,
+                                    pTQOld )) {
+                RemoveFromTaskQueueInternal( pTQOld );
+            }
         }
         __finally
         {
@@ -807,24 +926,403 @@ GetNextTask( void )
     return ptqe;
 }
 
-unsigned __stdcall
-TaskScheduler(
-    void *  pv
+DWORD
+TQGetTaskClass(
+    IN  pTQEntry    ptqe
     )
+/*++
+
+Routine Description:
+
+    Find the concurrency class of a queued task.  Triggered tasks run in the
+    class of the function triggered.
+
+    gcsTaskQueue must be held.
+
+Arguments:
+
+    ptqe - task
+
+Return Value:
+
+    The class.
+
+--*/
 {
-    DWORD       cMSecUntilNextTask = 0;
-    pTQEntry    ptqe;
-    DWORD       err;
-    DWORD       dwExcept;
-    CHAR        timeStr[13];
+    PTASKQFN    pfnTaskFn = ptqe->pfnTaskFn;
+    DWORD       i;
 
-    // tracing event buffer and ClientID
-    CHAR traceHeaderBuffer[sizeof(EVENT_TRACE_HEADER)+sizeof(MOF_FIELD)];
-    PEVENT_TRACE_HEADER traceHeader = (PEVENT_TRACE_HEADER)traceHeaderBuffer;
+    if (TriggerCallback == pfnTaskFn) {
+        pfnTaskFn = ((TASK_TRIGGER_INFO *) ptqe->pvTaskParm)->pfnTaskQFn;
+    }
+
+    for (i = 0; i < gcTqClassAssignments; i++) {
+        if (grgTqClassAssignments[i].pfnTaskFn == pfnTaskFn) {
+            return grgTqClassAssignments[i].iClass;
+        }
+    }
+
+    return TASKQ_CLASS_DEFAULT;
+}
+
+
+DWORD
+TQDispatchToClassWorker(
+    IN  pTQEntry    ptqe
+    )
+/*++
+
+Routine Description:
+
+    Hand a ready task off to the worker thread of its concurrency class.
+
+Arguments:
+
+    ptqe - task, already removed from the queue.  Ownership passes to the
+        worker if the task is handed off.
+
+Return Value:
+
+    The class the task was handed off to, or TASKQ_CLASS_DEFAULT if it is
+    in the default class (or couldn't be handed off) and the caller must run
+    it.
+
+--*/
+{
+    TQ_CLASS_WORKER *   pWorker;
+    TQ_READY_ENTRY *    pReady;
+    DWORD               iClass;
+
+    EnterCriticalSection( &gcsTaskQueue );
+    __try
+    {
+        iClass = TQGetTaskClass(ptqe);
+        if (TASKQ_CLASS_DEFAULT == iClass) {
+            __leave;
+        }
+
+        pWorker = &grgTqWorkers[iClass];
+        pReady = malloc(sizeof(*pReady));
+        if ((NULL == pWorker->hThread) || (NULL == pReady)) {
+            // No worker; run it on the scheduler thread like any other task.
+            free(pReady);
+            iClass = TASKQ_CLASS_DEFAULT;
+            __leave;
+        }
+
+        pReady->pNext = NULL;
+        pReady->ptqe  = ptqe;
+
+        if (NULL == pWorker->pTail) {
+            pWorker->pHead = pReady;
+        } else {
+            pWorker->pTail->pNext = pReady;
+        }
+        pWorker->pTail = pReady;
+
+        SetEvent(pWorker->hevReady);
+    }
+    __finally
+    {
+        LeaveCriticalSection( &gcsTaskQueue );
+    }
+
+    return iClass;
+}
+
+
+BOOL
+TQRemoveReadyTask(
+    IN  PTASKQFN    pfnTaskFn,
+    IN  void *      pvParm,
+    IN  pTQEntry    ptqeExact   OPTIONAL
+    )
+/*++
+
+Routine Description:
+
+    Remove a task handed off to a class worker that the worker has not
+    started yet.  Such tasks are no longer in the queue, so the queue
+    lookups won't find them.
+
+    gcsTaskQueue must be held.
+
+Arguments:
+
+    pfnTaskFn - task function
+    pvParm - context parameter
+    ptqeExact - if present, only remove a task identical to this one
+        (time values included)
+
+Return Value:
+
+    TRUE: Removed.
+    FALSE: No such task waiting for a worker.
+
+--*/
+{
+    TQ_CLASS_WORKER *   pWorker;
+    TQ_READY_ENTRY **   ppReady;
+    TQ_READY_ENTRY *    pReady;
+    TQ_READY_ENTRY *    pPrev;
+    DWORD               iClass;
+
+    for (iClass = 0; iClass < TASKQ_MAX_CLASSES; iClass++) {
+        pWorker = &grgTqWorkers[iClass];
+        pPrev = NULL;
+
+        for (ppReady = &pWorker->pHead;
+             NULL != (pReady = *ppReady);
+             pPrev = pReady, ppReady = &pReady->pNext) {
+
+            if ((pReady->ptqe->pfnTaskFn != pfnTaskFn)
+                || (pReady->ptqe->pvTaskParm != pvParm)
+                || ((NULL != ptqeExact)
+                    && memcmp(pReady->ptqe, ptqeExact, sizeof(TQEntry)))) {
+                continue;
+            }
+
+            *ppReady = pReady->pNext;
+            if (pWorker->pTail == pReady) {
+                pWorker->pTail = pPrev;
+            }
+
+            free(pReady->ptqe);
+            free(pReady);
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+
+BOOL
+TQFindMatchingReadyTask(
+    IN  pTQEntry    pTQNew,
+    IN  PISMATCHED  pfnIsMatched,
+    IN  void *      pContext
+    )
+/*++
+
+Routine Description:
+
+    Look for a task handed off to a class worker but not started yet that
+    matches the given task, for dampening.
+
+    gcsTaskQueue must be held.
+
+Arguments:
+
+    pTQNew - task being inserted
+    pfnIsMatched - decides whether two tasks match
+    pContext - passed to pfnIsMatched
+
+Return Value:
+
+    TRUE if a matching task is waiting for a worker.
+
+--*/
+{
+    TQ_READY_ENTRY *    pReady;
+    DWORD               iClass;
+
+    for (iClass = 0; iClass < TASKQ_MAX_CLASSES; iClass++) {
+        for (pReady = grgTqWorkers[iClass].pHead;
+             NULL != pReady;
+             pReady = pReady->pNext) {
+
+            if (pfnIsMatched(pTQNew->pfnName, pTQNew->pvTaskParm,
+                             pReady->ptqe->pfnName, pReady->ptqe->pvTaskParm,
+                             pContext)) {
+                return TRUE;
+            }
+        }
+    }
+
+    return FALSE;
+}
+
+
+VOID
+TQUpdateStats(
+    IN  PCHAR   pfnName,
+    IN  DWORD   iClass,
+    IN  DWORD   cMSecLate,
+    IN  DWORD   cMSecRun
+    )
+{
+    TASKQ_STATS *   pStats = NULL;
+    DWORD           i;
+
+    if (NULL == pfnName) {
+        return;
+    }
+
+    EnterCriticalSection( &gcsTaskQueue );
+    __try
+    {
+        for (i = 0; i < gcTqStats; i++) {
+            if (TaskQueueNameMatched(grgTqStats[i].pfnName, NULL, pfnName, NULL, NULL)) {
+                pStats = &grgTqStats[i];
+                break;
+            }
+        }
+
+        if (NULL == pStats) {
+            if (gcTqStats >= TQ_MAX_STATS) {
+                __leave;
+            }
+            pStats = &grgTqStats[gcTqStats++];
+            memset(pStats, 0, sizeof(*pStats));
+            pStats->pfnName = pfnName;
+        }
+
+        pStats->iClass = iClass;
+        pStats->cRuns++;
+        pStats->cMSecRunTotal += cMSecRun;
+        pStats->cMSecRunMax = max(pStats->cMSecRunMax, cMSecRun);
+        pStats->cMSecLateTotal += cMSecLate;
+        pStats->cMSecLateMax = max(pStats->cMSecLateMax, cMSecLate);
+    }
+    __finally
+    {
+        LeaveCriticalSection( &gcsTaskQueue );
+    }
+}
+
+
+DWORD
+GetTaskQueueStats(
+    OUT TASKQ_STATS *   rgStats,
+    IN  DWORD           cStats
+    )
+{
+    DWORD cCopied = 0;
+
+    if ( !gfIsTqRunning )
+    {
+        return 0;
+    }
+
+    EnterCriticalSection( &gcsTaskQueue );
+    __try
+    {
+        cCopied = min(cStats, gcTqStats);
+        memcpy(rgStats, grgTqStats, cCopied * sizeof(TASKQ_STATS));
+    }
+    __finally
+    {
+        LeaveCriticalSection( &gcsTaskQueue );
+    }
+
+    return cCopied;
+}
+
+
+BOOL
+SetTaskQueueClass(
+    PTASKQFN    pfnTaskQFn,
+    DWORD       iClass
+    )
+/*++
+
+Routine Description:
+
+    Assign a task queue function to a concurrency class, starting the worker
+    thread of that class if it isn't running yet.
+
+Arguments:
+
+    pfnTaskQFn - task function
+    iClass - TASKQ_CLASS_DEFAULT or another class < TASKQ_MAX_CLASSES
+
+Return Value:
+
+    TRUE: Assigned.
+    FALSE: Not assigned; the task will run on the task scheduler thread.
+
+--*/
+{
+    TQ_CLASS_WORKER *   pWorker;
+    BOOL                fAssigned = FALSE;
+    DWORD               i;
+    unsigned            tid;
+
+    Assert(pfnTaskQFn);
+
+    if ( !gfIsTqRunning || (iClass >= TASKQ_MAX_CLASSES) )
+    {
+        Assert( !"SetTaskQueueClass() called before InitTaskScheduler() or with a bad class!" );
+        return FALSE;
+    }
+
+    EnterCriticalSection( &gcsTaskQueue );
+    __try
+    {
+        if (TASKQ_CLASS_DEFAULT != iClass) {
+            pWorker = &grgTqWorkers[iClass];
+
+            if (NULL == pWorker->hevReady) {
+                pWorker->hevReady = CreateEvent(NULL, FALSE, FALSE, NULL);
+                if (NULL == pWorker->hevReady) {
+                    LogUnhandledError( GetLastError() );
+                    __leave;
+                }
+            }
+
+            if (NULL == pWorker->hThread) {
+                pWorker->hThread =
+                    (HANDLE) _beginthreadex(
+                        NULL,
+                        0,              // stack size: use process default
+                        TaskClassWorker,
+                        (void *) (DWORD_PTR) iClass,
+                        0,
+                        &tid
+                        );
+                if (NULL == pWorker->hThread) {
+                    LogUnhandledError( GetLastError() );
+                    __leave;
+                }
+            }
+        }
+
+        for (i = 0; i < gcTqClassAssignments; i++) {
+            if (grgTqClassAssignments[i].pfnTaskFn == pfnTaskQFn) {
+                break;
+            }
+        }
+
+        if (i == gcTqClassAssignments) {
+            if (gcTqClassAssignments >= TQ_MAX_CLASS_ASSIGNMENTS) {
+                Assert(!"Too many task queue class assignments!");
+                __leave;
+            }
+            gcTqClassAssignments++;
+        }
+
+        grgTqClassAssignments[i].pfnTaskFn = pfnTaskQFn;
+        grgTqClassAssignments[i].iClass    = iClass;
+        fAssigned = TRUE;
+    }
+    __finally
+    {
+        LeaveCriticalSection( &gcsTaskQueue );
+    }
+
+    return fAssigned;
+}
+
+
+VOID
+TQInitTraceHeader(
+    OUT PEVENT_TRACE_HEADER traceHeader,
+    OUT DWORD *             pClientID
+    )
+{
     PWNODE_HEADER wnode = (PWNODE_HEADER)traceHeader;
-    DWORD clientID;
-    
-    // initialize tracing vars
+
     ZeroMemory(traceHeader, sizeof(EVENT_TRACE_HEADER)+sizeof(MOF_FIELD));
     wnode->Flags = WNODE_FLAG_USE_GUID_PTR | // Use a guid ptr instead of copying
                    WNODE_FLAG_USE_MOF_PTR  | // Data is not contiguous to header
@@ -839,12 +1337,258 @@ TaskScheduler(
     {
         ULARGE_INTEGER lu;
         lu.QuadPart = (ULONGLONG)&gTaskQueue;
-        clientID = lu.LowPart;
+        *pClientID = lu.LowPart;
     }
 #else
-    clientID = (DWORD)&gTaskQueue;
+    *pClientID = (DWORD)&gTaskQueue;
+#endif
+}
+
+
+VOID
+TQExecuteTask(
+    pTQEntry            ptqe,
+    DWORD               iClass,
+    PEVENT_TRACE_HEADER traceHeader,
+    DWORD               clientID
+    )
+/*++
+
+Routine Description:
+
+    Run a ready task, record its statistics, and then either reschedule or
+    free it.
+
+Arguments:
+
+    ptqe - task, already removed from the queue.  Consumed.
+    iClass - concurrency class of the calling thread
+    traceHeader, clientID - the calling thread's tracing state
+
+Return Value:
+
+    None.
+
+--*/
+{
+    void *  pvParamNext = NULL;
+    DWORD   cSecsFromNow = TASKQ_DONT_RESCHEDULE;
+    DWORD   dwExcept;
+    DWORD   cTickStart, cTickLate;
+    PCHAR   pfnName = ptqe->pfnName;
+#if DBG
+    CHAR    timeStr[13];
+#endif
+
+    if (ptqe->pfnTaskFn == TriggerCallback) {
+        // Account the run to the triggered task.  (Grab the name now; the
+        // trigger info is freed by the callback.)
+        pfnName = ((TASK_TRIGGER_INFO *) ptqe->pvTaskParm)->pfnName;
+    }
+    else {
+        // don't log trigger callback calls -- those are logged inside the callback!
+#if DBG
+        DPRINT3(1, "%s exec %s, param=%p\n", getCurrentTime(timeStr), ptqe->pfnName, ptqe->pvTaskParm);
+        if (DebugTest(5, DEBSUB)) {
+            debugPrintTaskQueue();
+        }
+#endif
+
+        LogAndTraceEventWithHeader(FALSE,
+                                   DS_EVENT_CAT_DIRECTORY_ACCESS,
+                                   DS_EVENT_SEV_VERBOSE,
+                                   DIRLOG_TASK_QUEUE_BEGIN_EXECUTE,
+                                   EVENT_TRACE_TYPE_START,
+                                   DsGuidTaskQueueExecute,
+                                   traceHeader,
+                                   clientID,
+                                   szInsertSz(ptqe->pfnName),
+                                   szInsertPtr(ptqe->pvTaskParm),
+                                   NULL,
+                                   NULL,
+                                   NULL,
+                                   NULL,
+                                   NULL,
+                                   NULL);
+    }
+    dwExcept = 0;
+
+    // How late are we in starting the task?  (The subtraction wraps if we
+    // are early, which can happen only by a tick or so.)
+    cTickStart = GetTickCount();
+    cTickLate = cTickStart - (ptqe->cTickRegistered + ptqe->cTickDelay);
+    if (cTickLate >= 0x7fffffff) {
+        cTickLate = 0;
+    }
+
+    __try {
+        // execute task
+        if (TASKQ_CLASS_DEFAULT == iClass) {
+            gpfnTqCurrentTask = ptqe->pfnTaskFn;
+        }
+        (*ptqe->pfnTaskFn)( ptqe->pvTaskParm,
+                           &pvParamNext,
+                           &cSecsFromNow );
+        if (TASKQ_CLASS_DEFAULT == iClass) {
+            gpfnTqCurrentTask = NULL;
+        }
+    }
+    __except ( HandleMostExceptions( dwExcept = GetExceptionCode() ) ) {
+        // a non-critical exception was generated in the bowels
+        // of the queued function; this clause ensures the
+        // scheduler thread continues unabated
+        ;
+    }
+
+    TQUpdateStats(pfnName, iClass, cTickLate, GetTickCount() - cTickStart);
+
+    if (ptqe->pfnTaskFn != TriggerCallback) {
+        LogAndTraceEventWithHeader(FALSE,
+                                   DS_EVENT_CAT_DIRECTORY_ACCESS,
+                                   DS_EVENT_SEV_VERBOSE,
+                                   DIRLOG_TASK_QUEUE_END_EXECUTE,
+                                   EVENT_TRACE_TYPE_END,
+                                   DsGuidTaskQueueExecute,
+                                   traceHeader,
+                                   clientID,
+                                   szInsertSz(ptqe->pfnName),
+                                   szInsertPtr(ptqe->pvTaskParm),
+                                   szInsertHex(dwExcept),                                   
+                                   szInsertInt(cSecsFromNow == TASKQ_DONT_RESCHEDULE ? -1 : cSecsFromNow),
+                                   szInsertPtr(pvParamNext),
+                                   NULL,
+                                   NULL,
+                                   NULL);
+    }
+
+    // Task has already been removed by this point
+
+    if ( TASKQ_DONT_RESCHEDULE == cSecsFromNow ) {
+        // task is not to be rescheduled
+        free( ptqe );
+    }
+    else {
+        Assert(cSecsFromNow < MAX_TASKQ_DELAY_SECS);
+
+        // reschedule this task with new parameter and time
+        ptqe->pvTaskParm      = pvParamNext;
+        ptqe->cTickRegistered = GetTickCount();
+        ptqe->cTickDelay      = cSecsFromNow * 1000;
+
+        // Note that there is a window here where another thread could
+        // have inserted the same task already. We don't worry about this.
+        // At the worst, it results in an extra execution.
+        InsertInTaskQueueHelper( ptqe );
+
+#if DBG
+        DPRINT4(1, "%s reschedule %s, param=%p, secs=%d\n", getCurrentTime(timeStr), ptqe->pfnName, pvParamNext, cSecsFromNow);
+        if (DebugTest(5, DEBSUB)) {
+            debugPrintTaskQueue();
+        }
 #endif
 
+        // the rtl function will create another copy,
+        // so free the user copy.
+        free( ptqe );
+
+        if (TASKQ_CLASS_DEFAULT != iClass) {
+            // The scheduler thread may be sleeping until a later task;
+            // have it recompute its wait.
+            SetEvent( ghTqWakeUp );
+        }
+    }
+}
+
+
+unsigned __stdcall
+TaskClassWorker(
+    void *  pv
+    )
+/*++
+
+Routine Description:
+
+    Worker thread of a concurrency class.  Runs the tasks the scheduler
+    thread hands off to this class, one at a time, in the order handed off.
+
+Arguments:
+
+    pv - the class
+
+Return Value:
+
+    0
+
+--*/
+{
+    DWORD               iClass = (DWORD) (DWORD_PTR) pv;
+    TQ_CLASS_WORKER *   pWorker = &grgTqWorkers[iClass];
+    TQ_READY_ENTRY *    pReady;
+    pTQEntry            ptqe;
+
+    // tracing event buffer and ClientID
+    CHAR traceHeaderBuffer[sizeof(EVENT_TRACE_HEADER)+sizeof(MOF_FIELD)];
+    PEVENT_TRACE_HEADER traceHeader = (PEVENT_TRACE_HEADER)traceHeaderBuffer;
+    DWORD clientID;
+
+    Assert(TASKQ_CLASS_DEFAULT != iClass);
+
+    TQInitTraceHeader(traceHeader, &clientID);
+
+    while ( !gfTqShutdownRequested )
+    {
+        WaitForSingleObject(pWorker->hevReady, INFINITE);
+
+        while ( !gfTqShutdownRequested )
+        {
+            EnterCriticalSection( &gcsTaskQueue );
+            __try
+            {
+                pReady = pWorker->pHead;
+                if (NULL != pReady) {
+                    pWorker->pHead = pReady->pNext;
+                    if (NULL == pWorker->pHead) {
+                        pWorker->pTail = NULL;
+                    }
+                }
+            }
+            __finally
+            {
+                LeaveCriticalSection( &gcsTaskQueue );
+            }
+
+            if (NULL == pReady) {
+                break;
+            }
+
+            ptqe = pReady->ptqe;
+            free(pReady);
+
+            TQExecuteTask(ptqe, iClass, traceHeader, clientID);
+        }
+    }
+
+    return 0;
+}
+
+
+unsigned __stdcall
+TaskScheduler(
+    void *  pv
+    )
+{
+    DWORD       cMSecUntilNextTask = 0;
+    pTQEntry    ptqe;
+    DWORD       err;
+    DWORD       dwExcept;
+
+    // tracing event buffer and ClientID
+    CHAR traceHeaderBuffer[sizeof(EVENT_TRACE_HEADER)+sizeof(MOF_FIELD)];
+    PEVENT_TRACE_HEADER traceHeader = (PEVENT_TRACE_HEADER)traceHeaderBuffer;
+    DWORD clientID;
+    
+    TQInitTraceHeader(traceHeader, &clientID);
+
     while ( !gfTqShutdownRequested )
     {
         // wait until time for next task, shutdown, or a new task
@@ -889,100 +1633,13 @@ TaskScheduler(
                   ptqe = GetNextReadyTaskAndRemove()
                 )
             {
-                void *  pvParamNext = NULL;
-                DWORD   cSecsFromNow = TASKQ_DONT_RESCHEDULE;
-
-                if (ptqe->pfnTaskFn != TriggerCallback) {
-                    // don't log trigger callback calls -- those are logged inside the callback!
-#if DBG
-                    DPRINT3(1, "%s exec %s, param=%p\n", getCurrentTime(timeStr), ptqe->pfnName, ptqe->pvTaskParm);
-                    if (DebugTest(5, DEBSUB)) {
-                        debugPrintTaskQueue();
-                    }
-#endif
-    
-                    LogAndTraceEventWithHeader(FALSE,
-                                               DS_EVENT_CAT_DIRECTORY_ACCESS,
-                                               DS_EVENT_SEV_VERBOSE,
-                                               DIRLOG_TASK_QUEUE_BEGIN_EXECUTE,
-                                               EVENT_TRACE_TYPE_START,
-                                               DsGuidTaskQueueExecute,
-                                               traceHeader,
-                                               clientID,
-                                               szInsertSz(ptqe->pfnName),
-                                               szInsertPtr(ptqe->pvTaskParm),
-                                               NULL,
-                                               NULL,
-                                               NULL,
-                                               NULL,
-                                               NULL,
-                                               NULL);
-                }
-                dwExcept = 0;
-                
-                __try {
-                    // execute task
-                    gpfnTqCurrentTask = ptqe->pfnTaskFn;
-                    (*ptqe->pfnTaskFn)( ptqe->pvTaskParm,
-                                       &pvParamNext,
-                                       &cSecsFromNow );
-                    gpfnTqCurrentTask = NULL;
-                }
-                __except ( HandleMostExceptions( dwExcept = GetExceptionCode() ) ) {
-                    // a non-critical exception was generated in the bowels
-                    // of the queued function; this clause ensures the
-                    // scheduler thread continues unabated
-                    ;
-                }
-
-                if (ptqe->pfnTaskFn != TriggerCallback) {
-                    LogAndTraceEventWithHeader(FALSE,
-                                               DS_EVENT_CAT_DIRECTORY_ACCESS,
-                                               DS_EVENT_SEV_VERBOSE,
-                                               DIRLOG_TASK_QUEUE_END_EXECUTE,
-                                               EVENT_TRACE_TYPE_END,
-                                               DsGuidTaskQueueExecute,
-                                               traceHeader,
-                                               clientID,
-                                               szInsertSz(ptqe->pfnName),
-                                               szInsertPtr(ptqe->pvTaskParm),
-                                               szInsertHex(dwExcept),                                   
-                                               szInsertInt(cSecsFromNow == TASKQ_DONT_RESCHEDULE ? -1 : cSecsFromNow),
-                                               szInsertPtr(pvParamNext),
-                                               NULL,
-                                               NULL,
-                                               NULL);
-                }
-                
-                // Task has already been removed by this point
-
-                if ( TASKQ_DONT_RESCHEDULE == cSecsFromNow ) {
-                    // task is not to be rescheduled
-                    free( ptqe );
-                }
-                else {
-                    Assert(cSecsFromNow < MAX_TASKQ_DELAY_SECS);
-
-                    // reschedule this task with new parameter and time
-                    ptqe->pvTaskParm      = pvParamNext;
-                    ptqe->cTickRegistered = GetTickCount();
-                    ptqe->cTickDelay      = cSecsFromNow * 1000;
-
-                    // Note that there is a window here where another thread could
-                    // have inserted the same task already. We don't worry about this.
-                    // At the worst, it results in an extra execution.
-                    InsertInTaskQueueHelper( ptqe );
-
-#if DBG
-                    DPRINT4(1, "%s reschedule %s, param=%p, secs=%d\n", getCurrentTime(timeStr), ptqe->pfnName, pvParamNext, cSecsFromNow);
-                    if (DebugTest(5, DEBSUB)) {
-                        debugPrintTaskQueue();
-                    }
-#endif
-
-                    // the rtl function will create another copy,
-                    // so free the user copy.
-                    free( ptqe );
+                // Tasks of other concurrency classes are handed off to the
+                // worker of their class; the rest we run ourselves.
+                if (TASKQ_CLASS_DEFAULT == TQDispatchToClassWorker(ptqe)) {
+                    TQExecuteTask(ptqe,
+                                  TASKQ_CLASS_DEFAULT,
+                                  traceHeader,
+                                  clientID);
                 }
             }
         }
@@ -1007,13 +1664,6 @@ TaskScheduler(
 // This code shamelessly copied from the task triggering functionality in
 // kcctask.cxx by Jeffparh.
 
-typedef struct {
-    PTASKQFN    pfnTaskQFn;
-    void *      pvParm;
-    PCHAR       pfnName;
-    HANDLE      hevDone;
-} TASK_TRIGGER_INFO;
-
 void
 TriggerCallback(
     IN  void *  pvTriggerInfo,
@@ -1319,6 +1969,22 @@ VOID debugPrintTaskQueue()
             DebPrint(0, "%12s %-30s %p %6d %12s\n", NULL, 0, 
                      execTime, ptqe->pfnName, ptqe->pvTaskParm, ptqe->cTickDelay/1000, schedTime);
         }
+
+        // Per-task statistics, in msecs.
+        DebPrint(0, "%-30s %5s %6s %10s %10s %10s %10s\n", NULL, 0,
+                 "Function", "Class", "Runs", "AvgRun", "MaxRun", "AvgLate", "MaxLate");
+        for (count = 0; count < gcTqStats; count++) {
+            TASKQ_STATS * pStats = &grgTqStats[count];
+
+            DebPrint(0, "%-30s %5d %6d %10I64u %10d %10I64u %10d\n", NULL, 0,
+                     pStats->pfnName,
+                     pStats->iClass,
+                     pStats->cRuns,
+                     pStats->cMSecRunTotal / pStats->cRuns,
+                     pStats->cMSecRunMax,
+                     pStats->cMSecLateTotal / pStats->cRuns,
+                     pStats->cMSecLateMax);
+        }
     }
     __finally
     {
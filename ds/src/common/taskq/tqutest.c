@@ -59,6 +59,68 @@ void SetFlag( void * pv, void ** ppv, DWORD * pSecsUntilNext )
     *pSecsUntilNext = TASKQ_DONT_RESCHEDULE;
 }
 
+HANDLE  hevDefaultRan;
+
+// Runs in a concurrency class of its own; must not keep SignalDefault (in
+// the default class) from running.
+void BlockInClass( void * pv, void ** ppv, DWORD * pSecsUntilNext )
+{
+    if ( WAIT_OBJECT_0 != WaitForSingleObject( hevDefaultRan, 5000 ) )
+    {
+        printf( "Task in class 1 held up the default class!\n" );
+        fFailed = TRUE;
+    }
+
+    *pSecsUntilNext = TASKQ_DONT_RESCHEDULE;
+}
+
+void SignalDefault( void * pv, void ** ppv, DWORD * pSecsUntilNext )
+{
+    SetEvent( hevDefaultRan );
+
+    *pSecsUntilNext = TASKQ_DONT_RESCHEDULE;
+}
+
+void TestClasses( void )
+{
+    TASKQ_STATS rgStats[ 16 ];
+    DWORD       cStats;
+    DWORD       iStats;
+    BOOL        fFound = FALSE;
+
+    hevDefaultRan = CreateEvent( NULL, TRUE, FALSE, NULL );
+
+    if ( !SetTaskQueueClass( BlockInClass, 1 ) )
+    {
+        printf( "SetTaskQueueClass failed!\n" );
+        fFailed = TRUE;
+        return;
+    }
+
+    InsertInTaskQueue( BlockInClass, NULL, 0 );
+    InsertInTaskQueue( SignalDefault, NULL, 1 );
+
+    Sleep( 3000 );
+
+    cStats = GetTaskQueueStats( rgStats, sizeof( rgStats ) / sizeof( rgStats[ 0 ] ) );
+    for ( iStats = 0; iStats < cStats; iStats++ )
+    {
+        if ( !strcmp( rgStats[ iStats ].pfnName, "BlockInClass" ) )
+        {
+            fFound = ( 1 == rgStats[ iStats ].iClass )
+                     && ( 1 == rgStats[ iStats ].cRuns );
+        }
+    }
+
+    if ( !fFound )
+    {
+        printf( "No statistics for BlockInClass in class 1!\n" );
+        fFailed = TRUE;
+    }
+
+    CloseHandle( hevDefaultRan );
+}
+
     
 
 int
@@ -100,6 +162,11 @@ main(
             }
         }
 
+        if ( !fFailed )
+        {
+            TestClasses();
+        }
+
         if ( !fFailed )
         {
             ShutdownTaskSchedulerTrigger();
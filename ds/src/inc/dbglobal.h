@@ -162,6 +162,10 @@ typedef struct _KEY_INDEX {
     JET_TABLEID     tblIntersection;            // the temp table used in the intersection
     JET_COLUMNID    columnidBookmark;           // the column id that identifies the bookmark in the intersect table
 
+    DWORD           *pDNTIntersection;          // the DNTs of an in memory intersection, ascending
+    ULONG           cDNTIntersection;           // number of DNTs in pDNTIntersection
+    ULONG           iDNTIntersection;           // current position in pDNTIntersection
+
     struct _KEY_INDEX *pNext;
 } KEY_INDEX;
 
@@ -981,6 +985,15 @@ DBGetEstimatedNCSizeEx(
     IN ULONG dntNC
     );
 
+VOID
+DBPrereadNCUsnRange(
+    IN DBPOS *pDB,
+    IN JET_TABLEID Cursor,
+    IN eIndexId indexid,
+    IN ULONG dntNC,
+    IN USN usnSeekStart
+    );
+
 
 typedef enum
 {
@@ -234,11 +234,15 @@ DsNormalizePathName(
 #define DRA_REPL_LATENCY_ERROR_INTERVAL "Replicator latency error interval (hours)"
 #define DRA_REPL_COMPRESSION_LEVEL "Replicator compression level"
 #define DRA_REPL_COMPRESSION_ALG "Replicator compression algorithm"
+#define DRA_OUTBOUND_OBJS_PER_SEC "Replicator outbound objects per second"
 
 #define DB_EXPENSIVE_SEARCH_THRESHOLD   "Expensive Search Results Threshold"
 #define DB_INEFFICIENT_SEARCH_THRESHOLD "Inefficient Search Results Threshold"
 #define DB_INTERSECT_THRESHOLD          "Intersect Threshold"
 #define DB_INTERSECT_RATIO              "Intersect Ratio"
+#define DB_INDEX_STATS_BUCKETS          "Index Statistics Buckets"
+#define DB_INTERSECT_MEMORY_BUDGET      "Intersect Memory Budget (KB)"
+#define DB_DNREAD_CACHE_BUDGET          "DN Read Cache Memory Budget (KB)"
 
 #define DRSRPC_BIND_TIMEOUT            "RPC Bind Timeout (mins)"
 #define DRSRPC_REPLICATION_TIMEOUT     "RPC Replication Timeout (mins)"
@@ -403,6 +407,8 @@ DsNormalizePathName(
 #define DEFAULT_DRA_REPL_LATENCY_CHECK_INTERVAL (1) //1 day
 #define DEFAULT_DRA_REPL_COMPRESSION_LEVEL      3
 #define DEFAULT_DRA_REPL_COMPRESSION_ALG        DRS_COMP_ALG_XPRESS
+#define DEFAULT_DRA_OUTBOUND_OBJS_PER_SEC       (0) // 0 = unlimited
+#define DRA_OUTBOUND_THROTTLE_MAX_WAIT          (5 * 1000) // in msecs
 #define DEFAULT_THREAD_STATE_HEAP_LIMIT         (100L * 1024L * 1024L)
 #define DRA_REPSTO_UPDATE_PERIOD                (60 * 60) //1 hour in seconds
 
@@ -442,6 +448,9 @@ DsNormalizePathName(
 #define DEFAULT_DB_INEFFICIENT_SEARCH_THRESHOLD 1000    // returned entries <= 10% of x visited entries
 #define DEFAULT_DB_INTERSECT_THRESHOLD          20
 #define DEFAULT_DB_INTERSECT_RATIO              100
+#define DEFAULT_DB_INDEX_STATS_BUCKETS          64      // 0 disables index statistics
+#define DEFAULT_DB_INTERSECT_MEMORY_BUDGET      4096    // KB, 0 disables in-memory intersection
+#define DEFAULT_DB_DNREAD_CACHE_BUDGET          512     // KB
 
 //
 // DEFAULT GCverify time intervals
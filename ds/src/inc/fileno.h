@@ -145,6 +145,8 @@
 #define FILENO_DBCONSTR         (DIRNO_DBLAYER + 14)    // dbconstr.c
 #define FILENO_DBLINK           (DIRNO_DBLAYER + 15)    // dblink.c
 #define FILENO_DBFILTER         (DIRNO_DBLAYER + 16)    // dbfilter.c
+#define FILENO_DBSTATS          (DIRNO_DBLAYER + 17)    // dbstats.c
+#define FILENO_DBBITMAP         (DIRNO_DBLAYER + 18)    // dbbitmap.c
 
 // drsserv directory
 #define FILENO_DRSUAPI          (DIRNO_DRS + 0)         // drsuapi.c
@@ -279,14 +279,40 @@ typedef struct _GLOBALDNREADCACHESLOT{
     DWORD                 dwHashKey;
 } GLOBALDNREADCACHESLOT;
 
+// The global dnread cache is immutable once it is placed in the anchor (other
+// than the valid bit of a slot), so the secondary indices below are read
+// without any lock.  Each index is an open addressed table of cIndexSlots
+// (a power of 2) entries holding a pData index + 1, 0 meaning an empty slot.
 typedef struct _GLOBALDNREADCACHE {
     DWORD refCount;
     DWORD count;
     GLOBALDNREADCACHESLOT *pData;
     DWORD sdHashTableSize;
     PSDCACHE_ENTRY *pSDHashTable;   // array of SDCACHE_ENTRY pointers
+    DWORD cIndexSlots;
+    DWORD *pGuidIndex;              // slots hashed by Guid
+    DWORD *pNameIndex;              // slots hashed by PDNT and RDN hash key
 } GLOBALDNREADCACHE;
 
+// A slot of the global dnread cache hit by this thread since its last commit
+// to transaction level 0, and how often.  A thread keeps a small open
+// addressed table of these rather than a counter per slot of the cache, so
+// that the work done at each commit doesn't grow with the size of the cache.
+// iSlot is the pData index + 1, 0 meaning an empty entry.
+#define GLOBAL_CACHE_HIT_SLOTS_BITS 7
+#define GLOBAL_CACHE_HIT_SLOTS      (1 << GLOBAL_CACHE_HIT_SLOTS_BITS)
+
+typedef struct _GLOBAL_CACHE_HIT {
+    DWORD iSlot;
+    DWORD count;
+} GLOBAL_CACHE_HIT;
+
+// Max number of DNTs a transaction remembers having invalidated in the global
+// dnread cache.  If a transaction invalidates more than this, committing it
+// throws away any global dnread cache built while it was open instead of
+// invalidating the same entries in that cache.
+#define DNREAD_MAX_INVALIDATED_DNTS 32
+
 /* Values for the "mark" field in the previous structure */
 #define DNREAD_NOMARK       0
 #define DNREAD_MARK         1
@@ -835,13 +861,21 @@ typedef struct _THSTATE {
     DWORD       spaceHolder;    // TO BE REUSED / REMOVED
 
     GLOBALDNREADCACHE *Global_DNReadCache;   // The LocalDNReadCache.
-    DWORD        cGlobalCacheHits;
-    DWORD        *pGlobalCacheHits; // Track hot objects in the Global Cache.
+    DWORD        cGlobalCacheHits;  // entries in use in pGlobalCacheHits
+    GLOBAL_CACHE_HIT *pGlobalCacheHits;
+                                // Track hot objects in the Global Cache,
+                                // GLOBAL_CACHE_HIT_SLOTS entries.
     DSTIME       DNReadOriginSequence;
                                 // When was the LocalDNReadCache last reset?
                                 // This tracks the invalidate sequence number
                                 // used by the global dnread cache.
     LOCALDNREADCACHE  LocalDNReadCache;
+    DWORD       cInvalidatedDNTs;
+                                // Number of DNTs invalidated in the dnread
+                                // cache by this transaction.  May exceed
+                                // DNREAD_MAX_INVALIDATED_DNTS, in which case
+                                // rgInvalidatedDNTs is incomplete.
+    DWORD       rgInvalidatedDNTs[DNREAD_MAX_INVALIDATED_DNTS];
 
     PVOID       TraceHeader;    // WMI trace header
     DWORD       ClientIP;       // IP address of LDAP client
@@ -42,6 +42,13 @@ you may need to stub them out also.
 #define TASKQ_DONT_RESCHEDULE   ( 0xFFFFFFFF )
 #define TASKQ_NOT_DAMPED        ( 0xFFFFFFFF )
 
+// Concurrency classes.  Tasks in the default class run one at a time on the
+// task scheduler thread, as they always have.  Each other class gets its own
+// worker thread, so a long-running task in one class does not hold up the
+// tasks in the others.  Tasks within a class still run one at a time.
+#define TASKQ_CLASS_DEFAULT     ( 0 )
+#define TASKQ_MAX_CLASSES       ( 4 )
+
 extern DWORD gTaskSchedulerTID;
 extern BOOL  gfIsTqRunning;
 
@@ -173,6 +180,36 @@ DoTriggerTaskSynchronously(
     PCHAR       pfnName         // function name
     );
 
+// Run the given task queue function in the given concurrency class from now
+// on, including any instances of it already queued and any triggered with
+// TriggerTaskSynchronously().  A task assigned to a class other than
+// TASKQ_CLASS_DEFAULT may run concurrently with tasks of other classes, so
+// only assign tasks that do their own locking.
+BOOL
+SetTaskQueueClass(
+    IN  PTASKQFN    pfnTaskQFn,
+    IN  DWORD       iClass
+    );
+
+// Run-time and lateness statistics of one task, by function name.
+typedef struct _TASKQ_STATS {
+    PCHAR       pfnName;
+    DWORD       iClass;         // class of the most recent run
+    DWORD       cRuns;
+    ULONGLONG   cMSecRunTotal;
+    DWORD       cMSecRunMax;
+    ULONGLONG   cMSecLateTotal; // time from scheduled to actual start
+    DWORD       cMSecLateMax;
+} TASKQ_STATS;
+
+// Copy out up to cStats entries of per-task statistics.  Returns the number
+// of entries copied.
+DWORD
+GetTaskQueueStats(
+    OUT TASKQ_STATS *   rgStats,
+    IN  DWORD           cStats
+    );
+
 // Return seconds since Jan 1, 1601.
 DSTIME
 GetSecondsSince1601( void );
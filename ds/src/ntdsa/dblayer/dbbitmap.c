@@ -0,0 +1,535 @@
+//+-------------------------------------------------------------------------
+//
+//  Microsoft Windows
+//
+//  Copyright (C) Microsoft Corporation, 1989 - 1999
+//
+//  File:       dbbitmap.c
+//
+//--------------------------------------------------------------------------
+
+/*++
+
+ABSTRACT:
+
+    Compressed DNT sets used to intersect index ranges in memory.
+
+DETAILS:
+
+    A DNT_BITMAP is a set of DNTs split on the upper 16 bits of the DNT into
+    containers, kept sorted by those upper bits.  A container that holds few
+    DNTs stores the lower 16 bits as a sorted array of USHORTs; once it holds
+    more than DNT_CONTAINER_ARRAY_MAX of them it is converted to a 64K bit
+    bitmap.  Dense ranges (e.g. objectCategory=person) therefore cost one bit
+    per possible DNT, sparse ranges two bytes per DNT, and intersecting two
+    dense containers is a loop of 64 bit ANDs.
+
+    All memory is allocated from the thread heap.  Every bitmap keeps count
+    of the bytes it has allocated so that callers can give up and fall back to
+    a jet temp table when a budget is exceeded.
+
+CREATED:
+
+REVISION HISTORY:
+
+--*/
+
+#include <NTDSpch.h>
+#pragma  hdrstop
+
+#include <dsjet.h>
+
+#include <ntdsa.h>
+#include <scache.h>
+#include <dbglobal.h>
+#include <mdglobal.h>
+#include <mdlocal.h>
+#include <dsatools.h>
+
+#include <dsexcept.h>
+#include "debug.h"  /* standard debugging header */
+#define DEBSUB "DBBITMAP:" /* define the subsystem for debugging */
+
+#include "dbintrnl.h"
+
+#include <fileno.h>
+#define  FILENO FILENO_DBBITMAP
+
+// Array containers are converted to bitmaps beyond this many entries, which
+// is the point at which the array (2 bytes per DNT) outgrows the bitmap.
+#define DNT_CONTAINER_ARRAY_MAX     4096
+#define DNT_CONTAINER_QWORDS        (65536 / 64)
+#define DNT_CONTAINER_CB_BITMAP     (DNT_CONTAINER_QWORDS * sizeof(ULONGLONG))
+
+#define DNT_HIGH(dnt)   ((USHORT)((dnt) >> 16))
+#define DNT_LOW(dnt)    ((USHORT)((dnt) & 0xFFFF))
+
+typedef struct _DNT_CONTAINER {
+    USHORT      usHigh;         // upper 16 bits of every DNT in the container
+    BOOL        fBitmap;        // rgqwBits is valid, else rgusLow
+    ULONG       cDNTs;          // number of DNTs in the container
+    ULONG       cAlloc;         // USHORTs allocated in rgusLow
+    union {
+        USHORT    *rgusLow;     // sorted lower 16 bits
+        ULONGLONG *rgqwBits;    // one bit per lower 16 bits value
+    };
+} DNT_CONTAINER;
+
+struct _DNT_BITMAP {
+    ULONG           cContainers;
+    ULONG           cAlloc;
+    DNT_CONTAINER  *rgContainers;   // sorted by usHigh
+    ULONG           cbUsed;         // bytes allocated on behalf of this set
+};
+
+
+ULONG
+dbBitmapPopCount(
+    IN ULONGLONG qw
+    )
+{
+    qw = qw - ((qw >> 1) & 0x5555555555555555);
+    qw = (qw & 0x3333333333333333) + ((qw >> 2) & 0x3333333333333333);
+    qw = (qw + (qw >> 4)) & 0x0F0F0F0F0F0F0F0F;
+    return (ULONG)((qw * 0x0101010101010101) >> 56);
+}
+
+DNT_BITMAP *
+dbBitmapCreate(
+    IN THSTATE *pTHS
+    )
+{
+    DNT_BITMAP *pBitmap;
+
+    pBitmap = THAllocEx(pTHS, sizeof(DNT_BITMAP));
+    pBitmap->cbUsed = sizeof(DNT_BITMAP);
+
+    return pBitmap;
+}
+
+void
+dbBitmapFree(
+    IN THSTATE    *pTHS,
+    IN DNT_BITMAP *pBitmap
+    )
+{
+    ULONG i;
+
+    if (!pBitmap) {
+        return;
+    }
+
+    for (i = 0; i < pBitmap->cContainers; i++) {
+        // rgusLow and rgqwBits share storage
+        THFreeEx(pTHS, pBitmap->rgContainers[i].rgusLow);
+    }
+    if (pBitmap->rgContainers) {
+        THFreeEx(pTHS, pBitmap->rgContainers);
+    }
+    THFreeEx(pTHS, pBitmap);
+}
+
+ULONG
+dbBitmapSize(
+    IN DNT_BITMAP *pBitmap
+    )
+/*++
+
+Routine Description:
+
+    Return the number of bytes allocated on behalf of the set.
+
+--*/
+{
+    return pBitmap->cbUsed;
+}
+
+DNT_CONTAINER *
+dbBitmapFindContainer(
+    IN  DNT_BITMAP *pBitmap,
+    IN  USHORT      usHigh,
+    OUT ULONG      *piContainer
+    )
+/*++
+
+Routine Description:
+
+    Binary search the containers for usHigh.
+
+Return Values:
+
+    The container, or NULL with *piContainer set to the position at which it
+    would have to be inserted.
+
+--*/
+{
+    ULONG lo = 0, hi = pBitmap->cContainers;
+
+    while (lo < hi) {
+        ULONG mid = (lo + hi) / 2;
+        if (pBitmap->rgContainers[mid].usHigh < usHigh) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    *piContainer = lo;
+    if (lo < pBitmap->cContainers && pBitmap->rgContainers[lo].usHigh == usHigh) {
+        return &pBitmap->rgContainers[lo];
+    }
+    return NULL;
+}
+
+BOOL
+dbBitmapHasContainer(
+    IN DNT_BITMAP *pBitmap,
+    IN DWORD       DNT
+    )
+/*++
+
+Routine Description:
+
+    Tell whether the set could possibly hold DNT, i.e. whether it holds any
+    DNT with the same upper 16 bits.  Used to keep the sets built for the
+    larger ranges of an intersection no bigger than the running result.
+
+--*/
+{
+    ULONG i;
+
+    return (NULL != dbBitmapFindContainer(pBitmap, DNT_HIGH(DNT), &i));
+}
+
+void
+dbBitmapConvertToBitmap(
+    IN THSTATE       *pTHS,
+    IN DNT_BITMAP    *pBitmap,
+    IN DNT_CONTAINER *pContainer
+    )
+{
+    ULONGLONG *rgqwBits;
+    ULONG      i;
+
+    Assert(!pContainer->fBitmap);
+
+    rgqwBits = THAllocEx(pTHS, DNT_CONTAINER_CB_BITMAP);
+    for (i = 0; i < pContainer->cDNTs; i++) {
+        USHORT us = pContainer->rgusLow[i];
+        rgqwBits[us >> 6] |= ((ULONGLONG)1) << (us & 63);
+    }
+
+    pBitmap->cbUsed -= pContainer->cAlloc * sizeof(USHORT);
+    pBitmap->cbUsed += DNT_CONTAINER_CB_BITMAP;
+
+    THFreeEx(pTHS, pContainer->rgusLow);
+    pContainer->rgqwBits = rgqwBits;
+    pContainer->fBitmap = TRUE;
+    pContainer->cAlloc = 0;
+}
+
+void
+dbBitmapAdd(
+    IN THSTATE    *pTHS,
+    IN DNT_BITMAP *pBitmap,
+    IN DWORD       DNT
+    )
+/*++
+
+Routine Description:
+
+    Add a DNT to the set.  Adding a DNT that is already present is a no-op,
+    which is what makes walking a multi-valued index range safe.
+
+--*/
+{
+    DNT_CONTAINER *pContainer;
+    ULONG          iContainer;
+    USHORT         usLow = DNT_LOW(DNT);
+    ULONG          lo, hi;
+
+    pContainer = dbBitmapFindContainer(pBitmap, DNT_HIGH(DNT), &iContainer);
+
+    if (!pContainer) {
+        if (pBitmap->cContainers == pBitmap->cAlloc) {
+            ULONG cAlloc = pBitmap->cAlloc ? pBitmap->cAlloc * 2 : 8;
+
+            if (pBitmap->rgContainers) {
+                pBitmap->rgContainers = THReAllocEx(pTHS,
+                                                    pBitmap->rgContainers,
+                                                    cAlloc * sizeof(DNT_CONTAINER));
+            } else {
+                pBitmap->rgContainers = THAllocEx(pTHS, cAlloc * sizeof(DNT_CONTAINER));
+            }
+            pBitmap->cbUsed += (cAlloc - pBitmap->cAlloc) * sizeof(DNT_CONTAINER);
+            pBitmap->cAlloc = cAlloc;
+        }
+
+        memmove(&pBitmap->rgContainers[iContainer + 1],
+                &pBitmap->rgContainers[iContainer],
+                (pBitmap->cContainers - iContainer) * sizeof(DNT_CONTAINER));
+        pBitmap->cContainers++;
+
+        pContainer = &pBitmap->rgContainers[iContainer];
+        memset(pContainer, 0, sizeof(DNT_CONTAINER));
+        pContainer->usHigh = DNT_HIGH(DNT);
+        pContainer->cAlloc = 4;
+        pContainer->rgusLow = THAllocEx(pTHS, pContainer->cAlloc * sizeof(USHORT));
+        pBitmap->cbUsed += pContainer->cAlloc * sizeof(USHORT);
+    }
+
+    if (pContainer->fBitmap) {
+        ULONGLONG qwBit = ((ULONGLONG)1) << (usLow & 63);
+
+        if (!(pContainer->rgqwBits[usLow >> 6] & qwBit)) {
+            pContainer->rgqwBits[usLow >> 6] |= qwBit;
+            pContainer->cDNTs++;
+        }
+        return;
+    }
+
+    // Index ranges often hand us DNTs in ascending order, so check the end of
+    // the array before searching it.
+    if (pContainer->cDNTs && pContainer->rgusLow[pContainer->cDNTs - 1] < usLow) {
+        lo = pContainer->cDNTs;
+    }
+    else {
+        lo = 0;
+        hi = pContainer->cDNTs;
+        while (lo < hi) {
+            ULONG mid = (lo + hi) / 2;
+            if (pContainer->rgusLow[mid] < usLow) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        if (lo < pContainer->cDNTs && pContainer->rgusLow[lo] == usLow) {
+            return;
+        }
+    }
+
+    if (pContainer->cDNTs == DNT_CONTAINER_ARRAY_MAX) {
+        dbBitmapConvertToBitmap(pTHS, pBitmap, pContainer);
+        pContainer->rgqwBits[usLow >> 6] |= ((ULONGLONG)1) << (usLow & 63);
+        pContainer->cDNTs++;
+        return;
+    }
+
+    if (pContainer->cDNTs == pContainer->cAlloc) {
+        ULONG cAlloc = min(pContainer->cAlloc * 2, DNT_CONTAINER_ARRAY_MAX);
+
+        pContainer->rgusLow = THReAllocEx(pTHS, pContainer->rgusLow, cAlloc * sizeof(USHORT));
+        pBitmap->cbUsed += (cAlloc - pContainer->cAlloc) * sizeof(USHORT);
+        pContainer->cAlloc = cAlloc;
+    }
+
+    memmove(&pContainer->rgusLow[lo + 1],
+            &pContainer->rgusLow[lo],
+            (pContainer->cDNTs - lo) * sizeof(USHORT));
+    pContainer->rgusLow[lo] = usLow;
+    pContainer->cDNTs++;
+}
+
+ULONG
+dbBitmapIntersectContainers(
+    IN THSTATE       *pTHS,
+    IN DNT_BITMAP    *pBitmap,
+    IN DNT_CONTAINER *pDst,
+    IN DNT_CONTAINER *pSrc
+    )
+/*++
+
+Routine Description:
+
+    Replace the contents of pDst with the intersection of pDst and pSrc.
+
+Return Values:
+
+    The number of DNTs left in pDst.
+
+--*/
+{
+    ULONG i, j, c;
+
+    if (pDst->fBitmap && pSrc->fBitmap) {
+        for (i = 0, c = 0; i < DNT_CONTAINER_QWORDS; i++) {
+            pDst->rgqwBits[i] &= pSrc->rgqwBits[i];
+            c += dbBitmapPopCount(pDst->rgqwBits[i]);
+        }
+        pDst->cDNTs = c;
+
+        if (c && c <= DNT_CONTAINER_ARRAY_MAX) {
+            // shrink back to an array
+            USHORT *rgusLow = THAllocEx(pTHS, c * sizeof(USHORT));
+
+            for (i = 0, j = 0; i < DNT_CONTAINER_QWORDS; i++) {
+                ULONGLONG qw = pDst->rgqwBits[i];
+                while (qw) {
+                    ULONG iBit = 0;
+                    while (!(qw & (((ULONGLONG)1) << iBit))) {
+                        iBit++;
+                    }
+                    rgusLow[j++] = (USHORT)(i * 64 + iBit);
+                    qw &= qw - 1;
+                }
+            }
+            Assert(j == c);
+
+            THFreeEx(pTHS, pDst->rgqwBits);
+            pBitmap->cbUsed -= DNT_CONTAINER_CB_BITMAP;
+            pBitmap->cbUsed += c * sizeof(USHORT);
+            pDst->rgusLow = rgusLow;
+            pDst->fBitmap = FALSE;
+            pDst->cAlloc = c;
+        }
+    }
+    else if (pDst->fBitmap) {
+        // array into bitmap; the result fits in an array
+        USHORT *rgusLow = THAllocEx(pTHS, max(1, pSrc->cDNTs) * sizeof(USHORT));
+
+        for (i = 0, c = 0; i < pSrc->cDNTs; i++) {
+            USHORT us = pSrc->rgusLow[i];
+            if (pDst->rgqwBits[us >> 6] & (((ULONGLONG)1) << (us & 63))) {
+                rgusLow[c++] = us;
+            }
+        }
+
+        THFreeEx(pTHS, pDst->rgqwBits);
+        pBitmap->cbUsed -= DNT_CONTAINER_CB_BITMAP;
+        pBitmap->cbUsed += max(1, pSrc->cDNTs) * sizeof(USHORT);
+        pDst->rgusLow = rgusLow;
+        pDst->fBitmap = FALSE;
+        pDst->cAlloc = max(1, pSrc->cDNTs);
+        pDst->cDNTs = c;
+    }
+    else if (pSrc->fBitmap) {
+        // filter the array in place
+        for (i = 0, c = 0; i < pDst->cDNTs; i++) {
+            USHORT us = pDst->rgusLow[i];
+            if (pSrc->rgqwBits[us >> 6] & (((ULONGLONG)1) << (us & 63))) {
+                pDst->rgusLow[c++] = us;
+            }
+        }
+        pDst->cDNTs = c;
+    }
+    else {
+        // merge two sorted arrays in place
+        for (i = 0, j = 0, c = 0; i < pDst->cDNTs && j < pSrc->cDNTs; ) {
+            if (pDst->rgusLow[i] < pSrc->rgusLow[j]) {
+                i++;
+            } else if (pDst->rgusLow[i] > pSrc->rgusLow[j]) {
+                j++;
+            } else {
+                pDst->rgusLow[c++] = pDst->rgusLow[i];
+                i++;
+                j++;
+            }
+        }
+        pDst->cDNTs = c;
+    }
+
+    return pDst->cDNTs;
+}
+
+void
+dbBitmapIntersect(
+    IN THSTATE    *pTHS,
+    IN DNT_BITMAP *pDst,
+    IN DNT_BITMAP *pSrc
+    )
+/*++
+
+Routine Description:
+
+    Replace the contents of pDst with the intersection of pDst and pSrc.
+    Containers whose upper 16 bits appear in only one of the sets are dropped
+    without looking at their contents.
+
+--*/
+{
+    ULONG iDst, iSrc, cKeep = 0;
+
+    for (iDst = 0, iSrc = 0; iDst < pDst->cContainers; iDst++) {
+        DNT_CONTAINER *pContainer = &pDst->rgContainers[iDst];
+
+        while (iSrc < pSrc->cContainers
+               && pSrc->rgContainers[iSrc].usHigh < pContainer->usHigh) {
+            iSrc++;
+        }
+
+        if (iSrc < pSrc->cContainers
+            && pSrc->rgContainers[iSrc].usHigh == pContainer->usHigh
+            && dbBitmapIntersectContainers(pTHS, pDst, pContainer,
+                                           &pSrc->rgContainers[iSrc])) {
+            pDst->rgContainers[cKeep++] = *pContainer;
+        }
+        else {
+            pDst->cbUsed -= pContainer->fBitmap ? DNT_CONTAINER_CB_BITMAP
+                                                : pContainer->cAlloc * sizeof(USHORT);
+            THFreeEx(pTHS, pContainer->rgusLow);
+        }
+    }
+
+    pDst->cContainers = cKeep;
+}
+
+ULONG
+dbBitmapCount(
+    IN DNT_BITMAP *pBitmap
+    )
+{
+    ULONG i, c = 0;
+
+    for (i = 0; i < pBitmap->cContainers; i++) {
+        c += pBitmap->rgContainers[i].cDNTs;
+    }
+
+    return c;
+}
+
+ULONG
+dbBitmapToArray(
+    IN  DNT_BITMAP *pBitmap,
+    OUT DWORD      *pDNTs
+    )
+/*++
+
+Routine Description:
+
+    Copy the DNTs in the set to pDNTs in ascending order.  pDNTs must be big
+    enough to hold dbBitmapCount(pBitmap) DNTs.
+
+Return Values:
+
+    The number of DNTs copied.
+
+--*/
+{
+    ULONG i, j, c = 0;
+
+    for (i = 0; i < pBitmap->cContainers; i++) {
+        DNT_CONTAINER *pContainer = &pBitmap->rgContainers[i];
+        DWORD          dwHigh = ((DWORD)pContainer->usHigh) << 16;
+
+        if (pContainer->fBitmap) {
+            for (j = 0; j < DNT_CONTAINER_QWORDS; j++) {
+                ULONGLONG qw = pContainer->rgqwBits[j];
+                ULONG     iBit;
+
+                for (iBit = 0; qw; iBit++, qw >>= 1) {
+                    if (qw & 1) {
+                        pDNTs[c++] = dwHigh | (j * 64 + iBit);
+                    }
+                }
+            }
+        }
+        else {
+            for (j = 0; j < pContainer->cDNTs; j++) {
+                pDNTs[c++] = dwHigh | pContainer->rgusLow[j];
+            }
+        }
+    }
+
+    return c;
+}
@@ -147,6 +147,131 @@ const DWORD      DNReadOriginSequenceUninit = 0;
 const DWORD      DNReadOriginSequenceInvalid = 2;
 volatile DWORD   gDNReadLastInvalidateSequence = 1;
 
+// Memory budget, in bytes, for the global dnread cache.  The number of DNTs we
+// try to keep in the global list is derived from it using an estimated size
+// per slot; ReloadDNReadCache enforces it using the actual sizes.
+ULONG gulDNReadCacheBudget = DEFAULT_DB_DNREAD_CACHE_BUDGET * 1024;
+#define DNREAD_EST_SLOT_SIZE    256
+#define DNREAD_MAX_GLOBAL_DNTS  (64 * 1024)
+
+// Count-min sketch of how often DNTs show up in registered hot lists.  This is
+// what decides which DNTs are admitted to (and kept in) the global list, the
+// way TinyLFU does: a DNT displaces one already in the list only if it has been
+// hot more often recently.  The counters saturate, and are all halved every
+// DNREAD_SKETCH_AGE_PERIOD additions so that old popularity fades.
+//
+// NOTE, we use ++ instead of interlocked on the counters, like the debug
+// counters above.  Losing the occasional increment only makes the estimate a
+// little lower.
+#define DNREAD_SKETCH_DEPTH         4
+#define DNREAD_SKETCH_WIDTH_BITS    12
+#define DNREAD_SKETCH_WIDTH         (1 << DNREAD_SKETCH_WIDTH_BITS)
+#define DNREAD_SKETCH_AGE_PERIOD    (8 * DNREAD_SKETCH_WIDTH)
+#define DNREAD_SKETCH_SLOT(DNT, k)  \
+    (((DWORD)((DNT) + 1) * grgDNReadSketchSeed[k]) >> (32 - DNREAD_SKETCH_WIDTH_BITS))
+
+const DWORD grgDNReadSketchSeed[DNREAD_SKETCH_DEPTH] = {
+    0x9E3779B1, 0x85EBCA77, 0xC2B2AE3D, 0x27D4EB2F
+};
+BYTE          grgDNReadSketch[DNREAD_SKETCH_DEPTH][DNREAD_SKETCH_WIDTH];
+LONG          gcDNReadSketchAdds = 0;
+
+VOID
+dnSketchAdd (
+        DWORD DNT
+        )
+{
+    DWORD i, k;
+    BYTE *pb;
+
+    for(k=0;k<DNREAD_SKETCH_DEPTH;k++) {
+        pb = &grgDNReadSketch[k][DNREAD_SKETCH_SLOT(DNT, k)];
+        if(*pb != 0xFF) {
+            (*pb)++;
+        }
+    }
+
+    if(InterlockedIncrement(&gcDNReadSketchAdds) == DNREAD_SKETCH_AGE_PERIOD) {
+        // We're the one thread that crossed the period.  Age the sketch.
+        for(k=0;k<DNREAD_SKETCH_DEPTH;k++) {
+            for(i=0;i<DNREAD_SKETCH_WIDTH;i++) {
+                grgDNReadSketch[k][i] >>= 1;
+            }
+        }
+        InterlockedExchange(&gcDNReadSketchAdds, 0);
+    }
+}
+
+DWORD
+dnSketchEstimate (
+        DWORD DNT
+        )
+{
+    DWORD k, est = 0xFF;
+    BYTE b;
+
+    for(k=0;k<DNREAD_SKETCH_DEPTH;k++) {
+        b = grgDNReadSketch[k][DNREAD_SKETCH_SLOT(DNT, k)];
+        if(b < est) {
+            est = b;
+        }
+    }
+
+    return est;
+}
+
+DWORD
+dnMaxGlobalDNTs (
+        )
+{
+    DWORD cMax = gulDNReadCacheBudget / DNREAD_EST_SLOT_SIZE;
+
+    if(cMax < MAX_GLOBAL_DNTS) {
+        return MAX_GLOBAL_DNTS;
+    }
+
+    return min(cMax, DNREAD_MAX_GLOBAL_DNTS);
+}
+
+// A DNT competing for a place in the global list.
+typedef struct _DNT_CANDIDATE {
+    DWORD DNT;
+    DWORD freq;         // sketch estimate
+    BOOL  fResident;    // already in the global list
+} DNT_CANDIDATE;
+
+int __cdecl
+dnCompareCandidateFreq (
+        const void *p1,
+        const void *p2
+        )
+{
+    const DNT_CANDIDATE *pc1 = p1;
+    const DNT_CANDIDATE *pc2 = p2;
+
+    // Hottest first.  On a tie, the resident DNT wins so that the list doesn't
+    // churn.
+    if(pc1->freq != pc2->freq) {
+        return (pc1->freq > pc2->freq) ? -1 : 1;
+    }
+    if(pc1->fResident != pc2->fResident) {
+        return pc1->fResident ? -1 : 1;
+    }
+    return (pc1->DNT < pc2->DNT) ? -1 : (pc1->DNT > pc2->DNT);
+}
+
+int __cdecl
+dnCompareCandidateDNT (
+        const void *p1,
+        const void *p2
+        )
+{
+    const DNT_CANDIDATE *pc1 = p1;
+    const DNT_CANDIDATE *pc2 = p2;
+
+    return (pc1->DNT < pc2->DNT) ? -1 : (pc1->DNT > pc2->DNT);
+}
+
 
 BOOL
 dnAggregateInfo(
@@ -447,11 +572,10 @@ dnRegisterHotList (
 
   If the level 2 hot list is full, the routine aggregates the info in that list
   and then puts the resulting list of DNTs in place as the global list of DNTs
-  that should be in the global portion of the dnread cache.  If aggregating the
-  info from the level 2 list results in fewer DNTs than we are willing to cache,
-  DNTs from the global DNT cache list are added to the newly created one.  Since
-  the lists are kept ordered by DNTs, lower DNTs are more likely to be
-  transferred from the old list to the new than higher DNTs are.
+  that should be in the global portion of the dnread cache.  The DNTs from
+  aggregating the level 2 list compete with the DNTs already in the global DNT
+  cache list for the dnMaxGlobalDNTs() places in the new one, based on how often
+  each DNT has recently shown up in hot lists (see dnSketchAdd).
 
   After the new list is put in place (a global pointer), a task queue event is
   placed to ask for a recalculation of the global portion of the dnread cache.
@@ -474,7 +598,8 @@ dnRegisterHotList (
     DWORD i, Size, StaleCount=0;
     DNT_HOT_LIST *pThisElement, *pTemp;
     ULONG dtickRebuild,cRegisterHotListSkip;
-    DWORD *pDNTs = NULL;
+    DNT_CANDIDATE *pCandidates = NULL;
+    DWORD cCandidates, cMaxDNTs;
     size_t iProc;
 
     Assert(DsaIsRunning());
@@ -484,6 +609,11 @@ dnRegisterHotList (
         return;
     }
 
+    // Each hot list is a sample of what one transaction used most.
+    for(i=0;i<localCount;i++) {
+        dnSketchAdd(DNTs[i].DNT);
+    }
+
     // Build a malloced element for the level 1 hot list.
     pThisElement = malloc(sizeof(DNT_HOT_LIST));
     if(!pThisElement) {
@@ -638,98 +768,86 @@ dnRegisterHotList (
         }
     }
 #endif
-    if(!dnAggregateInfo( pThisElement, MAX_GLOBAL_DNTS, &pTemp)) {
+    if(!dnAggregateInfo( pThisElement, dnMaxGlobalDNTs(), &pTemp)) {
         // Something failed in the aggregation.  Bail.  dnAggregate freed the
         // list we passed in.
         return;
     }
 
     pThisElement = pTemp;
-    Size = pThisElement->cData;
 
-    // OK, we now have aggregated the data.  It's sorted by DNT.
-    // Prepare a new global DNT list.
+    // OK, we now have aggregated the data.  It's sorted by DNT.  Merge it with
+    // the current global DNT list (also sorted by DNT) into a list of
+    // candidates, then keep the most frequently hot ones.
     // NOTE!!! the global DNT list MUST remain sorted by DNT.
-    pNewDNReadCacheDNTs = malloc(MAX_GLOBAL_DNTS * sizeof(DWORD));
-    if(!pNewDNReadCacheDNTs) {
-        free(pTemp->pData);
-        pTemp->pData = NULL;
-        free(pTemp);
-        pTemp = NULL;
-        //
-        return;
+    EnterCriticalSection(&csDNReadGlobalCache);
+    __try {
+        DWORD iHot = 0, iOld = 0;
+
+        cCandidates = pThisElement->cData + cGlobalDNTReadCacheDNTs;
+        pCandidates = malloc(cCandidates * sizeof(DNT_CANDIDATE));
+        if(pCandidates) {
+            Size = 0;
+            while(iHot < pThisElement->cData || iOld < cGlobalDNTReadCacheDNTs) {
+                if(iOld == cGlobalDNTReadCacheDNTs ||
+                   (iHot < pThisElement->cData &&
+                    pThisElement->pData[iHot].DNT < pGlobalDNReadCacheDNTs[iOld])) {
+                    pCandidates[Size].DNT = pThisElement->pData[iHot++].DNT;
+                    pCandidates[Size].fResident = FALSE;
+                }
+                else {
+                    if(iHot < pThisElement->cData &&
+                       pThisElement->pData[iHot].DNT == pGlobalDNReadCacheDNTs[iOld]) {
+                        iHot++;
+                    }
+                    pCandidates[Size].DNT = pGlobalDNReadCacheDNTs[iOld++];
+                    pCandidates[Size].fResident = TRUE;
+                }
+                Size++;
+            }
+            cCandidates = Size;
+        }
     }
-
-    for(i=0;i<Size;i++) {
-        pNewDNReadCacheDNTs[i] = pThisElement->pData[i].DNT;
+    __finally {
+        LeaveCriticalSection(&csDNReadGlobalCache);
     }
 
     free(pThisElement->pData);
     free(pThisElement);
 
-    // Next, if we don't have enought DNTs in the list, get enough from the
-    // current list to get to MAX_GLOBAL_DNTS.
-    if(Size < MAX_GLOBAL_DNTS) {
-        // Yep, we don't have enough.  Steal some from the current global DNT
-        // list.  Remember that that list is protected by a critical section.
-        EnterCriticalSection(&csDNReadGlobalCache);
-        __try {
-            DWORD begin, end, middle;
-            BOOL bFound;
-
-            i=0;
-            while((i<cGlobalDNTReadCacheDNTs) && (Size < MAX_GLOBAL_DNTS)) {
-                begin = 0;
-                end = Size;
-                middle = (begin + end) / 2;
-                bFound = TRUE;
-                while(bFound && (pNewDNReadCacheDNTs[middle] !=
-                                 pGlobalDNReadCacheDNTs[i])) {
-                    if(pNewDNReadCacheDNTs[middle] >
-                       pGlobalDNReadCacheDNTs[i]) {
-                        end = middle;
-                    }
-                    else {
-                        begin = middle;
-                    }
-                    if(middle == (begin + end) / 2) {
-                        bFound = FALSE;
-                        if(pNewDNReadCacheDNTs[middle] <
-                           pGlobalDNReadCacheDNTs[i]) {
-                            middle++;
-                        }
-                    }
-                    else {
-                        middle = (begin + end)/2;
-                    }
-                }
-                if(!bFound) {
-                    // Insert this.
-                    if(middle < Size) {
-                        memmove(&pNewDNReadCacheDNTs[middle + 1],
-                                &pNewDNReadCacheDNTs[middle],
-                                (Size - middle) * sizeof(DWORD));
-                    }
-                    StaleCount++;
-                    Size++;
-                    pNewDNReadCacheDNTs[middle] = pGlobalDNReadCacheDNTs[i];
-                }
-                i++;
-            }
-        }
-        __finally {
-            LeaveCriticalSection(&csDNReadGlobalCache);
-        }
+    if(!pCandidates) {
+        return;
+    }
 
-        pDNTs = realloc(pNewDNReadCacheDNTs, Size * sizeof(DWORD));
-        if (!pDNTs) {
-            free(pNewDNReadCacheDNTs);
-            return;
+    for(i=0;i<cCandidates;i++) {
+        pCandidates[i].freq = dnSketchEstimate(pCandidates[i].DNT);
+    }
+
+    cMaxDNTs = dnMaxGlobalDNTs();
+    if(cCandidates > cMaxDNTs) {
+        qsort(pCandidates, cCandidates, sizeof(DNT_CANDIDATE),
+              dnCompareCandidateFreq);
+        cCandidates = cMaxDNTs;
+        qsort(pCandidates, cCandidates, sizeof(DNT_CANDIDATE),
+              dnCompareCandidateDNT);
+    }
+
+    Size = cCandidates;
+    pNewDNReadCacheDNTs = malloc(Size * sizeof(DWORD));
+    if(!pNewDNReadCacheDNTs) {
+        free(pCandidates);
+        return;
+    }
+
+    for(i=0;i<Size;i++) {
+        pNewDNReadCacheDNTs[i] = pCandidates[i].DNT;
+        if(pCandidates[i].fResident) {
+            StaleCount++;
         }
-        pNewDNReadCacheDNTs = pDNTs;
     }
+    free(pCandidates);
 
-    DPRINT2(4,"New cache list has %d hot items, %d stale items.\n",
+    DPRINT2(4,"New cache list has %d new items, %d resident items.\n",
             Size - StaleCount, StaleCount);
 
 
@@ -847,6 +965,287 @@ dbResetLocalDNReadCache (
     pTHS->DNReadOriginSequence = SequenceNumber;
 }
 
+// Returned by the dnGlobalCacheFind* routines when no slot matches.
+#define DNREAD_NOT_FOUND ((DWORD)-1)
+
+__inline DWORD
+dnGuidIndexHash (
+        GUID *pGuid
+        )
+{
+    DWORD *pdw = (DWORD *)pGuid;
+    DWORD dwHash = pdw[0] ^ pdw[1] ^ pdw[2] ^ pdw[3];
+
+    return dwHash ^ (dwHash >> 16);
+}
+
+__inline DWORD
+dnNameIndexHash (
+        DWORD PDNT,
+        DWORD dwHashKey
+        )
+{
+    DWORD dwHash = (PDNT * 0x9E3779B1) ^ dwHashKey;
+
+    return dwHash ^ (dwHash >> 16);
+}
+
+VOID
+dnFreeGlobalCacheIndices (
+        GLOBALDNREADCACHE *pCache
+        )
+{
+    if(pCache->pGuidIndex) {
+        free(pCache->pGuidIndex);
+        pCache->pGuidIndex = NULL;
+    }
+    if(pCache->pNameIndex) {
+        free(pCache->pNameIndex);
+        pCache->pNameIndex = NULL;
+    }
+    pCache->cIndexSlots = 0;
+}
+
+VOID
+dnBuildGlobalCacheIndices (
+        GLOBALDNREADCACHE *pCache
+        )
+/*++
+  Description:
+      Build the Guid and PDNT/RDN indices over a newly built global dnread
+      cache, before it is placed in the anchor.  The indices are never changed
+      after that, so lookups through them need no locks.  If we can't allocate
+      the indices, lookups fall back to scanning pData.
+
+      Slots are inserted in pData order, so a probe finds the lowest slot with
+      a given key first, just as a linear scan of pData would.
+--*/
+{
+    DWORD cSlots;
+    DWORD i, j, mask;
+
+    Assert(!pCache->pGuidIndex && !pCache->pNameIndex);
+
+    if(!pCache->count) {
+        return;
+    }
+
+    // Keep the tables at most half full.
+    for(cSlots = 16; cSlots < 2 * pCache->count; cSlots <<= 1)
+        ;
+
+    pCache->pGuidIndex = malloc(cSlots * sizeof(DWORD));
+    pCache->pNameIndex = malloc(cSlots * sizeof(DWORD));
+    if(!pCache->pGuidIndex || !pCache->pNameIndex) {
+        dnFreeGlobalCacheIndices(pCache);
+        return;
+    }
+    memset(pCache->pGuidIndex, 0, cSlots * sizeof(DWORD));
+    memset(pCache->pNameIndex, 0, cSlots * sizeof(DWORD));
+    pCache->cIndexSlots = cSlots;
+    mask = cSlots - 1;
+
+    for(i=0;i<pCache->count;i++) {
+        j = dnGuidIndexHash(&pCache->pData[i].name.Guid) & mask;
+        while(pCache->pGuidIndex[j]) {
+            j = (j + 1) & mask;
+        }
+        pCache->pGuidIndex[j] = i + 1;
+
+        j = dnNameIndexHash(pCache->pData[i].name.tag.PDNT,
+                            pCache->pData[i].dwHashKey) & mask;
+        while(pCache->pNameIndex[j]) {
+            j = (j + 1) & mask;
+        }
+        pCache->pNameIndex[j] = i + 1;
+    }
+}
+
+VOID
+dnGlobalCacheNoteHit (
+        THSTATE *pTHS,
+        DWORD i
+        )
+/*++
+  Description:
+      Count a hit on slot i of this thread's global dnread cache.  The hit
+      table is small and only probed a few entries deep; a hit that doesn't
+      find room is dropped, which can only make a slot look a little colder.
+--*/
+{
+    GLOBAL_CACHE_HIT *pHit;
+    DWORD j, k;
+
+    if(!pTHS->pGlobalCacheHits) {
+        return;
+    }
+
+    j = ((i + 1) * 0x9E3779B1) >> (32 - GLOBAL_CACHE_HIT_SLOTS_BITS);
+    for(k=0;k<8;k++) {
+        pHit = &pTHS->pGlobalCacheHits[(j + k) & (GLOBAL_CACHE_HIT_SLOTS - 1)];
+        if(pHit->iSlot == i + 1) {
+            pHit->count++;
+            return;
+        }
+        if(!pHit->iSlot) {
+            pHit->iSlot = i + 1;
+            pHit->count = 1;
+            pTHS->cGlobalCacheHits++;
+            return;
+        }
+    }
+}
+
+VOID
+dnGlobalCacheResetHits (
+        THSTATE *pTHS
+        )
+{
+    if(pTHS->cGlobalCacheHits) {
+        memset(pTHS->pGlobalCacheHits, 0,
+               GLOBAL_CACHE_HIT_SLOTS * sizeof(GLOBAL_CACHE_HIT));
+        pTHS->cGlobalCacheHits = 0;
+    }
+}
+
+DWORD
+dnGlobalCacheFindDNT (
+        GLOBALDNREADCACHE *pCache,
+        DWORD DNT
+        )
+/*++
+  Description:
+      Find the slot for DNT in a global dnread cache.  pData is sorted by DNT,
+      so use a binary search.
+
+  Return values:
+      The index of the slot in pData, or DNREAD_NOT_FOUND.
+--*/
+{
+    DWORD begin = 0, end = pCache->count, middle;
+
+    while(begin < end) {
+        middle = (begin + end) / 2;
+        if(pCache->pData[middle].name.DNT == DNT) {
+            return middle;
+        }
+        if(pCache->pData[middle].name.DNT > DNT) {
+            end = middle;
+        }
+        else {
+            begin = middle + 1;
+        }
+    }
+
+    return DNREAD_NOT_FOUND;
+}
+
+DWORD
+dnGlobalCacheFindGuid (
+        GLOBALDNREADCACHE *pCache,
+        GUID *pGuid
+        )
+/*++
+  Description:
+      Find the first slot with the given guid in a global dnread cache.
+
+  Return values:
+      The index of the slot in pData, or DNREAD_NOT_FOUND.
+--*/
+{
+    GLOBALDNREADCACHESLOT *pData = pCache->pData;
+    DWORD i, j, mask;
+
+    if(!pCache->pGuidIndex) {
+        for(i=0;i<pCache->count;i++) {
+            if(!memcmp(pGuid, &pData[i].name.Guid, sizeof(GUID))) {
+                return i;
+            }
+        }
+        return DNREAD_NOT_FOUND;
+    }
+
+    mask = pCache->cIndexSlots - 1;
+    for(j = dnGuidIndexHash(pGuid) & mask;
+        pCache->pGuidIndex[j];
+        j = (j + 1) & mask) {
+        i = pCache->pGuidIndex[j] - 1;
+        if(!memcmp(pGuid, &pData[i].name.Guid, sizeof(GUID))) {
+            return i;
+        }
+    }
+
+    return DNREAD_NOT_FOUND;
+}
+
+__inline BOOL
+dnGlobalCacheSlotHasName (
+        DBPOS *pDB,
+        GLOBALDNREADCACHESLOT *pSlot,
+        ULONG parenttag,
+        ATTRTYP rdnType,
+        WCHAR *pRDN,
+        DWORD cbRDN,
+        DWORD dwHashRDN
+        )
+{
+    return ((pSlot->dwHashKey == dwHashRDN) &&
+            (pSlot->name.tag.PDNT == parenttag) &&
+            (pSlot->name.tag.rdnType == rdnType) &&
+            (gDBSyntax[SYNTAX_UNICODE_TYPE].Eval(
+                    pDB,
+                    FI_CHOICE_EQUALITY,
+                    cbRDN,
+                    (PUCHAR)pRDN,
+                    pSlot->name.tag.cbRdn,
+                    (PUCHAR)pSlot->name.tag.pRdn)));
+}
+
+DWORD
+dnGlobalCacheFindPDNTRdn (
+        DBPOS *pDB,
+        GLOBALDNREADCACHE *pCache,
+        ULONG parenttag,
+        ATTRTYP rdnType,
+        WCHAR *pRDN,
+        DWORD cbRDN,
+        DWORD dwHashRDN
+        )
+/*++
+  Description:
+      Find the first slot with the given parent, RDN and RDN type in a global
+      dnread cache.  dwHashRDN is the DSStrToHashKey of the RDN.
+
+  Return values:
+      The index of the slot in pData, or DNREAD_NOT_FOUND.
+--*/
+{
+    GLOBALDNREADCACHESLOT *pData = pCache->pData;
+    DWORD i, j, mask;
+
+    if(!pCache->pNameIndex) {
+        for(i=0;i<pCache->count;i++) {
+            if(dnGlobalCacheSlotHasName(pDB, &pData[i], parenttag, rdnType,
+                                        pRDN, cbRDN, dwHashRDN)) {
+                return i;
+            }
+        }
+        return DNREAD_NOT_FOUND;
+    }
+
+    mask = pCache->cIndexSlots - 1;
+    for(j = dnNameIndexHash(parenttag, dwHashRDN) & mask;
+        pCache->pNameIndex[j];
+        j = (j + 1) & mask) {
+        i = pCache->pNameIndex[j] - 1;
+        if(dnGlobalCacheSlotHasName(pDB, &pData[i], parenttag, rdnType,
+                                    pRDN, cbRDN, dwHashRDN)) {
+            return i;
+        }
+    }
+
+    return DNREAD_NOT_FOUND;
+}
 
 VOID
 dbReleaseDNReadCache(
@@ -900,6 +1299,7 @@ dbReleaseDNReadCache(
             }
             free(pCache->pSDHashTable);
         }
+        dnFreeGlobalCacheIndices(pCache);
         free(pCache);
     }
 
@@ -974,13 +1374,10 @@ dbResetGlobalDNReadCache (
 
     // Build new cache support structures.
     if(pTHS->Global_DNReadCache->count) {
-        // Create the parallel count structure.
-        pTHS->cGlobalCacheHits = pTHS->Global_DNReadCache->count;
+        // Create the hit table (zeroed by THAllocOrg).
+        pTHS->cGlobalCacheHits = 0;
         pTHS->pGlobalCacheHits =
-            THAllocOrg(pTHS, pTHS->cGlobalCacheHits * sizeof(DWORD));
-        if ( pTHS->pGlobalCacheHits == NULL ) {
-            pTHS->cGlobalCacheHits = 0;
-        }
+            THAllocOrg(pTHS, GLOBAL_CACHE_HIT_SLOTS * sizeof(GLOBAL_CACHE_HIT));
     }
 
     return;
@@ -1125,9 +1522,12 @@ dnReadPostProcessTransactionalData (
 
         // NOTE: we're keeping our global dnread cache, not picking up a new
         // copy.
-        if(pTHS->cGlobalCacheHits) {
-            memset(pTHS->pGlobalCacheHits, 0,
-                   pTHS->cGlobalCacheHits * sizeof(DWORD));
+        dnGlobalCacheResetHits(pTHS);
+
+        // The DNTs we invalidated belong to changes that are being rolled
+        // back, so there is nothing to carry over to a newer cache for them.
+        if(pTHS->transactionlevel == 0) {
+            pTHS->cInvalidatedDNTs = 0;
         }
     }
     else if (pTHS->transactionlevel == 0 ) {
@@ -1179,10 +1579,11 @@ dnReadPostProcessTransactionalData (
                 }
             }
 
-            // finally, scan through the hit count of the global structure to
-            // see how hot they were.
-            for(i=0;i<pTHS->cGlobalCacheHits;i++) {
-                if(pTHS->pGlobalCacheHits[i] >
+            // finally, scan through the global cache slots we hit to see how
+            // hot they were.
+            for(i=0;pTHS->cGlobalCacheHits && i<GLOBAL_CACHE_HIT_SLOTS;i++) {
+                if(pTHS->pGlobalCacheHits[i].iSlot &&
+                   pTHS->pGlobalCacheHits[i].count >
                    DNTs[MAX_LEVEL_1_HOT_DNTS - 1].count) {
 
                     // Yep, this is a hot one.
@@ -1190,7 +1591,7 @@ dnReadPostProcessTransactionalData (
 
                     while(k &&
                           DNTs[k].count <
-                          pTHS->pGlobalCacheHits[i])
+                          pTHS->pGlobalCacheHits[i].count)
                         k--;
 
                     if(!DNTs[MAX_LEVEL_1_HOT_DNTS - 1].DNT) {
@@ -1203,8 +1604,8 @@ dnReadPostProcessTransactionalData (
                             ((MAX_LEVEL_1_HOT_DNTS - k - 1 ) *
                              sizeof(DNT_COUNT_STRUCT)));
 
-                    DNTs[k].count = pTHS->pGlobalCacheHits[i];
-                    DNTs[k].DNT = pTHS->Global_DNReadCache->pData[i].name.DNT;
+                    DNTs[k].count = pTHS->pGlobalCacheHits[i].count;
+                    DNTs[k].DNT = pTHS->Global_DNReadCache->pData[pTHS->pGlobalCacheHits[i].iSlot - 1].name.DNT;
                 }
             }
 
@@ -1213,25 +1614,15 @@ dnReadPostProcessTransactionalData (
 
         // NOTE: we're keeping our global dnread cache, not picking up a new
         // copy. We are also keeping our local dnread cache.
-        if(pTHS->cGlobalCacheHits) {
-            memset(pTHS->pGlobalCacheHits, 0,
-                   pTHS->cGlobalCacheHits * sizeof(DWORD));
-        }
+        dnGlobalCacheResetHits(pTHS);
 
         if(pTHS->fDidInvalidate) {
-            // In preprocessing, we should have verified that the global dnread
-            // cache this thread is using is the same as the one on the anchor,
-            // or we should have nulled the one on the anchor.  Further, if we
-            // nulled it, then the gDNReadLastInvalidateSequence and
-            // gDNReadNumCurrentInvalidators should have kept us from getting a
-            // new global dnread cache in the anchor.  Assert this.
-            // Note, we are looking at gAnchor.MainGlobal_DNReadCache outside
-            // the csUpdate critsec.  Thus, it is conceivable that inbetween the
-            // two clauses of the OR in the assert, it's value could change,
-            // doing weird things to the assert. Not bloody likely, it it?
-            Assert(!gAnchor.MainGlobal_DNReadCache ||
-                   (pTHS->Global_DNReadCache==gAnchor.MainGlobal_DNReadCache));
-
+            // In preprocessing, we should have either found that the global
+            // dnread cache this thread is using is the same as the one on the
+            // anchor, or invalidated our entries in the one on the anchor (or
+            // nulled it).  The gDNReadLastInvalidateSequence and
+            // blDNReadInvalidateData have kept anyone from putting yet another
+            // global dnread cache in the anchor since then.
 
             // Write to the global variables that holds the sequence info of the
             // last commit that was on a thread that invalidated the cache. The
@@ -1242,11 +1633,77 @@ dnReadPostProcessTransactionalData (
 
             // Reset the flag
             pTHS->fDidInvalidate = FALSE;
+            pTHS->cInvalidatedDNTs = 0;
         }
     }
 
     return;
 }
+
+
+VOID
+dnGlobalCacheInvalidateDNTs (
+        THSTATE *pTHS
+        )
+/*++
+  Description:
+      Called while committing a transaction that invalidated entries in its
+      global dnread cache, when the cache in the anchor is no longer that one
+      (i.e. a new one was built while the transaction was open).  Instead of
+      throwing the new cache away, invalidate in it the same entries this
+      transaction invalidated in its own cache.  Other invalidating
+      transactions that are still open will do the same for their entries
+      when they commit.
+
+      If this transaction invalidated more entries than we remembered, fall
+      back to removing the cache from the anchor.
+
+      The caller must be in the invalidators group of blDNReadInvalidateData,
+      so no new cache can be placed in the anchor while we run.
+--*/
+{
+    GLOBALDNREADCACHE *pCache;
+    SYNC_RW_LOCK *prwl;
+    DWORD i, iSlot;
+
+    if(pTHS->cInvalidatedDNTs > DNREAD_MAX_INVALIDATED_DNTS) {
+        DPRINT1(3, "Too many invalidations (%d), dropping the dnread cache\n",
+                pTHS->cInvalidatedDNTs);
+        PERFINC(pcDNReadCacheDrop);
+        dbReplaceCacheInAnchor(NULL);
+        return;
+    }
+
+    // Take a reference on the anchor's cache the same way DBTransIn does, so
+    // that another invalidator can't free it beneath us.
+    prwl = &GetPLS()->rwlGlobalDNReadCache;
+    SyncEnterRWLockAsReader(prwl);
+    __try {
+        pCache = gAnchor.MainGlobal_DNReadCache;
+        if(pCache) {
+            Assert(pCache->refCount);
+            InterlockedIncrement(&pCache->refCount);
+        }
+    }
+    __finally {
+        SyncLeaveRWLockAsReader(prwl);
+    }
+
+    if(!pCache) {
+        return;
+    }
+
+    for(i=0;i<pTHS->cInvalidatedDNTs;i++) {
+        iSlot = dnGlobalCacheFindDNT(pCache, pTHS->rgInvalidatedDNTs[i]);
+        if(iSlot != DNREAD_NOT_FOUND) {
+            pCache->pData[iSlot].valid = FALSE;
+            PERFINC(pcDNReadEntryInvalidate);
+        }
+    }
+
+    dbReleaseDNReadCache(pCache);
+}
+
 BOOL
 dnReadPreProcessTransactionalData (
         BOOL fCommit
@@ -1289,21 +1746,19 @@ dnReadPreProcessTransactionalData (
             // 0. However, someone may have already built a new global dnread
             // cache while we had our transaction open.  Therefore, the thing we
             // invalidated in this threads global dnread cache isn't invalidated
-            // in that other global dnread cache.  So, we're going to throw away
-            // any new global dnread cache.  Any thread that already has a
-            // handle to this new dnread cache is OK since it's transaction is
-            // already open.  What we need to do is prevent transactions that
-            // open after the one we are in picking up that potentially invalid
-            // dnread cache.  Note that that other cache may have invalidations
-            // that we don't have, so the only safe thing to do is to throw away
-            // both (i.e. decouple both from the gAnchor and let the refounts
-            // clear them up).
+            // in that other global dnread cache.  Any thread that already has
+            // a handle to this new dnread cache is OK since it's transaction
+            // is already open.  What we need to do is prevent transactions
+            // that open after the one we are in picking up that potentially
+            // invalid data, so invalidate the entries we touched in the new
+            // cache as well.  Invalidations that other open transactions made
+            // in their own caches are carried over the same way when they
+            // commit, so we don't need to throw the new cache away.
 
             if(pTHS->Global_DNReadCache != gAnchor.MainGlobal_DNReadCache) {
                 DPRINT(3, "Hey, we invalidated and got a new dnread cache\n");
 
-                // Switch the universe to use the NO global cache
-                dbReplaceCacheInAnchor(NULL);
+                dnGlobalCacheInvalidateDNTs(pTHS);
             }
         }
     }
@@ -1326,7 +1781,6 @@ dbFlushDNReadCache (
         )
 {
     THSTATE *pTHS = pTHStls;
-    GLOBALDNREADCACHESLOT *pData;
     DWORD i;
     DWORD j;
 
@@ -1350,6 +1804,22 @@ dbFlushDNReadCache (
     // fDidInvalidate.
     if (pDB->NewlyCreatedDNT != tag) {
         pTHS->fDidInvalidate = TRUE;
+
+        // Remember what we invalidated, so that it can be invalidated in any
+        // global dnread cache built while this transaction is open.
+        for(i=0;
+            i<pTHS->cInvalidatedDNTs && i<DNREAD_MAX_INVALIDATED_DNTS;
+            i++) {
+            if(pTHS->rgInvalidatedDNTs[i] == tag) {
+                break;
+            }
+        }
+        if(i == pTHS->cInvalidatedDNTs) {
+            if(i < DNREAD_MAX_INVALIDATED_DNTS) {
+                pTHS->rgInvalidatedDNTs[i] = tag;
+            }
+            pTHS->cInvalidatedDNTs++;
+        }
     }
 
     // Look for the object in the local cache
@@ -1371,20 +1841,16 @@ dbFlushDNReadCache (
     // Even if it was in the local cache, we need to look in the Global (there
     // are a few weird cases where we can end up with an object in both the
     // local and global dnread caches).
-    // PERFORMANCE: Could do a binary search here.
     if(pTHS->Global_DNReadCache && pTHS->Global_DNReadCache->pData) {
-        pData = pTHS->Global_DNReadCache->pData;
-        for(i=0;i<pTHS->Global_DNReadCache->count;i++) {
-            if(pData[i].name.DNT == tag) {
-                // found it
-                pData[i].valid = FALSE;
-
-                // Newly created row should not be in the global dnread cache
-                Assert(pDB->NewlyCreatedDNT != tag
-                       && "Newly created row should not be in the global dnread cache");
+        i = dnGlobalCacheFindDNT(pTHS->Global_DNReadCache, tag);
+        if(i != DNREAD_NOT_FOUND) {
+            // found it
+            pTHS->Global_DNReadCache->pData[i].valid = FALSE;
+            PERFINC(pcDNReadEntryInvalidate);
 
-                break;
-            }
+            // Newly created row should not be in the global dnread cache
+            Assert(pDB->NewlyCreatedDNT != tag
+                   && "Newly created row should not be in the global dnread cache");
         }
     }
 }
@@ -1407,8 +1873,6 @@ dnGetCacheByDNT(
 {
     GLOBALDNREADCACHESLOT *pData;
     DWORD i, j;
-    BOOL  bFound;
-    DWORD begin, end, middle;
     THSTATE *pTHS = pDB->pTHS;
 
     Assert(pTHS->transactionlevel);
@@ -1427,38 +1891,16 @@ dnGetCacheByDNT(
     if(pTHS->Global_DNReadCache && pTHS->Global_DNReadCache->pData) {
         pData = pTHS->Global_DNReadCache->pData;
 
-        // Look up the correct node in the pData array. Since pData is
-        // sorted by DNT, use a binary search.
-        begin = 0;
-        end = pTHS->Global_DNReadCache->count;
-        middle = (begin + end) / 2;
-        bFound = TRUE;
-        while(bFound && (pData[middle].name.DNT != tag)) {
-            if(pData[middle].name.DNT > tag) {
-                end = middle;
-            }
-            else {
-                begin = middle;
-            }
-            if(middle == (begin + end) / 2) {
-                bFound = FALSE;
-            }
-            else  {
-                middle = (begin + end) / 2;
-            }
-
-        }
-        if(bFound) {
+        i = dnGlobalCacheFindDNT(pTHS->Global_DNReadCache, tag);
+        if(i != DNREAD_NOT_FOUND && pData[i].valid) {
             // found it
-            if(pData[middle].valid) {
-                *ppname = &pData[middle].name;
-                PERFINC(pcNameCacheHit);
-                if(pTHS->cGlobalCacheHits > middle) {
-                    pTHS->pGlobalCacheHits[middle] += 1;
-                }
-                return TRUE;
-            }
+            *ppname = &pData[i].name;
+            PERFINC(pcNameCacheHit);
+            PERFINC(pcDNReadGlobalHit);
+            dnGlobalCacheNoteHit(pTHS, i);
+            return TRUE;
         }
+        PERFINC(pcDNReadGlobalMiss);
     }
 
     // Didn't find it in the global cache (or it was invalid).
@@ -1508,8 +1950,9 @@ dnGetCacheByPDNTRdn (
   returned.  If it is found, a count associated with the object is incremented.
 
   NOTE:
-  The local and global dn read caches are optimized for looking up DNTs.  This
-  routine does a linear scan through the caches to find the objects.
+  The local dn read cache is optimized for looking up DNTs.  This routine does a
+  linear scan through it to find the object.  The global dn read cache is
+  searched through its PDNT/RDN index.
 
 --*/
 {
@@ -1535,32 +1978,18 @@ dnGetCacheByPDNTRdn (
     // First, look in the global cache.
     if(pTHS->Global_DNReadCache && pTHS->Global_DNReadCache->pData) {
         pData = pTHS->Global_DNReadCache->pData;
-        for(i=0;i<pTHS->Global_DNReadCache->count;i++) {
-            if((pData[i].dwHashKey == dwHashRDN) &&
-               (pData[i].name.tag.PDNT == parenttag) &&
-               (pData[i].name.tag.rdnType == rdnType) &&
-               (gDBSyntax[SYNTAX_UNICODE_TYPE].Eval(
-                       pDB,
-                       FI_CHOICE_EQUALITY,
-                       cbRDN,
-                       (PUCHAR)pRDN,
-                       pData[i].name.tag.cbRdn,
-                       (PUCHAR)pData[i].name.tag.pRdn))) {
-
-                // found it
-                if(pData[i].valid) {
-                    PERFINC(pcNameCacheHit);
-                    *ppname = &pData[i].name;
-                    if(pTHS->cGlobalCacheHits > i) {
-                        pTHS->pGlobalCacheHits[i] += 1;
-                    }
-                    return TRUE;
-                }
-                // It's invalid.  Break out of the while loop, since it still
-                // might in the local.
-                break;
-            }
+        i = dnGlobalCacheFindPDNTRdn(pDB, pTHS->Global_DNReadCache, parenttag,
+                                     rdnType, pRDN, cbRDN, dwHashRDN);
+        // If it's there but invalid, it still might be in the local.
+        if(i != DNREAD_NOT_FOUND && pData[i].valid) {
+            // found it
+            PERFINC(pcNameCacheHit);
+            PERFINC(pcDNReadGlobalHit);
+            *ppname = &pData[i].name;
+            dnGlobalCacheNoteHit(pTHS, i);
+            return TRUE;
         }
+        PERFINC(pcDNReadGlobalMiss);
     }
     // Didn't find it in the global cache.
 
@@ -1618,8 +2047,9 @@ dnGetCacheByGuid (
 
 
   NOTE:
-  The local and global dn read caches are optimized for looking up DNTs.  This
-  routine does a linear scan through the caches to find the objects.
+  The local dn read cache is optimized for looking up DNTs.  This routine does a
+  linear scan through it to find the object.  The global dn read cache is
+  searched through its Guid index.
 
 --*/
 {
@@ -1641,23 +2071,17 @@ dnGetCacheByGuid (
     // First, look in the global cache.
     if(pTHS->Global_DNReadCache && pTHS->Global_DNReadCache->pData) {
         pData = pTHS->Global_DNReadCache->pData;
-        for(i=0;i<pTHS->Global_DNReadCache->count;i++) {
-            if(!(memcmp(pGuid, &pData[i].name.Guid, sizeof(GUID)))) {
-
-                // found it
-                if(pData[i].valid) {
-                    *ppname = &pData[i].name;
-                    PERFINC(pcNameCacheHit);
-                    if(pTHS->cGlobalCacheHits > i) {
-                        pTHS->pGlobalCacheHits[i] += 1;
-                    }
-                    return TRUE;
-                }
-                // It's invalid.  Break out of the while loop, since it still
-                // might in the local.
-                break;
-            }
+        i = dnGlobalCacheFindGuid(pTHS->Global_DNReadCache, pGuid);
+        // If it's there but invalid, it still might be in the local.
+        if(i != DNREAD_NOT_FOUND && pData[i].valid) {
+            // found it
+            *ppname = &pData[i].name;
+            PERFINC(pcNameCacheHit);
+            PERFINC(pcDNReadGlobalHit);
+            dnGlobalCacheNoteHit(pTHS, i);
+            return TRUE;
         }
+        PERFINC(pcDNReadGlobalMiss);
     }
 
     // This loop stops after either looking at all the slots or finding a slot
@@ -2042,6 +2466,92 @@ int _cdecl compareSDIDs(const void* p1, const void* p2) {
 // compute the required SDCACHE_ENTRY size from the sd size
 #define SDCACHE_ENTRY_SIZE(cbSD) (offsetof(SDCACHE_ENTRY, SD) + cbSD)
 
+int _cdecl compareDNTs(const void* p1, const void* p2) {
+    DWORD DNT1 = *(DWORD *)p1, DNT2 = *(DWORD *)p2;
+    return (DNT1 < DNT2) ? -1 : (DNT1 > DNT2);
+}
+
+int _cdecl compareSlotDNTs(const void* p1, const void* p2) {
+    return compareDNTs(&((GLOBALDNREADCACHESLOT *)p1)->name.DNT,
+                       &((GLOBALDNREADCACHESLOT *)p2)->name.DNT);
+}
+
+// memory charged to the global dnread cache budget for a slot
+#define DNREAD_SLOT_SIZE(pSlot)                             \
+    (sizeof(GLOBALDNREADCACHESLOT) + (pSlot)->name.tag.cbRdn +  \
+     (pSlot)->name.cAncestors * sizeof(DWORD))
+
+BOOL
+dnLoadGlobalCacheSlot (
+        DBPOS *pDB,
+        DWORD DNT,
+        GLOBALDNREADCACHESLOT *pSlot,
+        SDID *psdId
+        )
+/*++
+  Description:
+      Fill in a slot of a global dnread cache being built by ReloadDNReadCache
+      with the object DNT.  The slot's name is malloced, since the cache
+      outlives this thread.  If the object has a new-format SD, its SDID is
+      returned in psdId so that the SD can be cached too.
+
+  Return values:
+      TRUE if the slot was filled in.
+--*/
+{
+    THSTATE *pTHS = pDB->pTHS;
+    d_memname  *pname=NULL;
+    BOOL fFilled = FALSE;
+
+    if(DBTryToFindDNT(pDB, DNT)) {
+        DPRINT1(4,"Failed to cache DNT %d\n",DNT);
+        return FALSE;
+    }
+
+    // First, create a memname to be cached.
+    pname =dnCreateMemname(pDB, pDB->JetObjTbl);
+    if(!pname) {
+        return FALSE;
+    }
+
+    memcpy(&pSlot->name, pname, sizeof(d_memname));
+
+    pSlot->dwHashKey = DSStrToHashKey (pTHS,
+                                       pname->tag.pRdn,
+                                       pname->tag.cbRdn / sizeof (WCHAR));
+
+    pSlot->name.tag.pRdn = malloc(pSlot->name.tag.cbRdn);
+    if(pSlot->name.tag.pRdn) {
+        pSlot->name.pAncestors = malloc(pSlot->name.cAncestors * sizeof(DWORD));
+        if(pSlot->name.pAncestors) {
+            memcpy(pSlot->name.tag.pRdn,
+                   pname->tag.pRdn,
+                   pname->tag.cbRdn);
+            memcpy(pSlot->name.pAncestors,
+                   pname->pAncestors,
+                   pname->cAncestors * sizeof(DWORD));
+            pSlot->valid = TRUE;
+            fFilled = TRUE;
+        }
+        else {
+            free(pSlot->name.tag.pRdn);
+        }
+    }
+
+    if (fFilled && pname->sdId != (SDID)0 && pname->sdId != (SDID)-1) {
+        // We got a non-null, new-format SDID. Add it to the list.
+        *psdId = pname->sdId;
+    }
+
+    THFreeOrg(pTHS, pname);
+
+    if(!fFilled) {
+        memset(pSlot, 0, sizeof(GLOBALDNREADCACHESLOT));
+    }
+
+    return fFilled;
+}
+
 
 /* ReloadDNReadCache
  *
@@ -2077,6 +2587,10 @@ ReloadDNReadCache(
     JET_ERR err;
     PSECURITY_DESCRIPTOR pSD;
     DWORD cbSD;
+    DWORD cSlots, cHot, cAncestors;
+    DWORD *pAncestorDNTs = NULL;
+    GLOBALDNREADCACHESLOT *pTemp;
+    ULONG cbUsed;
 
     if(!SyncTryEnterBinaryLockAsGroup1(&blDNReadInvalidateData)) {
         // Someone is actively, right now, working on committing a
@@ -2145,6 +2659,7 @@ ReloadDNReadCache(
             memset(pNewCache, 0, sizeof(GLOBALDNREADCACHE));
 
             index = 0;
+            cSlots = localCount;
             pData = malloc(localCount * sizeof(GLOBALDNREADCACHESLOT));
             if(!pData) {
                 free(pNewCache);
@@ -2191,53 +2706,15 @@ ReloadDNReadCache(
             }
             memset(pNewCache->pSDHashTable, 0, pNewCache->sdHashTableSize * sizeof(PSDCACHE_ENTRY));
 
-            // Now, cache the DNTs in the global list
-            for(i=0;i<localCount;i++) {
+            // Now, cache the DNTs in the global list, as long as we stay within
+            // the memory budget.
+            cbUsed = sizeof(GLOBALDNREADCACHE);
+            for(i=0;i<localCount && cbUsed < gulDNReadCacheBudget;i++) {
                 if(localDNTList[i]) {
-                    if(!DBTryToFindDNT(pDB, localDNTList[i])) {
-                        d_memname  *pname=NULL;
-                        // First, create a memname to be cached.
-                        pname =dnCreateMemname(pDB, pDB->JetObjTbl);
-                        if(pname) {
-                            memcpy(&pData[index].name,
-                                   pname,
-                                   sizeof(d_memname));
-
-                            pData[index].dwHashKey = DSStrToHashKey (pTHS,
-                                                                     pname->tag.pRdn,
-                                                                     pname->tag.cbRdn / sizeof (WCHAR));
-
-                            pData[index].name.tag.pRdn =
-                                malloc(pData[index].name.tag.cbRdn);
-                            if(pData[index].name.tag.pRdn) {
-                                pData[index].name.pAncestors =
-                                    malloc(pData[index].name.cAncestors *
-                                           sizeof(DWORD));
-                                if(pData[index].name.pAncestors) {
-                                    memcpy(pData[index].name.tag.pRdn,
-                                           pname->tag.pRdn,
-                                           pname->tag.cbRdn);
-                                    memcpy(pData[index].name.pAncestors,
-                                           pname->pAncestors,
-                                           pname->cAncestors * sizeof(DWORD));
-                                    pData[index].valid = TRUE;
-                                    index++;
-                                }
-                                else {
-                                    free(pData[index].name.tag.pRdn);
-                                }
-                            }
-                            
-                            if (pname->sdId != (SDID)0 && pname->sdId != (SDID)-1) {
-                                // We got a non-null, new-format SDID. Add it to the list.
-                                sdIDs[i] = pname->sdId;
-                            }
-
-                            THFreeOrg(pTHS, pname);
-                        }
-                    }
-                    else {
-                        DPRINT1(4,"Failed to cache DNT %d\n",localDNTList[i]);
+                    if(dnLoadGlobalCacheSlot(pDB, localDNTList[i],
+                                             &pData[index], &sdIDs[index])) {
+                        cbUsed += DNREAD_SLOT_SIZE(&pData[index]);
+                        index++;
                     }
                 }
                 else {
@@ -2245,14 +2722,81 @@ ReloadDNReadCache(
                 }
 
             }
+
+            // DN construction walks up the parent chain of each object it
+            // finds, so keep the ancestors of everything we cached resident
+            // too, even if they weren't hot themselves.
+            cHot = index;
+            for(i=0, cAncestors=0;i<cHot;i++) {
+                // The last ancestor is the object itself.
+                if(pData[i].name.cAncestors) {
+                    cAncestors += pData[i].name.cAncestors - 1;
+                }
+            }
+            if(cAncestors && cbUsed < gulDNReadCacheBudget) {
+                pAncestorDNTs = THAllocEx(pTHS, cAncestors * sizeof(DWORD));
+                for(i=0, cAncestors=0;i<cHot;i++) {
+                    for(j=0;j + 1 < pData[i].name.cAncestors;j++) {
+                        pAncestorDNTs[cAncestors++] = pData[i].name.pAncestors[j];
+                    }
+                }
+                qsort(pAncestorDNTs, cAncestors, sizeof(DWORD), compareDNTs);
+
+                for(i=0, j=0;
+                    i<cAncestors && cbUsed < gulDNReadCacheBudget;
+                    i++) {
+                    if(i > 0 && pAncestorDNTs[i] == pAncestorDNTs[i-1]) {
+                        continue;
+                    }
+                    // Skip it if it's in the hot list.  Both lists are sorted
+                    // by DNT.
+                    while(j < localCount && localDNTList[j] < pAncestorDNTs[i]) {
+                        j++;
+                    }
+                    if(j < localCount && localDNTList[j] == pAncestorDNTs[i]) {
+                        continue;
+                    }
+
+                    if(index == cSlots) {
+                        pTemp = realloc(pData,
+                                        2 * cSlots * sizeof(GLOBALDNREADCACHESLOT));
+                        if(!pTemp) {
+                            break;
+                        }
+                        pData = pTemp;
+                        memset(&pData[cSlots], 0,
+                               cSlots * sizeof(GLOBALDNREADCACHESLOT));
+                        sdIDs = THReAllocEx(pTHS, sdIDs,
+                                            2 * cSlots * sizeof(SDID));
+                        memset(&sdIDs[cSlots], 0, cSlots * sizeof(SDID));
+                        cSlots *= 2;
+                    }
+
+                    if(dnLoadGlobalCacheSlot(pDB, pAncestorDNTs[i],
+                                             &pData[index], &sdIDs[index])) {
+                        cbUsed += DNREAD_SLOT_SIZE(&pData[index]);
+                        index++;
+                    }
+                }
+                THFreeEx(pTHS, pAncestorDNTs);
+                pAncestorDNTs = NULL;
+
+                if(index > cHot) {
+                    // NOTE!!! the global cache MUST remain sorted by DNT.
+                    qsort(pData, index, sizeof(GLOBALDNREADCACHESLOT),
+                          compareSlotDNTs);
+                }
+            }
             pNewCache->pData = pData;
             pNewCache->count = index;
-            DPRINT1(3,"New cache, %d elements\n", index);
+            dnBuildGlobalCacheIndices(pNewCache);
+            DPRINT3(3,"New cache, %d elements (%d ancestors), %d bytes\n",
+                    index, index - cHot, cbUsed);
 
             // now load the SDs
             // sort the SDID array to be able to skip dups
-            qsort(sdIDs, localCount, sizeof(SDID), compareSDIDs);
-            for (i = 0; i < localCount; i++) {
+            qsort(sdIDs, index, sizeof(SDID), compareSDIDs);
+            for (i = 0; i < index; i++) {
                 if (sdIDs[i] == 0 || (i > 0 && sdIDs[i] == sdIDs[i-1])) {
                     // skip this one
                     continue;
@@ -2370,6 +2914,7 @@ ReloadDNReadCache(
             }
             free(pNewCache->pSDHashTable);
         }
+        dnFreeGlobalCacheIndices(pNewCache);
         free(pNewCache);
         return;
     }
@@ -48,6 +48,41 @@
 #define FPR       FilTypes.present
 #define FSKIP     FilTypes.pbSkip
 
+// Filters that are ANDs, ORs or NOTs of several terms are evaluated against a
+// set of column values that is retrieved for the whole candidate with one
+// JetRetrieveColumns call, instead of one JetRetrieveColumn (and allocation)
+// per term.  Only single valued, fixed size, non-linked columns are fetched
+// this way; everything else is evaluated the usual way.
+
+#define EVAL_PREFETCH_MAX   16
+
+typedef struct _EVAL_PREFETCH {
+    ULONG               cCols;
+    ATTCACHE            *rgpAC[EVAL_PREFETCH_MAX];
+    JET_RETRIEVECOLUMN  rgretcol[EVAL_PREFETCH_MAX];
+    LARGE_INTEGER       rgVal[EVAL_PREFETCH_MAX];
+} EVAL_PREFETCH;
+
+TRIBOOL
+dbEvalIntEx (
+        DBPOS FAR *pDB,
+        BOOL fUseSearchTbl,
+        EVAL_PREFETCH *pPrefetch,
+        UCHAR Operation,
+        ATTRTYP type,
+        ULONG valLenFilter,
+        UCHAR *pValFilter,
+        BOOL *pbSkip
+        );
+
+TRIBOOL
+dbEvalFilterEx (
+        DBPOS FAR *pDB,
+        BOOL    fUseSearchTbl,
+        FILTER *pFil,
+        EVAL_PREFETCH *pPrefetch
+        );
+
 BOOL
 dbEvalFilterSecurity (
         DBPOS *pDB,
@@ -99,6 +134,139 @@ dbEvalFilterSecurity (
     return TRUE;
 }
 
+BOOL
+dbEvalCanPrefetch (
+        ATTCACHE *pAC
+        )
+{
+    if (pAC->ulLinkID || !pAC->isSingleValued) {
+        return FALSE;
+    }
+
+    switch (pAC->syntax) {
+    case SYNTAX_DISTNAME_TYPE:      // stored as a DNT
+    case SYNTAX_OBJECT_ID_TYPE:
+    case SYNTAX_INTEGER_TYPE:
+    case SYNTAX_BOOLEAN_TYPE:
+    case SYNTAX_TIME_TYPE:
+    case SYNTAX_I8_TYPE:
+        return TRUE;
+
+    default:
+        return FALSE;
+    }
+}
+
+/*-------------------------------------------------------------------------*/
+/*-------------------------------------------------------------------------*/
+/* Walk the filter and collect the columns of all terms that can be
+   prefetched, without duplicates.
+*/
+
+void
+dbEvalCollectPrefetch (
+        DBPOS FAR *pDB,
+        FILTER *pFil,
+        EVAL_PREFETCH *pPrefetch
+        )
+{
+    USHORT count;
+    ATTRTYP type;
+    ATTCACHE *pAC;
+    ULONG i;
+
+    switch (pFil->choice) {
+    case FILTER_CHOICE_AND:
+    case FILTER_CHOICE_OR:
+        // And and Or share the same layout
+        count = pFil->FilterTypes.And.count;
+        for (pFil = pFil->FilterTypes.And.pFirstFilter;
+             count--;
+             pFil = pFil->pNextFilter) {
+            dbEvalCollectPrefetch(pDB, pFil, pPrefetch);
+        }
+        return;
+
+    case FILTER_CHOICE_NOT:
+        dbEvalCollectPrefetch(pDB, pFil->FilterTypes.pNot, pPrefetch);
+        return;
+
+    case FILTER_CHOICE_ITEM:
+        switch (PITEM.choice) {
+        case FI_CHOICE_EQUALITY:
+        case FI_CHOICE_NOT_EQUAL:
+        case FI_CHOICE_GREATER_OR_EQ:
+        case FI_CHOICE_GREATER:
+        case FI_CHOICE_LESS_OR_EQ:
+        case FI_CHOICE_LESS:
+        case FI_CHOICE_BIT_AND:
+        case FI_CHOICE_BIT_OR:
+            type = PITEM.FAVA.type;
+            break;
+
+        case FI_CHOICE_PRESENT:
+            type = PITEM.FPR;
+            break;
+
+        default:
+            return;
+        }
+
+        if (PITEM.FSKIP && *PITEM.FSKIP) {
+            // this term won't read the column
+            return;
+        }
+        if (pPrefetch->cCols == EVAL_PREFETCH_MAX) {
+            return;
+        }
+        pAC = SCGetAttById(pDB->pTHS, type);
+        if (!pAC || !dbEvalCanPrefetch(pAC)) {
+            return;
+        }
+        for (i = 0; i < pPrefetch->cCols; i++) {
+            if (pPrefetch->rgpAC[i] == pAC) {
+                return;
+            }
+        }
+        pPrefetch->rgpAC[pPrefetch->cCols++] = pAC;
+        return;
+
+    default:
+        return;
+    }
+}
+
+/*-------------------------------------------------------------------------*/
+/*-------------------------------------------------------------------------*/
+/* Retrieve the collected columns of the current object in one Jet call.
+*/
+
+void
+dbEvalPrefetch (
+        DBPOS FAR *pDB,
+        BOOL fUseSearchTbl,
+        EVAL_PREFETCH *pPrefetch
+        )
+{
+    JET_RETRIEVECOLUMN *pretcol;
+    ULONG i;
+
+    memset(pPrefetch->rgretcol, 0, pPrefetch->cCols * sizeof(JET_RETRIEVECOLUMN));
+    for (i = 0; i < pPrefetch->cCols; i++) {
+        pretcol = &pPrefetch->rgretcol[i];
+        pretcol->columnid       = pPrefetch->rgpAC[i]->jColid;
+        pretcol->pvData         = &pPrefetch->rgVal[i];
+        pretcol->cbData         = sizeof(pPrefetch->rgVal[i]);
+        pretcol->grbit          = pDB->JetRetrieveBits;
+        pretcol->itagSequence   = 1;
+    }
+
+    JetRetrieveColumnsWarnings(pDB->JetSessID,
+                               fUseSearchTbl ? pDB->JetSearchTbl : pDB->JetObjTbl,
+                               pPrefetch->rgretcol,
+                               pPrefetch->cCols);
+}
+
 /*-------------------------------------------------------------------------*/
 /*-------------------------------------------------------------------------*/
 /* Apply the supplied filter test to the current object.  Returns TRUE or
@@ -113,12 +281,41 @@ DBEvalFilter (
         FILTER *pFil
         )
 {
+    EVAL_PREFETCH prefetch;
+
+    Assert(VALID_DBPOS(pDB));
+
+    // A single term gains nothing from prefetching.
+    if (pFil == NULL || pFil->choice == FILTER_CHOICE_ITEM) {
+        return dbEvalFilterEx(pDB, fUseSearchTbl, pFil, NULL);
+    }
+
+    prefetch.cCols = 0;
+    dbEvalCollectPrefetch(pDB, pFil, &prefetch);
+    if (prefetch.cCols < 2) {
+        return dbEvalFilterEx(pDB, fUseSearchTbl, pFil, NULL);
+    }
+
+    dbEvalPrefetch(pDB, fUseSearchTbl, &prefetch);
+
+    return dbEvalFilterEx(pDB, fUseSearchTbl, pFil, &prefetch);
+}/* DBEvalFilter*/
+
+
+TRIBOOL
+dbEvalFilterEx (
+        DBPOS FAR *pDB,
+        BOOL    fUseSearchTbl,
+        FILTER *pFil,
+        EVAL_PREFETCH *pPrefetch
+        )
+{
 
    USHORT count;
    TRIBOOL retval;
    BOOL    undefinedPresent;
 
-   DPRINT(2, "DBEvalFilter entered, apply filter test\n");
+   DPRINT(2, "dbEvalFilterEx entered, apply filter test\n");
 
    Assert(VALID_DBPOS(pDB));
 
@@ -141,7 +338,7 @@ DBEvalFilter (
                                       count--;
                                      pFil = pFil->pNextFilter){
 
-            retval = DBEvalFilter(pDB, fUseSearchTbl, pFil);
+            retval = dbEvalFilterEx(pDB, fUseSearchTbl, pFil, pPrefetch);
 
             Assert (VALID_TRIBOOL(retval));
 
@@ -177,7 +374,7 @@ DBEvalFilter (
         for (pFil = pFil->FilterTypes.Or.pFirstFilter;
                                       count--;
                                      pFil = pFil->pNextFilter){
-           retval = DBEvalFilter(pDB, fUseSearchTbl, pFil);
+           retval = dbEvalFilterEx(pDB, fUseSearchTbl, pFil, pPrefetch);
 
            Assert (VALID_TRIBOOL(retval));
 
@@ -202,7 +399,7 @@ DBEvalFilter (
         break;
 
      case FILTER_CHOICE_NOT:
-        retval = DBEvalFilter(pDB, fUseSearchTbl, pFil->FilterTypes.pNot);
+        retval = dbEvalFilterEx(pDB, fUseSearchTbl, pFil->FilterTypes.pNot, pPrefetch);
 
         Assert (VALID_TRIBOOL(retval));
 
@@ -244,7 +441,7 @@ DBEvalFilter (
 
         case FI_CHOICE_SUBSTRING:
             return
-                dbEvalInt(pDB, fUseSearchTbl,
+                dbEvalIntEx(pDB, fUseSearchTbl, pPrefetch,
                           FI_CHOICE_SUBSTRING, PITEM.FSB->type
                           , 0   /*NA for substrings*/
                           , (UCHAR *) PITEM.FSB
@@ -260,8 +457,9 @@ DBEvalFilter (
         case FI_CHOICE_BIT_AND:
         case FI_CHOICE_BIT_OR:
             return
-                dbEvalInt(pDB,
+                dbEvalIntEx(pDB,
                           fUseSearchTbl,
+                          pPrefetch,
                           pFil->FilterTypes.Item.choice,
                           PITEM.FAVA.type,
                           PITEM.FAVA.Value.valLen,
@@ -272,8 +470,9 @@ DBEvalFilter (
 
         case FI_CHOICE_PRESENT:
             return
-                dbEvalInt(pDB,
+                dbEvalIntEx(pDB,
                           fUseSearchTbl,
+                          pPrefetch,
                           FI_CHOICE_PRESENT, PITEM.FPR  /*just test for existance*/
                           , 0
                           , NULL
@@ -293,7 +492,7 @@ DBEvalFilter (
    }  /*switch FILTER*/
 
 
-}/* DBEvalFilter*/
+}/* dbEvalFilterEx*/
 
 
 // dbEvalLinkAtt optimizes the evaluation of a filter term on a linked attr by
@@ -465,6 +664,9 @@ dbEvalLinkAtt(
    is missing the evaluation is FALSE.  Otherwise, the client value is
    converted to internal form and is tested against each value in the
    attribute.  gDBSyntax performs the test according to the attribute syntax.
+
+   If pPrefetch is given and holds the attribute's column, the value already
+   retrieved for the object is tested instead of reading it again.
 */
 
 
@@ -479,6 +681,23 @@ dbEvalInt (
         BOOL *pbSkip
         )
 {
+    return dbEvalIntEx(pDB, fUseSearchTbl, NULL, Operation, type,
+                       valLenFilter, pValFilter, pbSkip);
+}
+
+
+TRIBOOL
+dbEvalIntEx (
+        DBPOS FAR *pDB,
+        BOOL fUseSearchTbl,
+        EVAL_PREFETCH *pPrefetch,
+        UCHAR Operation,
+        ATTRTYP type,
+            ULONG valLenFilter,
+        UCHAR *pValFilter,
+        BOOL *pbSkip
+        )
+{
 
     UCHAR   syntax;
     ULONG   attLenRec;
@@ -489,6 +708,8 @@ dbEvalInt (
     ULONG   bufSize;
     DWORD   flags;
     DWORD   err;
+    ULONG   i;
+    JET_RETRIEVECOLUMN *pretcol;
 
     Assert(VALID_DBPOS(pDB));
 
@@ -550,6 +771,34 @@ dbEvalInt (
         return dbEvalLinkAtt(pDB, fUseSearchTbl, Operation, pAC, valLenFilter, pValFilter);
     }
 
+    // if the value was already retrieved with the rest of the filter's
+    // columns then test it directly
+
+    for (i = 0; pPrefetch && i < pPrefetch->cCols; i++) {
+        if (pPrefetch->rgpAC[i] != pAC) {
+            continue;
+        }
+        pretcol = &pPrefetch->rgretcol[i];
+        if (pretcol->err == JET_wrnColumnNull) {
+            // No value, same as not finding one below
+            return (Operation == FI_CHOICE_NOT_EQUAL) ? eTRUE : eFALSE;
+        }
+        if (pretcol->err != JET_errSuccess) {
+            // Read it the usual way
+            break;
+        }
+        switch(gDBSyntax[pAC->syntax].Eval(pDB, Operation, valLenFilter,
+                                           pValFilter, pretcol->cbActual,
+                                           (UCHAR *) pretcol->pvData)) {
+            case TRUE:
+                return eTRUE;
+            case FALSE:
+                return eFALSE;
+            default:
+                return eUNDEFINED;
+        }
+    }
+
     // Get the first value to consider.
     NthValIndex = 1;
     if (pAC->ulLinkID) {
@@ -625,7 +874,7 @@ dbEvalInt (
     }
 
     return eFALSE;
-}  /* dbEvalInt*/
+}  /* dbEvalIntEx*/
 
 
 
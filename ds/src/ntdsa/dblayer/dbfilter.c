@@ -123,6 +123,7 @@ BOOL gfUseANDORFilterOptimizations = TRUE;
 
 ULONG gulIntersectExpenseRatio = DEFAULT_DB_INTERSECT_RATIO;
 ULONG gulMaxRecordsWithoutIntersection = DEFAULT_DB_INTERSECT_THRESHOLD;
+ULONG gulIntersectMemoryBudget = DEFAULT_DB_INTERSECT_MEMORY_BUDGET * 1024;
 ULONG gulEstimatedAncestorsIndexSize = 100000000;
 
 BOOL gfSupressFirstLastANR=FALSE;
@@ -1271,6 +1272,216 @@ dbOptOrFilter (
     return 0;
 }
 
+BOOL
+dbOptBitmapFromIndexRange (
+        DBPOS      *pDB,
+        JET_TABLEID tableid,
+        KEY_INDEX  *pIndex,
+        DNT_BITMAP *pFilter,
+        DNT_BITMAP *pBitmap,
+        ULONG       cbBudget
+        )
+/*++
+    Walk an index range over the object table and add the DNT of every entry
+    to pBitmap.  If pFilter is given, DNTs that can't be in pFilter are not
+    added, which keeps pBitmap no bigger than pFilter.
+
+    Returns FALSE if the bitmap outgrew cbBudget.
+--*/
+{
+    THSTATE     *pTHS=pDB->pTHS;
+    JET_ERR      err;
+    DWORD        DNT;
+    ULONG        cVisited = 0;
+
+    JetSetCurrentIndex4Success(pDB->JetSessID,
+                               tableid,
+                               pIndex->szIndexName,
+                               pIndex->pindexid,
+                               JET_bitMoveFirst);
+
+    if (pIndex->cbDBKeyLower) {
+        JetMakeKeyEx(pDB->JetSessID,
+                     tableid,
+                     pIndex->rgbDBKeyLower,
+                     pIndex->cbDBKeyLower,
+                     JET_bitNormalizedKey);
+        err = JetSeekEx(pDB->JetSessID, tableid, JET_bitSeekGE);
+    }
+    else {
+        err = JetMoveEx(pDB->JetSessID, tableid, JET_MoveFirst, 0);
+    }
+
+    if (err != JET_errSuccess && err != JET_wrnRecordFoundGreater) {
+        // empty range
+        return TRUE;
+    }
+
+    if (pIndex->cbDBKeyUpper) {
+        JetMakeKeyEx(pDB->JetSessID,
+                     tableid,
+                     pIndex->rgbDBKeyUpper,
+                     pIndex->cbDBKeyUpper,
+                     JET_bitNormalizedKey);
+        if (JetSetIndexRangeEx(pDB->JetSessID,
+                               tableid,
+                               JET_bitRangeUpperLimit | JET_bitRangeInclusive)) {
+            // empty range
+            return TRUE;
+        }
+    }
+
+    do {
+        JetRetrieveColumnSuccess(pDB->JetSessID,
+                                 tableid,
+                                 dntid,
+                                 &DNT,
+                                 sizeof(DNT),
+                                 NULL,
+                                 JET_bitRetrieveFromPrimaryBookmark,
+                                 NULL);
+
+        if (!pFilter || dbBitmapHasContainer(pFilter, DNT)) {
+            dbBitmapAdd(pTHS, pBitmap, DNT);
+        }
+
+        // check the budget every so often rather than on every add
+        if ((++cVisited % 1024) == 0
+            && (dbBitmapSize(pBitmap) + (pFilter ? dbBitmapSize(pFilter) : 0)) > cbBudget) {
+            return FALSE;
+        }
+
+    } while (!JetMoveEx(pDB->JetSessID, tableid, JET_MoveNext, 0));
+
+    return (dbBitmapSize(pBitmap) + (pFilter ? dbBitmapSize(pFilter) : 0)) <= cbBudget;
+}
+
+BOOL
+dbOptDoBitmapIntersection (
+        DBPOS     *pDB,
+        KEY_INDEX **ppBestIndex,
+        KEY_INDEX **ppIntersectIndexes,
+        int       cntIntersect
+        )
+/*++
+    The filter is an AND of indexed properties over the object table.
+    Try evaluating it by materializing each index range as a DNT bitmap and
+    intersecting the bitmaps in memory, smallest range first.  The result is
+    a sorted DNT array hung off an intersection KEY_INDEX, which the search
+    walks without any jet temp table.
+
+    Returns TRUE if the intersection was evaluated (whether or not it turned
+    out to be the best index), FALSE if the caller should fall back to
+    JetIntersectIndexes, either because some range is over the link table or
+    because the bitmaps outgrew gulIntersectMemoryBudget.
+--*/
+{
+    THSTATE     *pTHS=pDB->pTHS;
+    JET_TABLEID  tableid = JET_tableidNil;
+    DNT_BITMAP  *pResult = NULL;
+    DNT_BITMAP  *pRange = NULL;
+    KEY_INDEX   *pIndex;
+    ULONG        cRecords;
+    BOOL         fDone = FALSE;
+    int          count;
+
+    ULONG dwException, ulErrorCode, dsid;
+    PVOID dwEA;
+
+    if (!gulIntersectMemoryBudget) {
+        return FALSE;
+    }
+
+    for (count=0; count < cntIntersect; count++) {
+        if (ppIntersectIndexes[count]->pAC && ppIntersectIndexes[count]->pAC->ulLinkID) {
+            return FALSE;
+        }
+    }
+
+    __try {
+        JetDupCursorEx(pDB->JetSessID, pDB->JetSearchTbl, &tableid, 0);
+
+        // the indexes are sorted smallest first, so the running result only
+        // ever shrinks
+        for (count=0; count < cntIntersect; count++) {
+            pRange = dbBitmapCreate(pTHS);
+
+            if (!dbOptBitmapFromIndexRange(pDB,
+                                           tableid,
+                                           ppIntersectIndexes[count],
+                                           pResult,
+                                           pRange,
+                                           gulIntersectMemoryBudget)) {
+                DPRINT1 (1, "In memory intersection over budget at index %s\n",
+                         ppIntersectIndexes[count]->szIndexName);
+                __leave;
+            }
+
+            if (pResult) {
+                dbBitmapIntersect(pTHS, pResult, pRange);
+                dbBitmapFree(pTHS, pRange);
+            }
+            else {
+                pResult = pRange;
+            }
+            pRange = NULL;
+
+            if (!dbBitmapCount(pResult)) {
+                break;
+            }
+        }
+
+        cRecords = dbBitmapCount(pResult);
+
+        LogEvent(DS_EVENT_CAT_INTERNAL_PROCESSING,
+                 DS_EVENT_SEV_VERBOSE,
+                 DIRLOG_QUERY_INDEX_CONSIDERED,
+                 szInsertSz(c_szIntersectIndex),
+                 szInsertUL(cRecords),
+                 NULL);
+
+        DPRINT1 (2, "In memory intersect index size: %d\n", cRecords);
+
+        if(!(*ppBestIndex) ||
+           (cRecords < (*ppBestIndex)->ulEstimatedRecsInRange)) {
+
+            if(*ppBestIndex) {
+                dbFreeKeyIndex(pDB->pTHS, *ppBestIndex);
+            }
+            pIndex = *ppBestIndex = dbAlloc(sizeof(KEY_INDEX));
+            pIndex->pNext = NULL;
+            pIndex->bFlags = 0;
+            pIndex->ulEstimatedRecsInRange = cRecords;
+            pIndex->szIndexName = dbAlloc(cIntersectIndex + 1);
+            strcpy(pIndex->szIndexName, c_szIntersectIndex);
+            pIndex->pindexid = NULL;
+
+            pIndex->bIsIntersection = TRUE;
+            pIndex->tblIntersection = 0;
+            pIndex->pDNTIntersection = dbAlloc(max(1, cRecords) * sizeof(DWORD));
+            pIndex->cDNTIntersection = dbBitmapToArray(pResult, pIndex->pDNTIntersection);
+            pIndex->iDNTIntersection = 0;
+            Assert(pIndex->cDNTIntersection == cRecords);
+        }
+
+        fDone = TRUE;
+    }
+    __except(GetExceptionData(GetExceptionInformation(), &dwException,
+                              &dwEA, &ulErrorCode, &dsid)) {
+        HandleDirExceptions(dwException, ulErrorCode, dsid);
+
+        DPRINT1 (0, "Failed while doing in memory AND intersection for %d indexes\n", cntIntersect);
+    }
+
+    if (tableid != JET_tableidNil) {
+        JetCloseTable(pDB->JetSessID, tableid);
+    }
+    dbBitmapFree(pTHS, pRange);
+    dbBitmapFree(pTHS, pResult);
+
+    return fDone;
+}
+
 DWORD
 dbOptDoIntersection (
         DBPOS     *pDB,
@@ -1281,7 +1492,8 @@ dbOptDoIntersection (
         )
 /*++
     The filter is an AND of indexed properties.
-    Try evaluating this filter using JetIntersectIndexes.
+    Try evaluating this filter in memory with DNT bitmaps, and failing that
+    using JetIntersectIndexes.
 --*/
 {
     THSTATE     *pTHS=pDB->pTHS;
@@ -1300,6 +1512,10 @@ dbOptDoIntersection (
 
     Assert (cntIntersect >= 2);
 
+    if (dbOptDoBitmapIntersection(pDB, ppBestIndex, ppIntersectIndexes, cntIntersect)) {
+        return 0;
+    }
+
     DPRINT1 (2, "dbOptDoIntersection: Attempting intersection of %d indexes\n", cntIntersect);
 
 #ifdef DBG
@@ -3292,7 +3508,20 @@ dbCreateSortedTable (
         }
 
         // handle intersections differently
-        if (pIndex->bIsIntersection) {
+        if (pIndex->bIsIntersection && !pIndex->tblIntersection) {
+            // in memory intersection.  skip DNTs that have gone away since
+            // the intersection was evaluated
+            err = JET_errNoCurrentRecord;
+            for (pIndex->iDNTIntersection = 0;
+                 pIndex->iDNTIntersection < pIndex->cDNTIntersection;
+                 pIndex->iDNTIntersection++) {
+                if (!DBTryToFindDNT(pDB, pIndex->pDNTIntersection[pIndex->iDNTIntersection])) {
+                    err = JET_errSuccess;
+                    break;
+                }
+            }
+        }
+        else if (pIndex->bIsIntersection) {
             err = JetMoveEx( pDB->JetSessID,
                              pIndex->tblIntersection,
                              JET_MoveFirst,
@@ -3422,7 +3651,16 @@ dbCreateSortedTable (
             }
 
             //  Move to next, retrieve it's key.
-            if (pIndex->bIsIntersection) {
+            if (pIndex->bIsIntersection && !pIndex->tblIntersection) {
+                err = JET_errNoCurrentRecord;
+                while (++pIndex->iDNTIntersection < pIndex->cDNTIntersection) {
+                    if (!DBTryToFindDNT(pDB, pIndex->pDNTIntersection[pIndex->iDNTIntersection])) {
+                        err = JET_errSuccess;
+                        break;
+                    }
+                }
+            }
+            else if (pIndex->bIsIntersection) {
                 err = JetMoveEx( pDB->JetSessID,
                                  pIndex->tblIntersection,
                                  JET_MoveNext,
@@ -7409,7 +7647,7 @@ void DBGenerateLogOfSearchOperation (DBPOS *pDB)
                 sprintf (szIndexName, "idx_%s:%d:%c;",
                      tmp_index->pAC->name,
                      tmp_index->ulEstimatedRecsInRange,
-                     tmp_index->tblIntersection ? 'I' :
+                     tmp_index->bIsIntersection ? 'I' :
                         tmp_index->bIsTupleIndex ? 'T' :
                             tmp_index->bIsPDNTBased ? 'P' : 'N');
 
@@ -7418,7 +7656,7 @@ void DBGenerateLogOfSearchOperation (DBPOS *pDB)
                 sprintf (szIndexName, "%s:%d:%c;",
                      tmp_index->szIndexName,
                      tmp_index->ulEstimatedRecsInRange,
-                     tmp_index->tblIntersection ? 'I' :
+                     tmp_index->bIsIntersection ? 'I' :
                         tmp_index->bIsTupleIndex ? 'T' :
                             tmp_index->bIsPDNTBased ? 'P' : 'N');
 
@@ -41,6 +41,7 @@ Revision History:
 
 #include <dsexcept.h>
 #include "objids.h"	/* Contains hard-coded Att-ids and Class-ids */
+#include "usn.h"
 #include "debug.h"	/* standard debugging header */
 #define DEBSUB     "DBINDEX:"   /* define the subsystem for debugging */
 
@@ -334,8 +335,9 @@ dbCloseTempTables (
     while(pIndex) {
         pTemp = pIndex->pNext;
 
-        if (pIndex->bIsIntersection) {
-            Assert (pIndex->tblIntersection);
+        // in memory intersections have no temp table to close; their DNT
+        // array goes away with the key index
+        if (pIndex->bIsIntersection && pIndex->tblIntersection) {
             JetCloseTable (pDB->JetSessID, pIndex->tblIntersection );
 
             pIndex->bIsIntersection = 0;
@@ -2379,6 +2381,136 @@ Return Value:
     return count;
 } /* DBGetApproxNCSizeEx */
 
+
+VOID
+DBPrereadNCUsnRange(
+    IN DBPOS *pDB,
+    IN JET_TABLEID Cursor,
+    IN eIndexId indexid,
+    IN ULONG dntNC,
+    IN USN usnSeekStart
+    )
+
+/*++
+
+Routine Description:
+
+Start reading ahead the part of a usn index which holds the changes to the
+given NC at or beyond the given usn.  The index range is only set long enough
+for the database to schedule the reads; it is removed again before we return.
+
+This is a performance optimization for the outbound replication of a large
+number of changes, which otherwise takes a synchronous read for every leaf
+page of the index as the changes are enumerated.  Like the search preread, it
+is only done for ranges estimated to hold at least DB_PREREAD_RANGE_MIN_RECS
+entries, so the common incremental request with a handful of changes pays
+nothing more than the seek.
+
+Currency is lost.
+
+Arguments:
+
+    pDB - database position
+    Cursor - table
+    indexid - Which index. Must have ncdnt and usnChanged as the first segments
+    dntNC - nc to read ahead
+    usnSeekStart - first usn to read ahead
+
+Return Value:
+
+    None
+
+--*/
+
+{
+    DB_ERR dberr;
+    INDEX_VALUE IV[2];
+    USN usnLimit = MAXLONGLONG;
+    DWORD i;
+    DWORD BeginNum, BeginDenom, EndNum, EndDenom, Denominator;
+
+    // Every change in the range took a usn of its own, so the usns handed out
+    // since usnSeekStart bound the size of the range without touching the
+    // index at all.
+    if (gusnEC - usnSeekStart < DB_PREREAD_RANGE_MIN_RECS) {
+        return;
+    }
+
+    dberr = DBSetCurrentIndex(pDB, indexid, NULL, FALSE);
+    if (dberr) {
+        DsaExcept(DSA_DB_EXCEPTION, dberr,0);
+    }
+
+    IV[0].pvData = &dntNC;
+    IV[0].cbData = sizeof(dntNC);
+    IV[1].pvData = &usnSeekStart;
+    IV[1].cbData = sizeof(usnSeekStart);
+
+    dberr = DBSeekEx(pDB, Cursor, IV, 2, DB_SeekGE);
+    if (dberr) {
+        // No changes left to read ahead
+        return;
+    }
+
+    DBGetFractionalPositionEx(pDB, Cursor, &BeginNum, &BeginDenom);
+
+    IV[1].pvData = &usnLimit;
+    IV[1].cbData = sizeof(usnLimit);
+
+    // Estimate the size of the range from the fractional positions of its
+    // ends, as DBGetApproxNCSizeEx() does.  An index too small to give a
+    // fractional position is too small to be worth prereading.
+    dberr = DBSeekEx(pDB, Cursor, IV, 2, DB_SeekLE);
+    if (dberr) {
+        return;
+    }
+
+    DBGetFractionalPositionEx(pDB, Cursor, &EndNum, &EndDenom);
+
+    if ((BeginDenom <= 1) || (EndDenom <= 1)) {
+        return;
+    }
+
+    Denominator = (BeginDenom + EndDenom) / 2;
+    EndNum = MulDiv(EndNum, Denominator - 1, EndDenom - 1) + 1;
+    BeginNum = MulDiv(BeginNum, Denominator - 1, BeginDenom - 1) + 1;
+
+    if (NormalizeIndexPosition(BeginNum, EndNum) < DB_PREREAD_RANGE_MIN_RECS) {
+        return;
+    }
+
+    // Back to the start of the range to set it
+    IV[1].pvData = &usnSeekStart;
+    IV[1].cbData = sizeof(usnSeekStart);
+
+    dberr = DBSeekEx(pDB, Cursor, IV, 2, DB_SeekGE);
+    if (dberr) {
+        return;
+    }
+
+    IV[1].pvData = &usnLimit;
+    IV[1].cbData = sizeof(usnLimit);
+
+    for (i = 0; i < 2; i++) {
+        JetMakeKeyEx(pDB->JetSessID,
+                     Cursor,
+                     IV[i].pvData,
+                     IV[i].cbData,
+                     i ? 0 : JET_bitNewKey);
+    }
+
+    // The only error allowed through is no current record, in which case
+    // there is nothing to read ahead anyway.
+    dberr = JetSetIndexRangeEx(pDB->JetSessID,
+                               Cursor,
+                               (JET_bitRangeUpperLimit
+                                | JET_bitRangeInclusive
+                                | JET_bitRangePreread));
+    if (!dberr) {
+        JetSetIndexRangeEx(pDB->JetSessID, Cursor, JET_bitRangeRemove);
+    }
+} /* DBPrereadNCUsnRange */
+
 
 VOID
 DBSearchCriticalByDnt(
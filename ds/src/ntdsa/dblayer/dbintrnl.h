@@ -1860,6 +1860,75 @@ dbMakeKeyIndex(
         INDEX_RANGE * rgIndexRange
         );
 
+// Compressed DNT sets for in memory index intersection (dbbitmap.c)
+typedef struct _DNT_BITMAP DNT_BITMAP;
+
+DNT_BITMAP *
+dbBitmapCreate(
+        THSTATE *pTHS
+        );
+
+void
+dbBitmapFree(
+        THSTATE *pTHS,
+        DNT_BITMAP *pBitmap
+        );
+
+void
+dbBitmapAdd(
+        THSTATE *pTHS,
+        DNT_BITMAP *pBitmap,
+        DWORD DNT
+        );
+
+BOOL
+dbBitmapHasContainer(
+        DNT_BITMAP *pBitmap,
+        DWORD DNT
+        );
+
+void
+dbBitmapIntersect(
+        THSTATE *pTHS,
+        DNT_BITMAP *pDst,
+        DNT_BITMAP *pSrc
+        );
+
+ULONG
+dbBitmapCount(
+        DNT_BITMAP *pBitmap
+        );
+
+ULONG
+dbBitmapSize(
+        DNT_BITMAP *pBitmap
+        );
+
+ULONG
+dbBitmapToArray(
+        DNT_BITMAP *pBitmap,
+        DWORD *pDNTs
+        );
+
+// Index statistics for the filter optimizer (dbstats.c)
+typedef struct _INDEX_HISTOGRAM INDEX_HISTOGRAM;
+
+INDEX_HISTOGRAM *
+dbStatsGetHistogram(
+        char *szIndexName
+        );
+
+void
+dbStatsEstimateRecsInRange(
+        INDEX_HISTOGRAM *pHist,
+        BOOL   fEqualityBased,
+        BYTE  *pbKeyLower,
+        ULONG  cbKeyLower,
+        BYTE  *pbKeyUpper,
+        ULONG  cbKeyUpper,
+        ULONG *pulEstimate
+        );
+
 void
 dbFreeKeyIndex(
         THSTATE *pTHS,
@@ -1949,5 +2018,10 @@ void dbReleaseHiddenDBPOS(DBPOS *pDB);
 
 #define NormalizeIndexPosition(BeginNum, EndNum) ( (EndNum) < (BeginNum) ? 0 : (EndNum) - (BeginNum) + 1 )
 
+// Index ranges estimated to hold at least this many entries span enough leaf
+// pages to be worth prereading when the range is set.  Smaller ranges (and
+// ranges we have no estimate for) are left to jet's own read-ahead.
+#define DB_PREREAD_RANGE_MIN_RECS   1000
+
 
 #endif  /* _dbintrnl_h_ */
@@ -105,7 +105,16 @@ dbFreeKeyIndex(
             dbFree(pIndex->rgbDBKeyUpper);
         }
 
-        if (pIndex->bIsIntersection) {
+        if (pIndex->bIsIntersection && pIndex->pDNTIntersection) {
+
+            Assert (!pIndex->tblIntersection);
+            dbFree(pIndex->pDNTIntersection);
+
+            pIndex->bIsIntersection = 0;
+            pIndex->pDNTIntersection = NULL;
+            pIndex->cDNTIntersection = 0;
+        }
+        else if (pIndex->bIsIntersection) {
 
             Assert (pIndex->tblIntersection);
             JetCloseTable (pTHS->pDB->JetSessID, pIndex->tblIntersection );
@@ -2056,6 +2065,11 @@ Return Values:
     JET_TABLEID JetTbl;
     KEY_INDEX * const pIndex = pDB->Key.pIndex;
     CHAR        szIndexName[JET_cbNameMost + 1];
+    JET_GRBIT   grbitPreread;
+
+    grbitPreread = (pIndex->ulEstimatedRecsInRange >= DB_PREREAD_RANGE_MIN_RECS)
+                   ? JET_bitRangePreread
+                   : 0;
 
     if (pIndex->pAC && pIndex->pAC->ulLinkID) {
         if (JET_tableidNil == pDB->JetLinkEnumTbl) {
@@ -2163,9 +2177,13 @@ Return Values:
                              pIndex->rgbDBKeyUpper,
                              pIndex->cbDBKeyUpper,
                              JET_bitNormalizedKey);
+                // Ask for the leaf pages of a large range to be preread
+                // now so that a cold scan is not paced by synchronous reads.
                 err = JetSetIndexRangeEx(pDB->JetSessID,
                                          JetTbl,
-                                         JET_bitRangeUpperLimit | JET_bitRangeInclusive);
+                                         (JET_bitRangeUpperLimit
+                                          | JET_bitRangeInclusive
+                                          | grbitPreread));
                 // The only error we allow here should be
                 // nocurrentrecord, and we should only hit it if the
                 // key we pulled off the object before the
@@ -2229,7 +2247,8 @@ Return Values:
 
                 err = JetSetIndexRangeEx(pDB->JetSessID,
                                          JetTbl,
-                                         JET_bitRangeInclusive);
+                                         (JET_bitRangeInclusive
+                                          | grbitPreread));
                 // The only error we allow here should be
                 // nocurrentrecord, and we should only hit it if the
                 // key we pulled off the object before the
@@ -2444,6 +2463,30 @@ Return Values:
                 } while(DBTryToFindDNT(pDB, DNT));
             }
         }
+        else if (pDB->Key.pIndex && pDB->Key.pIndex->bIsIntersection &&
+                 !pDB->Key.pIndex->tblIntersection) {
+            // CASE 1f: We're moving in an in memory intersection.  This is an
+            // ascending array of DNTs, walked just like the in memory array
+            // of case 1d.
+            KEY_INDEX  *pIndex = pDB->Key.pIndex;
+
+            if (pDB->Key.indexType == UNSET_INDEX_TYPE) {
+                pIndex->iDNTIntersection = 0;
+                pDB->Key.indexType = INTERSECT_INDEX_TYPE;
+            }
+            else {
+                pIndex->iDNTIntersection++;
+            }
+
+            err = JET_errNoCurrentRecord;
+            while (pIndex->iDNTIntersection < pIndex->cDNTIntersection) {
+                if (!DBTryToFindDNT(pDB, pIndex->pDNTIntersection[pIndex->iDNTIntersection])) {
+                    err = JET_errSuccess;
+                    break;
+                }
+                pIndex->iDNTIntersection++;
+            }
+        }
         else if (pDB->Key.pIndex && pDB->Key.pIndex->bIsIntersection) {
             // CASE 1e: We're moving in a intersected table.
 
@@ -3740,6 +3783,8 @@ dbMakeKeyIndex(
     DWORD       Denom;
     DWORD       i;
     JET_RECPOS  RecPos;
+    INDEX_HISTOGRAM *pHist = NULL;
+    BOOL        fUseStats = FALSE;
 
     if (Option == dbmkfir_LINK) {
         JetTbl = pDB->JetLinkTbl;
@@ -3783,6 +3828,16 @@ dbMakeKeyIndex(
 
     Assert(VALID_DBPOS(pDB));
 
+    // If the index has been sampled, estimate the size of the range from its
+    // histogram rather than from the fractional positions of the bounds,
+    // which are unreliable on skewed indices.  Only the unbased attribute
+    // indices are sampled; PDNT and NCDNT based ranges are small enough that
+    // the probes are accurate, and link table indices aren't sampled at all.
+    if ((Flags & DB_MKI_GET_NUM_RECS) && (Option == 0)) {
+        pHist = dbStatsGetHistogram(szIndex);
+        fUseStats = (pHist != NULL);
+    }
+
     // make keys
 
     // First make the key for the lower bound ( ie key 1 )
@@ -3790,7 +3845,7 @@ dbMakeKeyIndex(
     if ((Option == 0) &&  ((0==cIndexRanges) ||
                            (0==rgIndexRanges[0].cbValLower))) {
         // Range starts at beginning of file
-        if (Flags & DB_MKI_GET_NUM_RECS) {
+        if ((Flags & DB_MKI_GET_NUM_RECS) && !fUseStats) {
             // Get an estimate of the number of objects in the index range
             if (JetMoveEx(pDB->JetSessID, JetTbl, JET_MoveFirst, 0) == JET_errSuccess ) {
                 JetGetRecordPositionEx(pDB->JetSessID, JetTbl, &RecPos, sizeof(RecPos));
@@ -3867,14 +3922,15 @@ dbMakeKeyIndex(
                     pIndex->bIsUniqueRecord = TRUE;
                     Flags &= ~DB_MKI_GET_NUM_RECS;  //  we have our estimate
                 } else if (err == JET_errRecordNotFound) {
-                    JetMakeKeyEx(pDB->JetSessID, JetTbl, rgbKey, cbActualKey, JET_bitNormalizedKey);
-                    err = JetSeekEx(pDB->JetSessID, JetTbl, JET_bitSeekGE);
+                    // No entry has this key, so the range is empty
+                    pIndex->ulEstimatedRecsInRange = 0;
+                    Flags &= ~DB_MKI_GET_NUM_RECS;  //  we have our estimate (zero)
                 }
-            } else {
+            } else if (!fUseStats) {
                 err = JetSeekEx(pDB->JetSessID, JetTbl, JET_bitSeekGE);
             }
         }
-        if (Flags & DB_MKI_GET_NUM_RECS) {
+        if ((Flags & DB_MKI_GET_NUM_RECS) && !fUseStats) {
             if (err >= JET_errSuccess) {
                 JetGetRecordPositionEx(pDB->JetSessID, JetTbl, &RecPos, sizeof(RecPos));
                 BeginNum = RecPos.centriesLT;
@@ -4010,6 +4066,16 @@ dbMakeKeyIndex(
     memcpy(pIndex->rgbDBKeyUpper, rgbKey, cbActualKey);
 
     // Get an estimate of the number of objects in the index range
+    if ((Flags & DB_MKI_GET_NUM_RECS) && fUseStats) {
+        dbStatsEstimateRecsInRange(pHist,
+                                   pIndex->bIsEqualityBased,
+                                   pIndex->rgbDBKeyLower,
+                                   pIndex->cbDBKeyLower,
+                                   fMoveToEnd ? NULL : pIndex->rgbDBKeyUpper,
+                                   pIndex->cbDBKeyUpper,
+                                   &pIndex->ulEstimatedRecsInRange);
+        Flags &= ~DB_MKI_GET_NUM_RECS;  //  we have our estimate
+    }
     if (Flags & DB_MKI_GET_NUM_RECS) {
         if (fMoveToEnd) {
             err = JetMoveEx(pDB->JetSessID, JetTbl, JET_MoveLast, 0);
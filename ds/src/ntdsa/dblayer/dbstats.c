@@ -0,0 +1,755 @@
+//+-------------------------------------------------------------------------
+//
+//  Microsoft Windows
+//
+//  Copyright (C) Microsoft Corporation, 1989 - 1999
+//
+//  File:       dbstats.c
+//
+//--------------------------------------------------------------------------
+
+/*++
+
+ABSTRACT:
+
+    Index statistics for the search optimizer.
+
+DETAILS:
+
+    The filter optimizer (dbfilter.c) estimates the number of records in an
+    index range by probing the fractional position of the lower and upper
+    keys (see dbMakeKeyIndex).  The fractional position that Jet returns is a
+    guess based on the shape of the B-tree, and it is badly wrong for skewed
+    indices, where a handful of values own most of the entries.
+
+    This module keeps, for every index the optimizer has asked about, an
+    equi-depth histogram of the index: cBuckets+1 normalized keys that split
+    the index into buckets holding the same number of entries, plus the
+    number of distinct keys.  The histograms are built off of the task queue
+    (RefreshIndexStatistics) from a bounded sample of real keys, read by
+    seeking to evenly spaced fractional positions in the index, so that the
+    sampling cost is never paid by a search and does not grow with the size
+    of the index.  dbMakeKeyIndex asks dbStatsGetHistogram for the
+    histogram of an index and, if there is one, costs the range with
+    dbStatsEstimateRecsInRange instead of the fractional position probes.
+
+    The statistics live in a small open addressed hash table keyed by index
+    name and protected by csIndexStats.  Entries are never removed once they
+    have been added.  A histogram, once published, is never modified; when
+    it is replaced by a newer one it is freed through DelayedFreeMemoryEx,
+    so a search may keep using the pointer it got from dbStatsGetHistogram
+    without holding the critical section.
+
+CREATED:
+
+REVISION HISTORY:
+
+--*/
+
+#include <NTDSpch.h>
+#pragma  hdrstop
+
+#include <dsjet.h>
+
+#include <ntdsa.h>
+#include <scache.h>
+#include <dbglobal.h>
+#include <mdglobal.h>
+#include <mdlocal.h>
+#include <dsatools.h>
+
+#include <mdcodes.h>
+#include <dsevent.h>
+#include <dstaskq.h>
+#include <dsexcept.h>
+#include <dsconfig.h>
+#include "debug.h"  /* standard debugging header */
+#define DEBSUB "DBSTATS:" /* define the subsystem for debugging */
+
+#include "dbintrnl.h"
+
+#include <fileno.h>
+#define  FILENO FILENO_DBSTATS
+
+// Number of slots in the statistics hash table.  Must be a power of two and
+// comfortably larger than MAX_INDEX_STATS so that probe chains stay short.
+#define INDEX_STATS_TABLE_SIZE      512
+#define MAX_INDEX_STATS             256
+
+// Upper bound on the number of histogram buckets per index.
+#define MAX_INDEX_STATS_BUCKETS     256
+
+// How often the task queue refreshes the histograms.
+#define INDEX_STATS_REFRESH_SECS    (30 * 60)
+
+// Number of keys read from an index per bucket.  This bounds the cost of
+// sampling an index, however big it is.
+#define INDEX_STATS_SAMPLES_PER_BUCKET  8
+
+// Number of index keys read per transaction while sampling, so that
+// sampling many indices doesn't pin the version store.
+#define INDEX_STATS_KEYS_PER_TRANSACTION    1000
+
+// How long a replaced histogram is kept around for searches still using it.
+#define INDEX_STATS_DELAYED_FREE_SECS   3600
+
+struct _INDEX_HISTOGRAM {
+    ULONG   cEntries;           // entries in the index when sampled
+    ULONG   cDistinct;          // distinct keys in the index when sampled
+    ULONG   cBuckets;           // number of buckets, cBuckets+1 boundaries
+    ULONG  *rgibBound;          // offsets of the boundary keys in rgbKeys,
+                                // cBuckets+2 entries so that the size of
+                                // boundary i is rgibBound[i+1]-rgibBound[i]
+    BYTE   *rgbKeys;            // packed normalized boundary keys
+};
+
+typedef struct _INDEX_STATS_SAMPLE {
+    ULONG   cbKey;
+    BYTE    rgbKey[DB_CB_MAX_KEY];
+} INDEX_STATS_SAMPLE;
+
+typedef struct _INDEX_STATS {
+    char             szIndexName[MAX_INDEX_NAME];
+    INDEX_HISTOGRAM *pHistogram;    // NULL until first sampled
+} INDEX_STATS;
+
+CRITICAL_SECTION csIndexStats;
+
+// The number of buckets to sample per index.  Zero disables the use of index
+// statistics altogether.  Read from the registry in DSLoadDynamicRegParams.
+ULONG gulIndexStatsBuckets = DEFAULT_DB_INDEX_STATS_BUCKETS;
+
+INDEX_STATS  grgIndexStats[INDEX_STATS_TABLE_SIZE];
+ULONG        gcIndexStats = 0;
+
+
+ULONG
+dbStatsHashIndexName(
+    IN char *szIndexName
+    )
+{
+    ULONG ulHash = 0;
+
+    while (*szIndexName) {
+        ulHash = (ulHash << 5) + ulHash + (UCHAR)*szIndexName++;
+    }
+
+    return ulHash & (INDEX_STATS_TABLE_SIZE - 1);
+}
+
+INDEX_STATS *
+dbStatsFindIndex(
+    IN char *szIndexName,
+    IN BOOL  fAdd
+    )
+/*++
+
+Routine Description:
+
+    Find the statistics slot for an index, optionally claiming a new one.
+    Must be called with csIndexStats held.
+
+Arguments:
+
+    szIndexName - the jet index name.
+
+    fAdd - if TRUE and the index isn't in the table yet, add it.
+
+Return Values:
+
+    The slot, or NULL if the index is not in the table (and either fAdd was
+    FALSE or the table is full).
+
+--*/
+{
+    ULONG i, iSlot;
+
+    iSlot = dbStatsHashIndexName(szIndexName);
+
+    for (i = 0; i < INDEX_STATS_TABLE_SIZE; i++) {
+        INDEX_STATS *pStats = &grgIndexStats[iSlot];
+
+        if (pStats->szIndexName[0] == '\0') {
+            if (!fAdd || gcIndexStats >= MAX_INDEX_STATS) {
+                return NULL;
+            }
+            strncpy(pStats->szIndexName, szIndexName, MAX_INDEX_NAME - 1);
+            pStats->szIndexName[MAX_INDEX_NAME - 1] = '\0';
+            gcIndexStats++;
+            return pStats;
+        }
+
+        if (0 == strncmp(pStats->szIndexName, szIndexName, MAX_INDEX_NAME - 1)) {
+            return pStats;
+        }
+
+        iSlot = (iSlot + 1) & (INDEX_STATS_TABLE_SIZE - 1);
+    }
+
+    return NULL;
+}
+
+void
+dbStatsFreeHistogram(
+    IN INDEX_HISTOGRAM *pHistogram
+    )
+{
+    if (pHistogram) {
+        free(pHistogram->rgibBound);
+        free(pHistogram->rgbKeys);
+        free(pHistogram);
+    }
+}
+
+int
+dbStatsCompareKeys(
+    IN BYTE  *pbKey1,
+    IN ULONG  cbKey1,
+    IN BYTE  *pbKey2,
+    IN ULONG  cbKey2
+    )
+/*++
+
+Routine Description:
+
+    Compare two normalized jet keys the same way jet does: bytewise, with a
+    key that is a prefix of another sorting first.
+
+--*/
+{
+    int iCmp = memcmp(pbKey1, pbKey2, min(cbKey1, cbKey2));
+
+    if (iCmp == 0) {
+        iCmp = (int)cbKey1 - (int)cbKey2;
+    }
+
+    return iCmp;
+}
+
+int __cdecl
+dbStatsCompareSamples(
+    IN const void *pv1,
+    IN const void *pv2
+    )
+{
+    INDEX_STATS_SAMPLE *pSample1 = (INDEX_STATS_SAMPLE *) pv1;
+    INDEX_STATS_SAMPLE *pSample2 = (INDEX_STATS_SAMPLE *) pv2;
+
+    return dbStatsCompareKeys(pSample1->rgbKey, pSample1->cbKey,
+                              pSample2->rgbKey, pSample2->cbKey);
+}
+
+void
+dbStatsDelayedFreeHistogram(
+    IN INDEX_HISTOGRAM *pHistogram
+    )
+{
+    DWORD_PTR *pointerArray;
+
+    pointerArray = malloc(4 * sizeof(DWORD_PTR));
+    if (!pointerArray) {
+        // Leak it rather than free it under a search.
+        return;
+    }
+    pointerArray[0] = 3;
+    pointerArray[1] = (DWORD_PTR) pHistogram->rgibBound;
+    pointerArray[2] = (DWORD_PTR) pHistogram->rgbKeys;
+    pointerArray[3] = (DWORD_PTR) pHistogram;
+
+    DelayedFreeMemoryEx(pointerArray, INDEX_STATS_DELAYED_FREE_SECS);
+}
+
+#define HISTOGRAM_BOUND(pHist, i)     ((pHist)->rgbKeys + (pHist)->rgibBound[i])
+#define HISTOGRAM_CB_BOUND(pHist, i)  ((pHist)->rgibBound[(i)+1] - (pHist)->rgibBound[i])
+
+ULONG
+dbStatsLowerPosition(
+    IN INDEX_HISTOGRAM *pHist,
+    IN BYTE            *pbKey,
+    IN ULONG            cbKey
+    )
+/*++
+
+Routine Description:
+
+    Return the position of the first index entry >= the given key, in units
+    of half buckets (0 .. 2*cBuckets).  A key that falls strictly between two
+    boundaries is assumed to sit in the middle of its bucket.
+
+--*/
+{
+    ULONG lo = 0, hi = pHist->cBuckets + 1;
+
+    // Find the first boundary >= key.
+    while (lo < hi) {
+        ULONG mid = (lo + hi) / 2;
+        if (dbStatsCompareKeys(HISTOGRAM_BOUND(pHist, mid),
+                               HISTOGRAM_CB_BOUND(pHist, mid),
+                               pbKey, cbKey) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    if (lo > pHist->cBuckets) {
+        return 2 * pHist->cBuckets;
+    }
+    if (lo == 0) {
+        return 0;
+    }
+    if (0 == dbStatsCompareKeys(HISTOGRAM_BOUND(pHist, lo),
+                                HISTOGRAM_CB_BOUND(pHist, lo),
+                                pbKey, cbKey)) {
+        return 2 * lo;
+    }
+    return 2 * lo - 1;
+}
+
+ULONG
+dbStatsUpperPosition(
+    IN INDEX_HISTOGRAM *pHist,
+    IN BYTE            *pbKey,
+    IN ULONG            cbKey
+    )
+/*++
+
+Routine Description:
+
+    Return the position of the last index entry <= the given key, in units of
+    half buckets (0 .. 2*cBuckets).
+
+--*/
+{
+    ULONG lo = 0, hi = pHist->cBuckets + 1;
+
+    // Find the first boundary > key; the one before it is the last <= key.
+    while (lo < hi) {
+        ULONG mid = (lo + hi) / 2;
+        if (dbStatsCompareKeys(HISTOGRAM_BOUND(pHist, mid),
+                               HISTOGRAM_CB_BOUND(pHist, mid),
+                               pbKey, cbKey) <= 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    if (lo == 0) {
+        return 0;
+    }
+    lo--;
+    if (lo == pHist->cBuckets) {
+        return 2 * pHist->cBuckets;
+    }
+    if (0 == dbStatsCompareKeys(HISTOGRAM_BOUND(pHist, lo),
+                                HISTOGRAM_CB_BOUND(pHist, lo),
+                                pbKey, cbKey)) {
+        return 2 * lo;
+    }
+    return 2 * lo + 1;
+}
+
+INDEX_HISTOGRAM *
+dbStatsGetHistogram(
+    IN char *szIndexName
+    )
+/*++
+
+Routine Description:
+
+    Register interest in the statistics of an index, so that the next run of
+    RefreshIndexStatistics builds a histogram for it, and return the current
+    histogram of the index if it has one.
+
+    The histogram is never modified once published and is only freed
+    INDEX_STATS_DELAYED_FREE_SECS after it has been replaced, so the caller
+    may use it for the rest of the search without holding csIndexStats.
+
+Return Values:
+
+    The histogram, or NULL if the index hasn't been sampled yet.
+
+--*/
+{
+    INDEX_STATS     *pStats;
+    INDEX_HISTOGRAM *pHist = NULL;
+
+    if (0 == gulIndexStatsBuckets) {
+        return NULL;
+    }
+
+    EnterCriticalSection(&csIndexStats);
+    __try {
+        pStats = dbStatsFindIndex(szIndexName, TRUE);
+        if (pStats) {
+            pHist = pStats->pHistogram;
+        }
+    }
+    __finally {
+        LeaveCriticalSection(&csIndexStats);
+    }
+
+    return pHist;
+}
+
+void
+dbStatsEstimateRecsInRange(
+    IN  INDEX_HISTOGRAM *pHist,
+    IN  BOOL             fEqualityBased,
+    IN  BYTE            *pbKeyLower,
+    IN  ULONG            cbKeyLower,
+    IN  BYTE            *pbKeyUpper,
+    IN  ULONG            cbKeyUpper,
+    OUT ULONG           *pulEstimate
+    )
+/*++
+
+Routine Description:
+
+    Estimate the number of index entries between two normalized keys from the
+    histogram of the index.
+
+    Ranges spanning one or more buckets are costed by the number of
+    (half) buckets they cover, which is exact to within a bucket no matter
+    how skewed the values are, since a value owning many entries owns many
+    consecutive boundaries.  Ranges that fall inside a single bucket are
+    costed as the average number of entries per distinct key, bounded by the
+    size of a bucket.
+
+Arguments:
+
+    pHist - the histogram of the index, from dbStatsGetHistogram.
+
+    fEqualityBased - the range is an equality match.
+
+    pbKeyLower, cbKeyLower - the lower bound, or cbKeyLower == 0 for the
+        start of the index.
+
+    pbKeyUpper, cbKeyUpper - the upper bound, or NULL for the end of the
+        index.
+
+    pulEstimate - receives the estimate.
+
+--*/
+{
+    ULONG ulLower, ulUpper;
+    ULONG cPerBucket, cPerKey;
+
+    ulLower = cbKeyLower ? dbStatsLowerPosition(pHist, pbKeyLower, cbKeyLower) : 0;
+    ulUpper = pbKeyUpper ? dbStatsUpperPosition(pHist, pbKeyUpper, cbKeyUpper)
+                         : 2 * pHist->cBuckets;
+
+    cPerBucket = max(1, pHist->cEntries / pHist->cBuckets);
+    cPerKey = max(1, pHist->cEntries / max(1, pHist->cDistinct));
+
+    if (ulUpper > ulLower) {
+        *pulEstimate = max(1, MulDiv(pHist->cEntries,
+                                     ulUpper - ulLower,
+                                     2 * pHist->cBuckets));
+        // An equality match on a value that doesn't own a whole bucket
+        // can't be bigger than a bucket.
+        if (fEqualityBased && ulUpper - ulLower < 2) {
+            *pulEstimate = min(*pulEstimate, cPerKey);
+        }
+    }
+    else {
+        *pulEstimate = min(cPerKey, cPerBucket);
+    }
+
+    DPRINT1(2, "dbStatsEstimateRecsInRange: estimate %d\n", *pulEstimate);
+}
+
+INDEX_HISTOGRAM *
+dbStatsSampleIndex(
+    IN DBPOS *pDB,
+    IN char  *szIndexName,
+    IN ULONG  cBuckets
+    )
+/*++
+
+Routine Description:
+
+    Build an equi-depth histogram of an index from a sample of
+    INDEX_STATS_SAMPLES_PER_BUCKET keys per bucket.
+
+    The keys are read by seeking to evenly spaced fractional positions in
+    the index, so the cost is bounded by the size of the sample and not by
+    the size of the index.  The sorted sample gives the inner bucket
+    boundaries; the first and last keys of the index are the outer ones.
+    The number of entries is jet's estimate of the size of the index.  The
+    number of distinct keys is extrapolated from the sample: a key seen more
+    than once is assumed to be a frequent value that the sample has found
+    entirely, and a key seen once is assumed to stand for cEntries/cSamples
+    distinct keys of the index.
+
+    An index no bigger than the sample is walked instead, and captured
+    exactly.
+
+Return Values:
+
+    The new histogram, allocated with malloc, or NULL if the index is empty
+    or could not be sampled.
+
+--*/
+{
+    JET_ERR             err;
+    JET_RECPOS          RecPos;
+    INDEX_HISTOGRAM    *pHist = NULL;
+    INDEX_STATS_SAMPLE *rgSamples = NULL;
+    ULONG               cSamplesMax, cSamples = 0, iSample;
+    BYTE                rgbFirst[DB_CB_MAX_KEY];
+    BYTE                rgbLast[DB_CB_MAX_KEY];
+    ULONG               cbFirst, cbLast;
+    ULONG               cEntries, cDistinct, cSingletons;
+    ULONG               i, ib;
+    BOOL                fExact;
+    BOOL                fSuccess = FALSE;
+
+    err = JetSetCurrentIndex4Warnings(pDB->JetSessID,
+                                      pDB->JetSearchTbl,
+                                      szIndexName,
+                                      NULL,
+                                      0);
+    if (err) {
+        DPRINT2(1, "dbStatsSampleIndex: can't set index %s, err %d\n",
+                szIndexName, err);
+        return NULL;
+    }
+
+    if (JetMoveEx(pDB->JetSessID, pDB->JetSearchTbl, JET_MoveFirst, 0)) {
+        // Empty index, nothing to sample.
+        return NULL;
+    }
+    JetRetrieveKeyEx(pDB->JetSessID, pDB->JetSearchTbl,
+                     rgbFirst, sizeof(rgbFirst), &cbFirst, 0);
+
+    if (JetMoveEx(pDB->JetSessID, pDB->JetSearchTbl, JET_MoveLast, 0)) {
+        return NULL;
+    }
+    JetRetrieveKeyEx(pDB->JetSessID, pDB->JetSearchTbl,
+                     rgbLast, sizeof(rgbLast), &cbLast, 0);
+    JetGetRecordPositionEx(pDB->JetSessID, pDB->JetSearchTbl,
+                           &RecPos, sizeof(RecPos));
+    cEntries = max(1, RecPos.centriesTotal);
+
+    cSamplesMax = cBuckets * INDEX_STATS_SAMPLES_PER_BUCKET;
+    rgSamples = malloc(cSamplesMax * sizeof(INDEX_STATS_SAMPLE));
+    if (!rgSamples) {
+        return NULL;
+    }
+
+    fExact = (cEntries <= cSamplesMax);
+
+    __try {
+        if (fExact) {
+            // Small enough to read it all.
+            if (JetMoveEx(pDB->JetSessID, pDB->JetSearchTbl, JET_MoveFirst, 0)) {
+                __leave;
+            }
+            do {
+                JetRetrieveKeyEx(pDB->JetSessID, pDB->JetSearchTbl,
+                                 rgSamples[cSamples].rgbKey,
+                                 DB_CB_MAX_KEY,
+                                 &rgSamples[cSamples].cbKey,
+                                 0);
+                cSamples++;
+            } while (cSamples < cSamplesMax
+                     && !JetMoveEx(pDB->JetSessID, pDB->JetSearchTbl, JET_MoveNext, 0));
+        }
+        else {
+            // Read the key in the middle of each of cSamplesMax equal slices
+            // of the index.
+            for (iSample = 0; iSample < cSamplesMax; iSample++) {
+                if (eServiceShutdown) {
+                    __leave;
+                }
+
+                RecPos.cbStruct = sizeof(JET_RECPOS);
+                RecPos.centriesLT = 2 * iSample + 1;
+                RecPos.centriesInRange = 1;
+                RecPos.centriesTotal = 2 * cSamplesMax;
+                JetGotoPositionEx(pDB->JetSessID, pDB->JetSearchTbl, &RecPos);
+
+                JetRetrieveKeyEx(pDB->JetSessID, pDB->JetSearchTbl,
+                                 rgSamples[cSamples].rgbKey,
+                                 DB_CB_MAX_KEY,
+                                 &rgSamples[cSamples].cbKey,
+                                 0);
+                cSamples++;
+
+                if (0 == (cSamples % INDEX_STATS_KEYS_PER_TRANSACTION)) {
+                    DBTransOut(pDB, TRUE, TRUE);
+                    DBTransIn(pDB);
+                }
+            }
+        }
+
+        // Fractional positions are approximate, so the sample needn't come
+        // back in key order.
+        qsort(rgSamples, cSamples, sizeof(INDEX_STATS_SAMPLE),
+              dbStatsCompareSamples);
+
+        cDistinct = 0;
+        cSingletons = 0;
+        for (i = 0; i < cSamples; i++) {
+            if (i == 0
+                || dbStatsCompareSamples(&rgSamples[i - 1], &rgSamples[i])) {
+                cDistinct++;
+                if (i + 1 == cSamples
+                    || dbStatsCompareSamples(&rgSamples[i], &rgSamples[i + 1])) {
+                    cSingletons++;
+                }
+            }
+        }
+
+        if (fExact) {
+            cEntries = cSamples;
+        }
+        else {
+            cDistinct = (cDistinct - cSingletons)
+                        + MulDiv(cSingletons, cEntries, cSamples);
+            cDistinct = max(1, min(cDistinct, cEntries));
+        }
+
+        pHist = malloc(sizeof(INDEX_HISTOGRAM));
+        if (!pHist) {
+            __leave;
+        }
+        memset(pHist, 0, sizeof(INDEX_HISTOGRAM));
+        pHist->cEntries = cEntries;
+        pHist->cDistinct = cDistinct;
+        pHist->cBuckets = cBuckets;
+        pHist->rgibBound = malloc((cBuckets + 2) * sizeof(ULONG));
+        pHist->rgbKeys = malloc((cBuckets + 1) * DB_CB_MAX_KEY);
+        if (!pHist->rgibBound || !pHist->rgbKeys) {
+            __leave;
+        }
+
+        for (i = 0, ib = 0; i <= cBuckets; i++) {
+            BYTE  *pbBound;
+            ULONG  cbBound;
+
+            if (i == 0) {
+                pbBound = rgbFirst;
+                cbBound = cbFirst;
+            }
+            else if (i == cBuckets) {
+                pbBound = rgbLast;
+                cbBound = cbLast;
+            }
+            else {
+                iSample = (i * cSamples) / cBuckets;
+                pbBound = rgSamples[iSample].rgbKey;
+                cbBound = rgSamples[iSample].cbKey;
+            }
+
+            pHist->rgibBound[i] = ib;
+            memcpy(pHist->rgbKeys + ib, pbBound, cbBound);
+            ib += cbBound;
+        }
+        pHist->rgibBound[cBuckets + 1] = ib;
+
+        fSuccess = TRUE;
+    }
+    __finally {
+        free(rgSamples);
+        if (!fSuccess) {
+            dbStatsFreeHistogram(pHist);
+            pHist = NULL;
+        }
+    }
+
+    if (pHist) {
+        DPRINT5(1, "Index statistics for %s: %d entries, %d distinct keys, %d buckets, %d keys read\n",
+                szIndexName, pHist->cEntries, pHist->cDistinct, pHist->cBuckets, cSamples);
+    }
+
+    return pHist;
+}
+
+/* RefreshIndexStatistics
+ *
+ * This routine (invoked off of the task queue) rebuilds the histograms of all
+ * the indices the filter optimizer has shown an interest in.
+ *
+ * INPUT:
+ *   A bunch of junk that we don't use, to match the task queue prototype
+ * OUTPUT
+ *   pcSecsUntilNextIteration: When the to schedule this task next
+ */
+void RefreshIndexStatistics (
+    IN  void *  buffer,
+    OUT void ** ppvNext,
+    OUT DWORD * pcSecsUntilNextIteration
+    )
+{
+    THSTATE         *pTHS = pTHStls;
+    char            (*rgszIndex)[MAX_INDEX_NAME] = NULL;
+    ULONG            cIndex = 0, i;
+    ULONG            cBuckets;
+    INDEX_STATS     *pStats;
+    INDEX_HISTOGRAM *pHist, *pOldHist;
+
+    *pcSecsUntilNextIteration = INDEX_STATS_REFRESH_SECS;
+
+    cBuckets = min(gulIndexStatsBuckets, MAX_INDEX_STATS_BUCKETS);
+    if (0 == cBuckets) {
+        return;
+    }
+
+    // Snapshot the names of the indices to sample so that we don't hold the
+    // critical section across jet calls.
+    EnterCriticalSection(&csIndexStats);
+    __try {
+        if (gcIndexStats) {
+            rgszIndex = THAllocEx(pTHS, gcIndexStats * MAX_INDEX_NAME);
+            for (i = 0; i < INDEX_STATS_TABLE_SIZE && cIndex < gcIndexStats; i++) {
+                if (grgIndexStats[i].szIndexName[0]) {
+                    strcpy(rgszIndex[cIndex++], grgIndexStats[i].szIndexName);
+                }
+            }
+        }
+    }
+    __finally {
+        LeaveCriticalSection(&csIndexStats);
+    }
+
+    if (0 == cIndex) {
+        return;
+    }
+
+    Assert(!pTHS->pDB);
+    DBOpen(&pTHS->pDB);
+    __try {
+        DPRINT1(1, "Processing RefreshIndexStatistics request, %d indices\n", cIndex);
+
+        for (i = 0; i < cIndex && !eServiceShutdown; i++) {
+            pHist = dbStatsSampleIndex(pTHS->pDB, rgszIndex[i], cBuckets);
+            if (!pHist) {
+                continue;
+            }
+
+            EnterCriticalSection(&csIndexStats);
+            __try {
+                pStats = dbStatsFindIndex(rgszIndex[i], FALSE);
+                Assert(pStats);
+                pOldHist = pStats->pHistogram;
+                pStats->pHistogram = pHist;
+            }
+            __finally {
+                LeaveCriticalSection(&csIndexStats);
+            }
+
+            // Searches may still be using the old histogram without the
+            // critical section, see dbStatsGetHistogram.
+            if (pOldHist) {
+                dbStatsDelayedFreeHistogram(pOldHist);
+            }
+        }
+    }
+    __finally {
+        DBClose(pTHS->pDB, TRUE);
+        THFreeEx(pTHS, rgszIndex);
+    }
+}
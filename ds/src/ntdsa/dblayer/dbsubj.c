@@ -103,6 +103,10 @@ REVISION HISTORY:
 static ULONG FakeCtr;
 volatile ULONG *pcNameCacheTry = &FakeCtr;
 volatile ULONG *pcNameCacheHit = &FakeCtr;
+volatile ULONG *pcDNReadGlobalHit = &FakeCtr;
+volatile ULONG *pcDNReadGlobalMiss = &FakeCtr;
+volatile ULONG *pcDNReadEntryInvalidate = &FakeCtr;
+volatile ULONG *pcDNReadCacheDrop = &FakeCtr;
 
 /* DNRead flags.*/
 #define DN_READ_SET_CURRENCY        1
@@ -92,8 +92,19 @@ BYTE grgbFauxEncodingBuffer[16];
 // call looking for objects to ship.
 const ULONG gulDraMaxTicksForGetChanges = 60 * 1000;
 
+// Maximum number of objects per second we should ship to replication partners
+// across all DRA_GetNCChanges calls, or 0 for no limit.
+ULONG gulDraMaxOutboundObjsPerSec = DEFAULT_DRA_OUTBOUND_OBJS_PER_SEC;
+
+// Tick at which the next outbound packet may begin to be built when
+// gulDraMaxOutboundObjsPerSec is in effect.  Set to the current tick at
+// startup by GetDRARegistryParameters().
+volatile LONG glDraOutboundNextTick = 0;
+
 // Forward declarations.
 
+void draThrottleOutbound(VOID);
+void draChargeOutbound(ULONG cNumObjects);
 ULONG AcquireRidFsmoLock(DSNAME *pDomainDN, int msToWait);
 VOID  ReleaseRidFsmoLock(DSNAME *pDomainDN);
 BOOL  IsRidFsmoLockHeldByMe();
@@ -1884,6 +1895,13 @@ Return Values:
     // (3) gulDraMaxTicksForGetChanges (msecs) have transpired.
     ulTickToTimeOut = GetTickCount() + gulDraMaxTicksForGetChanges;
 
+    // Honor the outbound object rate limit, if any, for replication partners.
+    // Wait here rather than in the loop below so that we never sleep while
+    // holding a transaction open (and thereby pinning the version store).
+    if (NULL == pFilter) {
+        draThrottleOutbound();
+    }
+
     // Before we start a transaction, determine the lowest uncommitted
     // usn that exists. It's there because transactions can be committed out of USN order.
     // I.e., USNs are allocated sequentially, but they may well not be committed to the
@@ -2076,6 +2094,12 @@ Return Values:
 
         pmsgIn->cMaxObjects = min(pmsgIn->cMaxObjects, ulOutMsgMaxObjects);
         pmsgIn->cMaxBytes = min(pmsgIn->cMaxBytes, ulOutMsgMaxBytes);
+        if ((NULL == pFilter) && gulDraMaxOutboundObjsPerSec) {
+            // Don't build a packet that costs more than a second's worth of
+            // the outbound rate limit.
+            pmsgIn->cMaxObjects = min(pmsgIn->cMaxObjects,
+                                      gulDraMaxOutboundObjsPerSec);
+        }
         pmsgIn->cMaxObjects = max(pmsgIn->cMaxObjects, DRA_MAX_GETCHGREQ_OBJS_MIN);
         pmsgIn->cMaxBytes = max(pmsgIn->cMaxBytes, DRA_MAX_GETCHGREQ_BYTES_MIN);
 
@@ -2090,6 +2114,32 @@ Return Values:
             DRA_EXCEPT(ret, 0);
         }
 
+        if (!(pmsgIn->ulFlags & DRS_ASYNC_REP)) {
+            BOOL fIncludeValues =
+                ( (!(dwDirSyncControlFlags & LDAP_DIRSYNC_PUBLIC_DATA_ONLY)) ||
+                  (dwDirSyncControlFlags & LDAP_DIRSYNC_INCREMENTAL_VALUES) );
+
+            // Start asynchronous reads of the changed-object index range we
+            // are about to walk (and of the changed-value range, if values
+            // will be shipped) so that the leaf pages are arriving while we
+            // are still building the first few objects of the packet.
+            // GetNextObjOrValByUsn() re-seeks these cursors, so their
+            // currency after the preread doesn't matter.
+            DBPrereadNCUsnRange(pTHS->pDB,
+                                pTHS->pDB->JetObjTbl,
+                                fReturnCritical ? Idx_DraUsnCritical : Idx_DraUsn,
+                                dntNC,
+                                usnChangedSeekStart);
+
+            if (pTHS->fLinkedValueReplication && fIncludeValues) {
+                DBPrereadNCUsnRange(pTHS->pDB,
+                                    pTHS->pDB->JetLinkTbl,
+                                    Idx_LinkDraUsn,
+                                    dntNC,
+                                    usnChangedSeekStart);
+            }
+        }
+
         // While we have less than the maximum number of objects, search for
         // next object. We also check to see if the search loop has taken too
         // much time. This can happen when we are finding objects, but filtering
@@ -2497,6 +2547,10 @@ Return Values:
         }
     }
 
+    if (NULL == pFilter) {
+        draChargeOutbound(pmsgOut->cNumObjects);
+    }
+
     // Normal, non-FSMO-transfer exit path.  If we had hit an error, we would
     // have generated an exception -- we didn't, so we're successful.
     ret = 0;
@@ -2531,6 +2585,97 @@ LogAndLeave:
 }
 
 
+void
+draThrottleOutbound(
+    VOID
+    )
+/*++
+
+Routine Description:
+
+    If an outbound object rate limit is configured, wait until the objects
+    shipped by earlier packets have been paid for.  The wait is capped at
+    DRA_OUTBOUND_THROTTLE_MAX_WAIT so a large backlog of debt cannot stall a
+    partner's RPC past its timeout.
+
+    Must be called without a transaction open.
+
+Arguments:
+
+    None.
+
+Return Values:
+
+    None.
+
+--*/
+{
+    DWORD dwTickNow;
+    DWORD dwTickNext;
+    DWORD cTicksWait;
+
+    if (0 == gulDraMaxOutboundObjsPerSec) {
+        return;
+    }
+
+    dwTickNow  = GetTickCount();
+    dwTickNext = (DWORD) glDraOutboundNextTick;
+
+    if (CompareTickTime(dwTickNow, dwTickNext) < 0) {
+        cTicksWait = min(dwTickNext - dwTickNow, DRA_OUTBOUND_THROTTLE_MAX_WAIT);
+        DPRINT1(2, "Throttling outbound replication for %d msecs.\n", cTicksWait);
+        Sleep(cTicksWait);
+    }
+}
+
+
+void
+draChargeOutbound(
+    IN  ULONG   cNumObjects
+    )
+/*++
+
+Routine Description:
+
+    Push the next allowed packet start time out by the time the given number
+    of shipped objects costs at the configured outbound object rate.
+
+Arguments:
+
+    cNumObjects (IN) - Number of objects just shipped.
+
+Return Values:
+
+    None.
+
+--*/
+{
+    ULONG cObjsPerSec = gulDraMaxOutboundObjsPerSec;
+    DWORD dwTickNow;
+    LONG  lTickOld;
+    LONG  lTickNew;
+
+    if ((0 == cObjsPerSec) || (0 == cNumObjects)) {
+        return;
+    }
+
+    dwTickNow = GetTickCount();
+
+    do {
+        lTickOld = glDraOutboundNextTick;
+
+        // Debt doesn't accrue while we're idle; start from now if the last
+        // charge has already been paid off.
+        lTickNew = (CompareTickTime(dwTickNow, (DWORD) lTickOld) > 0)
+                        ? (LONG) dwTickNow
+                        : lTickOld;
+        lTickNew += (LONG) (((ULONGLONG) cNumObjects * 1000) / cObjsPerSec);
+    } while (lTickOld != InterlockedCompareExchange(&glDraOutboundNextTick,
+                                                    lTickNew,
+                                                    lTickOld));
+}
+
+
 void
 moveOrphanToLostAndFound(
     IN      DBPOS *                         pDB,
@@ -76,6 +76,23 @@ REVISION HISTORY:
 // comments in ReplicateNC().
 #define UPDATE_REPSFROM_PACKET_INTERVAL (10)
 
+// Inbound packets with at least this many objects are read ahead by a helper
+// thread while they are applied.  See draStartInboundPrefetch().
+#define DRA_INBOUND_PREFETCH_MIN_OBJS   (32)
+
+// Number of objects the read-ahead thread may get ahead of the apply loop.
+#define DRA_INBOUND_PREFETCH_WINDOW     (64)
+
+typedef struct _DRA_INBOUND_PREFETCH {
+    DWORD           cObjects;
+    GUID *          rgguidObj;      // objectGuid of each object, packet order
+    GUID *          rgguidParent;   // parent's objectGuid, or null GUID
+    volatile LONG   iApplying;      // index of the object being applied
+    volatile BOOL   fStop;
+    HANDLE          hevApplying;    // set when iApplying advances or fStop
+    HANDLE          hThread;
+} DRA_INBOUND_PREFETCH;
+
 // Prototypes
 
 void  GetUSNForExtendedOp(DSNAME *pOwner, DSNAME *pNC, USN_VECTOR *usnvecFrom);
@@ -5555,6 +5572,260 @@ DWORD -
     return ret;
 } /* UpdateNCValuesHelp */
 
+unsigned __stdcall
+draInboundPrefetchThread(
+    IN  PVOID   pv
+    )
+/*++
+
+Routine Description:
+
+    Body of the read-ahead thread started by draStartInboundPrefetch().  Looks
+    up each object of the packet and its parent by objectGuid, staying no more
+    than DRA_INBOUND_PREFETCH_WINDOW objects ahead of the apply loop, so that
+    the pages UpdateRepObj() is about to need are already in the cache.
+
+    Nothing is written.  Lookups that fail (e.g., for objects being created)
+    are ignored, as is any exception; the apply loop does not depend on this
+    thread having done anything.
+
+    The read transaction is closed whenever we catch up with the window so
+    that we never hold back version store cleanup for long.
+
+Arguments:
+
+    pv (IN) - The DRA_INBOUND_PREFETCH, owned by the applying thread.
+
+Return Values:
+
+    0.
+
+--*/
+{
+    DRA_INBOUND_PREFETCH *  pPrefetch = (DRA_INBOUND_PREFETCH *) pv;
+    THSTATE *               pTHS = NULL;
+    DSNAME                  GuidOnlyDN = {0};
+    DWORD                   iObj = 0;
+    DWORD                   cFound = 0;
+    ULONG                   xCode;
+
+    GuidOnlyDN.structLen = DSNameSizeFromLen(0);
+
+    __try {
+        pTHS = InitTHSTATE(CALLERTYPE_INTERNAL);
+        if (NULL == pTHS) {
+            __leave;
+        }
+        pTHS->fDSA = TRUE;
+
+        while ((iObj < pPrefetch->cObjects)
+               && !pPrefetch->fStop
+               && !eServiceShutdown) {
+
+            if (iObj >= (DWORD) pPrefetch->iApplying + DRA_INBOUND_PREFETCH_WINDOW) {
+                WaitForSingleObject(pPrefetch->hevApplying, 1000);
+                continue;
+            }
+
+            DBOpen2(TRUE, &pTHS->pDB);
+            __try {
+                while ((iObj < pPrefetch->cObjects)
+                       && (iObj < (DWORD) pPrefetch->iApplying + DRA_INBOUND_PREFETCH_WINDOW)
+                       && !pPrefetch->fStop) {
+
+                    GuidOnlyDN.Guid = pPrefetch->rgguidObj[iObj];
+                    if (!DBFindGuid(pTHS->pDB, &GuidOnlyDN)) {
+                        cFound++;
+                    }
+
+                    if (!fNullUuid(&pPrefetch->rgguidParent[iObj])) {
+                        GuidOnlyDN.Guid = pPrefetch->rgguidParent[iObj];
+                        DBFindGuid(pTHS->pDB, &GuidOnlyDN);
+                    }
+
+                    iObj++;
+                }
+            } __finally {
+                DBClose(pTHS->pDB, TRUE);
+            }
+        }
+    } __except (HandleMostExceptions(xCode = GetExceptionCode())) {
+        DPRINT1(0, "Inbound read-ahead abandoned, exception 0x%x.\n", xCode);
+    }
+
+    DPRINT2(2, "Inbound read-ahead looked up %d objects (%d present).\n",
+            iObj, cFound);
+
+    if (NULL != pTHS) {
+        free_thread_state();
+    }
+
+    return 0;
+}
+
+
+DRA_INBOUND_PREFETCH *
+draStartInboundPrefetch(
+    IN  REPLENTINFLIST *    pResults
+    )
+/*++
+
+Routine Description:
+
+    Start reading ahead the objects of an inbound packet on a helper thread.
+
+    The objects are still applied one at a time, in packet order, on the
+    replication thread -- the USN and up-to-dateness vector semantics of
+    UpdateNC() rely on the applied objects always being a prefix of the
+    packet.  What we move off that thread is the cold-cache reads of the
+    objectGuid index and of the object and parent records that dominate the
+    apply time of large packets (e.g., when promoting a GC or catching up
+    after a long outage).
+
+    The GUIDs are copied up front, since the apply loop modifies the packet
+    as it goes.
+
+Arguments:
+
+    pResults (IN) - The packet's objects.
+
+Return Values:
+
+    The read-ahead context, to be passed to draAdvanceInboundPrefetch() and
+    draStopInboundPrefetch(), or NULL if the packet is too small to benefit or
+    the thread could not be started.
+
+--*/
+{
+    DRA_INBOUND_PREFETCH *  pPrefetch;
+    REPLENTINFLIST *        pentinflist;
+    DWORD                   cObjects = 0;
+    DWORD                   iObj;
+    unsigned                tid;
+
+    for (pentinflist = pResults;
+         pentinflist != NULL;
+         pentinflist = pentinflist->pNextEntInf) {
+        cObjects++;
+    }
+
+    if (cObjects < DRA_INBOUND_PREFETCH_MIN_OBJS) {
+        return NULL;
+    }
+
+    pPrefetch = malloc(sizeof(*pPrefetch) + 2 * cObjects * sizeof(GUID));
+    if (NULL == pPrefetch) {
+        return NULL;
+    }
+
+    memset(pPrefetch, 0, sizeof(*pPrefetch));
+    pPrefetch->cObjects = cObjects;
+    pPrefetch->rgguidObj = (GUID *) (pPrefetch + 1);
+    pPrefetch->rgguidParent = pPrefetch->rgguidObj + cObjects;
+
+    for (pentinflist = pResults, iObj = 0;
+         pentinflist != NULL;
+         pentinflist = pentinflist->pNextEntInf, iObj++) {
+        pPrefetch->rgguidObj[iObj] = pentinflist->Entinf.pName->Guid;
+        if (NULL != pentinflist->pParentGuid) {
+            pPrefetch->rgguidParent[iObj] = *pentinflist->pParentGuid;
+        } else {
+            memset(&pPrefetch->rgguidParent[iObj], 0, sizeof(GUID));
+        }
+    }
+
+    pPrefetch->hevApplying = CreateEvent(NULL, FALSE, FALSE, NULL);
+    if (NULL == pPrefetch->hevApplying) {
+        free(pPrefetch);
+        return NULL;
+    }
+
+    pPrefetch->hThread = (HANDLE) _beginthreadex(NULL,
+                                                 0,
+                                                 draInboundPrefetchThread,
+                                                 pPrefetch,
+                                                 0,
+                                                 &tid);
+    if (NULL == pPrefetch->hThread) {
+        DPRINT1(0, "Failed to start inbound read-ahead thread, error %d.\n",
+                GetLastError());
+        CloseHandle(pPrefetch->hevApplying);
+        free(pPrefetch);
+        return NULL;
+    }
+
+    return pPrefetch;
+}
+
+
+void
+draAdvanceInboundPrefetch(
+    IN  DRA_INBOUND_PREFETCH *  pPrefetch,
+    IN  DWORD                   iApplying
+    )
+/*++
+
+Routine Description:
+
+    Tell the read-ahead thread that the apply loop has moved on to the given
+    object, widening its window.
+
+Arguments:
+
+    pPrefetch (IN) - Read-ahead context, or NULL if there is none.
+
+    iApplying (IN) - Index of the object about to be applied.
+
+Return Values:
+
+    None.
+
+--*/
+{
+    if (NULL == pPrefetch) {
+        return;
+    }
+
+    InterlockedExchange(&pPrefetch->iApplying, (LONG) iApplying);
+    SetEvent(pPrefetch->hevApplying);
+}
+
+
+void
+draStopInboundPrefetch(
+    IN  DRA_INBOUND_PREFETCH *  pPrefetch
+    )
+/*++
+
+Routine Description:
+
+    Stop the read-ahead thread, wait for it to exit, and free its context.
+
+Arguments:
+
+    pPrefetch (IN) - Read-ahead context, or NULL if there is none.
+
+Return Values:
+
+    None.
+
+--*/
+{
+    if (NULL == pPrefetch) {
+        return;
+    }
+
+    pPrefetch->fStop = TRUE;
+    SetEvent(pPrefetch->hevApplying);
+
+    WaitForSingleObject(pPrefetch->hThread, INFINITE);
+
+    CloseHandle(pPrefetch->hThread);
+    CloseHandle(pPrefetch->hevApplying);
+    free(pPrefetch);
+}
+
+
 // Note:- When UpdateNC() returns successfully, contents of pdwNCModified tells if
 //          the NC has been modified or not.
 //          MODIFIED_NOTHING, if nothing in the NC has been modified;
@@ -5610,6 +5881,8 @@ UpdateNC(
     SYNTAX_INTEGER          it;
     BOOL                    fIsPreemptable = !!(UpdNCFlags & UPDNC_IS_PREEMTABLE);
     BOOL                    fExistingNC = !!(UpdNCFlags & UPDNC_EXISTING_NC);
+    DRA_INBOUND_PREFETCH *  pPrefetch = NULL;
+    DWORD                   iEntInf = 0;
 
     // assume no modification
     *pdwNCModified = MODIFIED_NOTHING;
@@ -5760,12 +6033,19 @@ UpdateNC(
              __leave;
         }
 
+        // Start reading ahead the objects we're about to apply.
+        pPrefetch = draStartInboundPrefetch(pResults);
+
         for (pentinflist = pResults;
              pentinflist != NULL;
              pentinflist = fRetry ? pentinflist : pentinflist->pNextEntInf) {
 
             // fMoveToLostAndFound implies fRetry.
             Assert(!(fMoveToLostAndFound && !fRetry));
+
+            if (!fRetry) {
+                draAdvanceInboundPrefetch(pPrefetch, iEntInf++);
+            }
  
         __try { 
         ret = DRAERR_Generic;
@@ -6276,6 +6556,8 @@ UpdateNC(
             pTHS->pDB->fScopeLegacyLinks = FALSE;
         }
 
+        draStopInboundPrefetch(pPrefetch);
+
         if (fTransStarted) {
             ret1 = EndDraTransactionSafe (!(ret || AbnormalTermination()));
             if (ret == 0 && ret1 != 0) {
@@ -27,6 +27,12 @@ REVISION HISTORY:
 
 #include <taskq.h>
 
+// Task queue concurrency class of the long-running database cleanup tasks
+// (garbage collection, link cleanup, dynamic object expiry and stale phantom
+// cleanup).  They run one at a time on their own worker so that a long pass
+// doesn't hold up the rest of the task queue.
+#define TQ_CLASS_CLEANUP    ( 1 )
+
 extern void TQ_BuildHierarchyTable(     void *, void **, DWORD * );
 extern void TQ_DelayedFreeMemory(       void *, void **, DWORD * );
 extern void TQ_SynchronizeReplica(      void *, void **, DWORD * );
@@ -51,6 +57,7 @@ extern void TQ_CheckFullSyncProgress(   void *, void **, DWORD * );
 extern void TQ_CheckGCPromotionProgress(void *, void **, DWORD * );
 extern void TQ_CountAncestorsIndexSize (void *, void **, DWORD * );
 extern void TQ_RefreshUserMemberships  (void *, void **, DWORD * );
+extern void TQ_RefreshIndexStatistics  (void *, void **, DWORD * );
 extern void TQ_LinkCleanup(             void *, void **, DWORD * );
 extern void TQ_DeleteExpiredEntryTTLMain(void *,void **, DWORD * );
 extern void TQ_RebuildCatalog(          void *, void **, DWORD * );
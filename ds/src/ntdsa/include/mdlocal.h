@@ -1735,11 +1735,16 @@ extern ULONG gcSearchExpensiveThreshold;
 extern ULONG gulIntersectExpenseRatio;
 extern ULONG gulMaxRecordsWithoutIntersection;
 extern ULONG gulEstimatedAncestorsIndexSize;
+extern ULONG gulIndexStatsBuckets;
+extern ULONG gulIntersectMemoryBudget;
+extern ULONG gulDNReadCacheBudget;
 extern ULONG gulReplQueueCheckTime;
 extern ULONG gulLdapIntegrityPolicy;
 extern ULONG gulDraCompressionLevel;
 extern ULONG gulUnlockSystemSubtree;
 extern ULONG gulDraCompressionAlg;
+extern ULONG gulDraMaxOutboundObjsPerSec;
+extern volatile LONG glDraOutboundNextTick;
 
 //
 // Defines whether DSID will be returned.  Since DSID can reveal
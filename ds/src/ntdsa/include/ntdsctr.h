@@ -173,11 +173,15 @@
 #define NTDSAPIREADS            284
 #define SAM_ACCT_GROUP_LATENCY  286
 #define SAM_RES_GROUP_LATENCY   288
+#define DNREAD_GLOBAL_HIT       290
+#define DNREAD_GLOBAL_MISS      292
+#define DNREAD_ENTRY_INVALIDATE 294
+#define DNREAD_CACHE_DROP       296
 
 #define DSA_PERF_COUNTER_BLOCK  TEXT("Global\\Microsoft.Windows.NTDS.Perf")
 
 //If the last counter changes, DSA_LAST_COUNTER_INDEX need to be changed
-#define DSA_LAST_COUNTER_INDEX SAM_RES_GROUP_LATENCY
+#define DSA_LAST_COUNTER_INDEX DNREAD_CACHE_DROP
 
 extern volatile unsigned long * pcBrowse;
 extern volatile unsigned long * pcSDProps;
@@ -263,6 +267,10 @@ extern volatile unsigned long * pcLdapClosedConnsPerSec;
 extern volatile unsigned long * pcLdapSSLConnsPerSec;
 extern volatile unsigned long * pcSAMAcctGroupLatency;
 extern volatile unsigned long * pcSAMResGroupLatency;
+extern volatile unsigned long * pcDNReadGlobalHit;
+extern volatile unsigned long * pcDNReadGlobalMiss;
+extern volatile unsigned long * pcDNReadEntryInvalidate;
+extern volatile unsigned long * pcDNReadCacheDrop;
 
 
 // Replication-specific counters.
@@ -375,8 +383,9 @@ extern size_t cbPerfCounterData;
 // 15, Jan, 2001, rrandall, remove "LDAP Successful Binds" counter
 // 16, Aug, 2001, t-kchan, remove LDAP_THREADS_* counters
 // 17, Oct, 2002, colinbr, add group evaluation latency counters
+// 18, add global DN read cache counters
 
-#define NTDS_PERFORMANCE_COUNTER_VERSION 17
+#define NTDS_PERFORMANCE_COUNTER_VERSION 18
 
          
 //The size of the shared memory block for communication between 
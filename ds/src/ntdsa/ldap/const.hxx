@@ -72,6 +72,15 @@ Author:
 
 #define SIZEINCREMENT                (4 * 1024)
 
+//
+//  Send segments.  Scatter-gather sends (e.g. large search results) take their
+//  buffers from a pool of fixed size segments carved out of one reserved
+//  region, instead of allocating and growing a heap buffer for each one.
+//
+
+#define LDAP_SEND_SEGMENT_SIZE       (64 * 1024)
+#define LDAP_SEND_SEGMENT_COUNT      256
+
 //
 // Valid Security Descriptor flag
 //
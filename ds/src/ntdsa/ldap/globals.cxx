@@ -79,6 +79,21 @@ DWORD            LdapRequestsCached = 0;
 DWORD            LdapBlockCacheLimit = 64;
 DWORD            LdapBufferAllocs = 0;
 
+//
+// send segment pool
+//
+
+PUCHAR           LdapSendSegmentArena = NULL;
+LONG             LdapSendSegmentsCarved = 0;
+SLIST_HEADER     LdapSendSegmentList;
+
+//
+// carved segments whose commit failed, one bit each, to be retried
+//
+
+LONG             LdapSendSegmentsToRetry[LDAP_SEND_SEGMENT_COUNT / 32] = {0};
+LONG             LdapSendSegmentsToRetryCount = 0;
+
 //
 // Limits
 //
@@ -459,6 +474,23 @@ Return Value:
         return FALSE;
     }
 
+    //
+    // Reserve the send segment pool.  Segments are committed the first time
+    // they are handed out.  If we can't reserve it, sends just don't use
+    // segments.
+    //
+
+    InitializeSListHead(&LdapSendSegmentList);
+    LdapSendSegmentArena = (PUCHAR)VirtualAlloc(NULL,
+                                        LDAP_SEND_SEGMENT_COUNT * LDAP_SEND_SEGMENT_SIZE,
+                                        MEM_RESERVE,
+                                        PAGE_READWRITE);
+    IF_DEBUG(WARNING) {
+        if ( LdapSendSegmentArena == NULL ) {
+            DPRINT1(0,"Unable to reserve send segments. Err %d\n",GetLastError());
+        }
+    }
+
     InitializeListHead( &ActiveConnectionsList);
     if (!InitializeCriticalSectionAndSpinCount(
                             &csConnectionsListLock,
@@ -636,6 +668,19 @@ Return Value:
 
     DestroyLimits( );
 
+    //
+    // All requests are gone, so every segment is back in the pool.
+    //
+
+    if ( LdapSendSegmentArena != NULL ) {
+        InterlockedFlushSList(&LdapSendSegmentList);
+        VirtualFree(LdapSendSegmentArena, 0, MEM_RELEASE);
+        LdapSendSegmentArena = NULL;
+        LdapSendSegmentsCarved = 0;
+        ZeroMemory(LdapSendSegmentsToRetry, sizeof(LdapSendSegmentsToRetry));
+        LdapSendSegmentsToRetryCount = 0;
+    }
+
     if (LdapBufferAllocs != 0) {
         IF_DEBUG(WARNING) {
             DPRINT1(0,"LdapBufferAllocs %x\n", LdapBufferAllocs);
@@ -652,6 +697,161 @@ Return Value:
 
 } // Destroy Globals
 
+
+PVOID
+LdapCommitSendSegment(
+    IN LONG iSegment
+    )
+/*++
+
+Routine Description:
+
+    Commit segment iSegment of the reserved region.  If the commit fails
+    the segment is remembered so a later LdapAllocSendSegment retries it,
+    instead of the slot being lost for good.
+
+Arguments:
+
+    iSegment - the segment to commit.
+
+Return Value:
+
+    The segment, or NULL if it couldn't be committed.
+
+--*/
+{
+    PVOID pSegment;
+    LONG  bit = 1 << (iSegment % 32);
+    LONG  old;
+
+    pSegment = VirtualAlloc(LdapSendSegmentArena + iSegment * LDAP_SEND_SEGMENT_SIZE,
+                            LDAP_SEND_SEGMENT_SIZE,
+                            MEM_COMMIT,
+                            PAGE_READWRITE);
+    if ( pSegment != NULL ) {
+        return pSegment;
+    }
+
+    IF_DEBUG(WARNING) {
+        DPRINT2(0,"Unable to commit send segment %d. Err %d\n",
+                iSegment, GetLastError());
+    }
+
+    do {
+        old = LdapSendSegmentsToRetry[iSegment / 32];
+    } while ( InterlockedCompareExchange(&LdapSendSegmentsToRetry[iSegment / 32],
+                                         old | bit,
+                                         old) != old );
+    InterlockedIncrement(&LdapSendSegmentsToRetryCount);
+
+    return NULL;
+
+} // LdapCommitSendSegment
+
+
+PVOID
+LdapAllocSendSegment(
+    VOID
+    )
+/*++
+
+Routine Description:
+
+    Get a LDAP_SEND_SEGMENT_SIZE byte send buffer from the segment pool.
+    Freed segments are reused first, then segments whose commit failed
+    earlier are retried.  Otherwise the next never used segment of the
+    reserved region is committed.
+
+Arguments:
+
+    None.
+
+Return Value:
+
+    The segment, or NULL if the pool is exhausted.  Callers fall back to
+    LdapAlloc.
+
+--*/
+{
+    PSLIST_ENTRY pEntry;
+    LONG iSegment;
+    LONG i;
+    LONG old;
+    LONG bit;
+
+    pEntry = InterlockedPopEntrySList(&LdapSendSegmentList);
+    if ( pEntry != NULL ) {
+        return pEntry;
+    }
+
+    if ( LdapSendSegmentArena == NULL ) {
+        return NULL;
+    }
+
+    //
+    // Claim a segment that failed to commit before and try it again.
+    //
+
+    for ( i = 0;
+          (LdapSendSegmentsToRetryCount > 0) && (i < LDAP_SEND_SEGMENT_COUNT / 32);
+          i++ ) {
+
+        while ( (old = LdapSendSegmentsToRetry[i]) != 0 ) {
+            bit = old & -old;
+            if ( InterlockedCompareExchange(&LdapSendSegmentsToRetry[i],
+                                            old & ~bit,
+                                            old) != old ) {
+                continue;
+            }
+
+            InterlockedDecrement(&LdapSendSegmentsToRetryCount);
+
+            for ( iSegment = i * 32; !(bit & 1); bit = (ULONG)bit >> 1 ) {
+                iSegment++;
+            }
+
+            return LdapCommitSendSegment(iSegment);
+        }
+    }
+
+    iSegment = InterlockedIncrement(&LdapSendSegmentsCarved) - 1;
+    if ( iSegment >= LDAP_SEND_SEGMENT_COUNT ) {
+        return NULL;
+    }
+
+    return LdapCommitSendSegment(iSegment);
+
+} // LdapAllocSendSegment
+
+
+VOID
+LdapFreeSendSegment(
+    IN PVOID Segment
+    )
+/*++
+
+Routine Description:
+
+    Return a segment obtained from LdapAllocSendSegment to the pool.  The
+    segment stays committed.
+
+Arguments:
+
+    Segment - the segment to free.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    Assert(IsLdapSendSegment(Segment));
+    Assert(((ULONG_PTR)Segment % LDAP_SEND_SEGMENT_SIZE) == 0);
+
+    InterlockedPushEntrySList(&LdapSendSegmentList, (PSLIST_ENTRY)Segment);
+
+} // LdapFreeSendSegment
+
 
 VOID
 CloseConnections( VOID )
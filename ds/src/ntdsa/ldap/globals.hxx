@@ -50,6 +50,8 @@ extern DWORD LdapRequestsCached;
 extern DWORD LdapBlockCacheLimit;
 extern DWORD LdapBufferAllocs;
 
+extern PUCHAR LdapSendSegmentArena;
+
 extern LARGE_INTEGER LdapFrequencyConstant;
 
 extern CRITICAL_SECTION  LdapSslLock;
@@ -252,6 +254,16 @@ DestroyGlobals(
     VOID
     );
 
+PVOID
+LdapAllocSendSegment(
+    VOID
+    );
+
+VOID
+LdapFreeSendSegment(
+    IN PVOID Segment
+    );
+
 PLDAP_CONN
 AllocNewConnection(
         IN BOOL fSkipCount,
@@ -311,6 +323,31 @@ LdapFree(
 
 } // LdapFree
 
+inline
+BOOL
+IsLdapSendSegment(
+    IN PVOID Buffer
+    )
+{
+    return (LdapSendSegmentArena != NULL) &&
+           ((PUCHAR)Buffer >= LdapSendSegmentArena) &&
+           ((PUCHAR)Buffer < LdapSendSegmentArena +
+                             LDAP_SEND_SEGMENT_COUNT * LDAP_SEND_SEGMENT_SIZE);
+} // IsLdapSendSegment
+
+inline
+VOID
+LdapFreeSendBuffer(
+    IN PVOID Buffer
+    )
+{
+    if ( IsLdapSendSegment(Buffer) ) {
+        LdapFreeSendSegment(Buffer);
+    } else {
+        LdapFree(Buffer);
+    }
+} // LdapFreeSendBuffer
+
 #undef FILENO
 
 #endif // _GLOBALS_HXX_
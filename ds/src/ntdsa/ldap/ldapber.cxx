@@ -1618,9 +1618,21 @@ Return Value:
 
             if ( lenNeeded > Request->GetSendBufferSize( ) ) {
 
-                if ( !Request->GrowSend(fFirstTime ? 
-                                        lenNeeded * 2 : 
-                                        lenNeeded * ObjectCount) ) {
+                DWORD growSize = fFirstTime ? 
+                                    lenNeeded * 2 : 
+                                    lenNeeded * ObjectCount;
+
+                //
+                // Don't ask for more than a send segment holds unless this
+                // one entry needs it, so that the growth can be satisfied from
+                // the segment pool.
+                //
+
+                if ( growSize > LDAP_SEND_SEGMENT_SIZE ) {
+                    growSize = max(lenNeeded, LDAP_SEND_SEGMENT_SIZE);
+                }
+
+                if ( !Request->GrowSend(growSize) ) {
                     Code = other;
                     goto exit;
                 }
@@ -1164,7 +1164,13 @@ Return Value:
             // limited to about 8K
             //
 
-            if ( (m_wsaBufCount != 1) || (GrowthSize <= 2*SIZEINCREMENT) || !CanScatterGather() ) {
+            //
+            // Send segments are fixed size, they can't be expanded.
+            //
+
+            if ( IsLdapSendSegment(buf->buf) ) {
+                NewStart = NULL;
+            } else if ( (m_wsaBufCount != 1) || (GrowthSize <= 2*SIZEINCREMENT) || !CanScatterGather() ) {
 
                 NewStart = (PUCHAR)LocalReAlloc(
                                 buf->buf,
@@ -1197,11 +1203,21 @@ Return Value:
                     PackLastSendBuffer( );
 
                     //
-                    // Adjust size 
+                    // Adjust size.  Use a whole send segment if the request
+                    // fits in one, so the next few entries need no growing.
                     //
 
                     GrowthSize = requestSize;
-                    NewStart = (PUCHAR)LdapAlloc(GrowthSize);
+                    if ( requestSize <= LDAP_SEND_SEGMENT_SIZE ) {
+                        NewStart = (PUCHAR)LdapAllocSendSegment();
+                        if ( NewStart != NULL ) {
+                            GrowthSize = LDAP_SEND_SEGMENT_SIZE;
+                        }
+                    }
+
+                    if ( NewStart == NULL ) {
+                        NewStart = (PUCHAR)LdapAlloc(GrowthSize);
+                    }
 
                     IF_DEBUG(SEND) {
                         DPRINT2(0,"GrowSend: Allocated %x length %d instead\n",
@@ -1309,7 +1325,7 @@ Return Value:
     m_nextBufferPtr = NULL;
     if (m_sendBufAllocList) {
         for (i=0; m_sendBufAllocList[i]; i++) {
-            LdapFree(m_sendBufAllocList[i]);
+            LdapFreeSendBuffer(m_sendBufAllocList[i]);
         }
         if (m_sendBufAllocList != m_builtinSendBufAllocList) {
             LdapFree(m_sendBufAllocList);
@@ -1324,7 +1340,7 @@ Return Value:
             }
 
             if ( m_wsaBuf[i].buf != NULL ) {
-                LdapFree(m_wsaBuf[i].buf);
+                LdapFreeSendBuffer(m_wsaBuf[i].buf);
             }
         }
     }
@@ -1938,7 +1954,7 @@ Return Value:
         DPRINT2(0,"Freed %x replaced by %x\n", m_wsaBuf[0].buf, pSealedData);
     }
 
-    LdapFree(m_wsaBuf[0].buf);
+    LdapFreeSendBuffer(m_wsaBuf[0].buf);
     m_wsaBuf[0].len = (DWORD)(pNextFree - pSealedData);
     m_wsaBuf[0].buf = (PCHAR)pSealedData;
     SetBufferPtr(pNextFree);
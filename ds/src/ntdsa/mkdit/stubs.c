@@ -122,4 +122,22 @@ DoTriggerTaskSynchronously(
     return ERROR_SUCCESS;
 }
 
+BOOL
+SetTaskQueueClass(
+    PTASKQFN    pfnTaskQFn,
+    DWORD       iClass
+    )
+{
+    return TRUE;
+}
+
+DWORD
+GetTaskQueueStats(
+    TASKQ_STATS *   rgStats,
+    DWORD           cStats
+    )
+{
+    return 0;
+}
+
 /* end of taskq.lib */
@@ -118,6 +118,7 @@ extern DNList *pAddListHead;
 extern CRITICAL_SECTION csUncUsn;
 extern CRITICAL_SECTION csSessions;
 extern CRITICAL_SECTION csDNReadLevel1List;
+extern CRITICAL_SECTION csIndexStats;
 extern CRITICAL_SECTION csDNReadLevel2List;
 extern CRITICAL_SECTION csDNReadGlobalCache;
 extern CRITICAL_SECTION csHiddenDBPOS;
@@ -542,6 +543,10 @@ volatile unsigned long * pcDRARemReplUpdLnk;
 volatile unsigned long * pcDRARemReplUpdTot;
 volatile unsigned long * pcSAMAcctGroupLatency;
 volatile unsigned long * pcSAMResGroupLatency;
+volatile unsigned long * pcDNReadGlobalHit;
+volatile unsigned long * pcDNReadGlobalMiss;
+volatile unsigned long * pcDNReadEntryInvalidate;
+volatile unsigned long * pcDNReadCacheDrop;
 
 
 // Mapping of DSSTAT_* to counter variables
@@ -1539,6 +1544,9 @@ Return Value:
         // schedule ancestors index size estimation in 5 minutes.
         InsertInTaskQueue(TQ_CountAncestorsIndexSize,NULL,FIVE_MINS);
 
+        // schedule index statistics sampling in 5 minutes.
+        InsertInTaskQueue(TQ_RefreshIndexStatistics,NULL,FIVE_MINS);
+
         // schedule ValidateDsaDomain to start immediately.
         InsertInTaskQueue(TQ_ValidateDsaDomain, NULL, 0);
 
@@ -2467,6 +2475,7 @@ void DsInitializeCritSecs()
         fCritsec = fCritsec
             && InitializeCriticalSectionAndSpinCount(&csDNReadLevel2List, 4000);
         InitializeCriticalSection(&csDNReadGlobalCache);
+        InitializeCriticalSection(&csIndexStats);
         SyncCreateBinaryLock(&blDNReadInvalidateData);
         InitializeCriticalSection(&csSessions);
         InitializeCriticalSection(&csJetColumnUpdate);
@@ -3339,6 +3348,13 @@ DoInitialize(int argc, char * argv[], unsigned fInitAdvice,
         }
         gfTaskSchedulerInitialized = TRUE;
 
+        // Run the database cleanup tasks off the scheduler thread.  Failure
+        // just leaves them running on the scheduler thread.
+        SetTaskQueueClass(TQ_GarbageCollection, TQ_CLASS_CLEANUP);
+        SetTaskQueueClass(TQ_LinkCleanup, TQ_CLASS_CLEANUP);
+        SetTaskQueueClass(TQ_DeleteExpiredEntryTTLMain, TQ_CLASS_CLEANUP);
+        SetTaskQueueClass(TQ_StalePhantomCleanup, TQ_CLASS_CLEANUP);
+
         // only register signal handlers interactively
         if (!gfRunningInsideLsa)
             init_signals();
@@ -4542,6 +4558,10 @@ void PerfInit()
         pcDRARemReplUpdTot    = pCounterBlock                + COUNTER_OFFSET(DRA_REM_REPL_UPD_TOT);
         pcSAMAcctGroupLatency = pCounterBlock                + COUNTER_OFFSET(SAM_ACCT_GROUP_LATENCY);
         pcSAMResGroupLatency  = pCounterBlock                + COUNTER_OFFSET(SAM_RES_GROUP_LATENCY);
+        pcDNReadGlobalHit     = pCounterBlock                + COUNTER_OFFSET(DNREAD_GLOBAL_HIT);
+        pcDNReadGlobalMiss    = pCounterBlock                + COUNTER_OFFSET(DNREAD_GLOBAL_MISS);
+        pcDNReadEntryInvalidate = pCounterBlock              + COUNTER_OFFSET(DNREAD_ENTRY_INVALIDATE);
+        pcDNReadCacheDrop     = pCounterBlock                + COUNTER_OFFSET(DNREAD_CACHE_DROP);
 
         cbPerfCounterData = ((DSA_LAST_COUNTER_INDEX/2 + 1) * sizeof(unsigned long));
         cbPerfCounterData = ((cbPerfCounterData + cbPerfCounterDataAlign - 1) / cbPerfCounterDataAlign) * cbPerfCounterDataAlign;
@@ -4598,6 +4618,8 @@ void PerfInit()
           pcDRAReplQueueOps = pcDRATdsInGetChngs = pcDRATdsInGetChngsWSem =
           pcDRARemReplUpdLnk = pcDRARemReplUpdTot =
           pcSAMAcctGroupLatency = pcSAMResGroupLatency = 
+          pcDNReadGlobalHit = pcDNReadGlobalMiss =
+          pcDNReadEntryInvalidate = pcDNReadCacheDrop =
                 &DummyCounter;
 
           cbPerfCounterData = 0;
@@ -4755,6 +4777,7 @@ void GetDRARegistryParameters()
         {DRA_REPL_QUEUE_CHECK_TIME,   DEFAULT_DRA_REPL_QUEUE_CHECK_TIME,   MINS_IN_SECS, &gulReplQueueCheckTime},
         {DRA_REPL_COMPRESSION_LEVEL,  DEFAULT_DRA_REPL_COMPRESSION_LEVEL,  1,            &gulDraCompressionLevel},
         {DRA_REPL_COMPRESSION_ALG,  DEFAULT_DRA_REPL_COMPRESSION_ALG,  1,            &gulDraCompressionAlg},
+        {DRA_OUTBOUND_OBJS_PER_SEC,   DEFAULT_DRA_OUTBOUND_OBJS_PER_SEC,   1,            &gulDraMaxOutboundObjsPerSec},
         {DSA_THREAD_STATE_HEAP_LIMIT, DEFAULT_THREAD_STATE_HEAP_LIMIT,     1,            &gcMaxHeapMemoryAllocForTHSTATE},
     };
 
@@ -4773,6 +4796,11 @@ void GetDRARegistryParameters()
                                                      rgValues[i].ulMultiplier);
     }
 
+    // The outbound throttle compares its next tick against GetTickCount(), so
+    // it has to start from the current tick; a start of 0 looks like a debt
+    // of up to 2^31 ticks once the tick count is more than that past zero.
+    glDraOutboundNextTick = (LONG) GetTickCount();
+
 #if DBG
     // Debug hook to enable LVR
     if (fWasPreviouslyLVR) {
@@ -4973,6 +5001,9 @@ void __cdecl DSLoadDynamicRegParams()
         {DB_INEFFICIENT_SEARCH_THRESHOLD, DEFAULT_DB_INEFFICIENT_SEARCH_THRESHOLD, 1,    &gcSearchInefficientThreshold},
         {DB_INTERSECT_THRESHOLD, DEFAULT_DB_INTERSECT_THRESHOLD, 1, &gulMaxRecordsWithoutIntersection},
         {DB_INTERSECT_RATIO, DEFAULT_DB_INTERSECT_RATIO, 1, &gulIntersectExpenseRatio},
+        {DB_INDEX_STATS_BUCKETS, DEFAULT_DB_INDEX_STATS_BUCKETS, 1, &gulIndexStatsBuckets},
+        {DB_INTERSECT_MEMORY_BUDGET, DEFAULT_DB_INTERSECT_MEMORY_BUDGET, 1024, &gulIntersectMemoryBudget},
+        {DB_DNREAD_CACHE_BUDGET, DEFAULT_DB_DNREAD_CACHE_BUDGET, 1024, &gulDNReadCacheBudget},
         {LDAP_INTEGRITY_POLICY_KEY, 0, 1, &gulLdapIntegrityPolicy},
 
         // GCverify time parameters
@@ -79,6 +79,7 @@ void CheckFullSyncProgress (      void *, void **, DWORD * );
 void CheckGCPromotionProgress (   void *, void **, DWORD * );
 void CountAncestorsIndexSize  (   void *, void **, DWORD * ); 
 void RefreshUserMemberships   (   void *, void **, DWORD * ); 
+void RefreshIndexStatistics   (   void *, void **, DWORD * );
 void LinkCleanupMain(             void *, void **, DWORD * );
 void DeleteExpiredEntryTTLMain(   void *, void **, DWORD * );
 void DeferredHeapLogEvent(        void *, void **, DWORD * );
@@ -146,6 +147,7 @@ TQ_DEFINE_INIT_THS_WRAPPER( TQ_CheckFullSyncProgress, CheckFullSyncProgress )
 TQ_DEFINE_INIT_THS_WRAPPER( TQ_CheckGCPromotionProgress, CheckGCPromotionProgress)
 TQ_DEFINE_INIT_THS_WRAPPER( TQ_CountAncestorsIndexSize, CountAncestorsIndexSize)
 TQ_DEFINE_INIT_THS_WRAPPER( TQ_RefreshUserMemberships, RefreshUserMemberships)
+TQ_DEFINE_INIT_THS_WRAPPER( TQ_RefreshIndexStatistics, RefreshIndexStatistics)
 TQ_DEFINE_INIT_THS_WRAPPER( TQ_LinkCleanup         , LinkCleanupMain )
 TQ_DEFINE_INIT_THS_WRAPPER( TQ_DeleteExpiredEntryTTLMain, DeleteExpiredEntryTTLMain )
 TQ_DEFINE_INIT_THS_WRAPPER( TQ_RebuildCatalog      , RebuildCatalog )
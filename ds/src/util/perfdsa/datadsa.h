@@ -282,9 +282,13 @@ typedef struct _DSA_COUNTER_DATA {
 #define NUM_NTDSAPIREADS_OFFSET             NUM_NTDSAPISEARCHES_OFFSET + sizeof(DWORD)
 #define NUM_SAM_ACCT_GROUP_LATENCY_OFFSET   NUM_NTDSAPIREADS_OFFSET + sizeof(DWORD)
 #define NUM_SAM_RES_GROUP_LATENCY_OFFSET    NUM_SAM_ACCT_GROUP_LATENCY_OFFSET + sizeof(DWORD)
+#define NUM_DNREAD_GLOBAL_HIT_OFFSET        NUM_SAM_RES_GROUP_LATENCY_OFFSET + sizeof(DWORD)
+#define NUM_DNREAD_GLOBAL_MISS_OFFSET       NUM_DNREAD_GLOBAL_HIT_OFFSET + sizeof(DWORD)
+#define NUM_DNREAD_ENTRY_INVALIDATE_OFFSET  NUM_DNREAD_GLOBAL_MISS_OFFSET + sizeof(DWORD)
+#define NUM_DNREAD_CACHE_DROP_OFFSET        NUM_DNREAD_ENTRY_INVALIDATE_OFFSET + sizeof(DWORD)
 
 // <-- insert new NUM_*_OFFSET's here, and update SIZE_OF_... #define below.
-#define SIZE_OF_DSA_PERFORMANCE_DATA_IN_USE NUM_SAM_RES_GROUP_LATENCY_OFFSET + sizeof(DWORD)
+#define SIZE_OF_DSA_PERFORMANCE_DATA_IN_USE NUM_DNREAD_CACHE_DROP_OFFSET + sizeof(DWORD)
 
 // The total size of the structure must be a multiple of 8 (see perflib Event 1016).
 // This will adjust the total size if the total number of counters (DWORD each) is odd.
@@ -444,6 +448,10 @@ typedef struct _DSA_DATA_DEFINITION {
     PERF_COUNTER_DEFINITION     NTDSAPIReads;
     PERF_COUNTER_DEFINITION     SAMAcctGroupLatency;
     PERF_COUNTER_DEFINITION     SAMResGroupLatency;
+    PERF_COUNTER_DEFINITION     DNReadGlobalHit;
+    PERF_COUNTER_DEFINITION     DNReadGlobalMiss;
+    PERF_COUNTER_DEFINITION     DNReadEntryInvalidate;
+    PERF_COUNTER_DEFINITION     DNReadCacheDrop;
 } DSA_DATA_DEFINITION;
 
 #pragma pack ()
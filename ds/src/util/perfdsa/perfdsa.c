@@ -2334,6 +2334,58 @@ DSA_DATA_DEFINITION DsaDataDefinition = {
         sizeof(DWORD),
         NUM_SAM_RES_GROUP_LATENCY_OFFSET
     },
+
+    /* Global DN read cache hits per second */
+    {   sizeof(PERF_COUNTER_DEFINITION),
+        DNREAD_GLOBAL_HIT,
+        0,
+        DNREAD_GLOBAL_HIT + 1,
+        0,
+        0,
+        PERF_DETAIL_NOVICE,
+        PERF_COUNTER_COUNTER,
+        sizeof(DWORD),
+        NUM_DNREAD_GLOBAL_HIT_OFFSET
+    },
+
+    /* Global DN read cache misses per second */
+    {   sizeof(PERF_COUNTER_DEFINITION),
+        DNREAD_GLOBAL_MISS,
+        0,
+        DNREAD_GLOBAL_MISS + 1,
+        0,
+        0,
+        PERF_DETAIL_NOVICE,
+        PERF_COUNTER_COUNTER,
+        sizeof(DWORD),
+        NUM_DNREAD_GLOBAL_MISS_OFFSET
+    },
+
+    /* Global DN read cache entries invalidated per second */
+    {   sizeof(PERF_COUNTER_DEFINITION),
+        DNREAD_ENTRY_INVALIDATE,
+        0,
+        DNREAD_ENTRY_INVALIDATE + 1,
+        0,
+        0,
+        PERF_DETAIL_NOVICE,
+        PERF_COUNTER_COUNTER,
+        sizeof(DWORD),
+        NUM_DNREAD_ENTRY_INVALIDATE_OFFSET
+    },
+
+    /* Global DN read caches dropped per second */
+    {   sizeof(PERF_COUNTER_DEFINITION),
+        DNREAD_CACHE_DROP,
+        0,
+        DNREAD_CACHE_DROP + 1,
+        0,
+        0,
+        PERF_DETAIL_NOVICE,
+        PERF_COUNTER_COUNTER,
+        sizeof(DWORD),
+        NUM_DNREAD_CACHE_DROP_OFFSET
+    },
 };
 
 int APIENTRY _CRT_INIT(
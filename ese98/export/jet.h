@@ -960,6 +960,8 @@ typedef struct {
 
 #define JET_paramAlternateDatabaseRecoveryPath	113	//	recovery-only - search for dirty-shutdown databases in specified location only
 
+#define JET_paramPrereadIndexRangeMax			114	//	maximum number of leaf pages to preread ahead of a cursor on an index range [1024, which is also the largest value allowed]
+
 
 //	for backward compatibility
 //
@@ -1122,6 +1124,7 @@ typedef struct {
 #define JET_bitRangeUpperLimit			0x00000002
 #define JET_bitRangeInstantDuration		0x00000004
 #define JET_bitRangeRemove				0x00000008
+#define JET_bitRangePreread				0x00000010	/* start prereading the leaf pages of the range immediately */
 
 	/* Flags for JetGetLock */
 
@@ -539,7 +539,7 @@ class CLRUKResourceUtilityManager
 						const double	dblSpeedSizeTradeoff );
 		void Term();
 
-		ERR ErrCacheResource( const CKey& key, CResource* const pres, const BOOL fUseHistory = fTrue );
+		ERR ErrCacheResource( const CKey& key, CResource* const pres, const BOOL fUseHistory = fTrue, const BOOL fCold = fFalse );
 		void TouchResource( CResource* const pres, const TICK tickNow = _TickCurrentTime() );
 		BOOL FHotResource( CResource* const pres );
 		BOOL FSuperHotResource( CResource* const pres );
@@ -658,7 +658,7 @@ class CLRUKResourceUtilityManager
 	private:
 
 		void _TouchResource( CInvasiveContext* const pic, const TICK tickNow, const TICK tickLastBIExpected );
-		void _RestoreHistory( const CKey& key, CInvasiveContext* const pic, const TICK tickNow );
+		BOOL _FRestoreHistory( const CKey& key, CInvasiveContext* const pic, const TICK tickNow );
 		void _StoreHistory( const CKey& key, CInvasiveContext* const pic );
 		CHistory* _PhistAllocHistory();
 		typedef typename CHistoryLRUK::ERR ERR_TYPE;
@@ -852,10 +852,16 @@ Term()
 //  knowledge the RUM has about this resource.  the resource must currently be
 //  evicted from the RUM.  the resource will be touched by this call.  if we
 //  cannot start management of this resource, errOutOfMemory will be returned
+//
+//  if fCold is set and there is no history for the resource then it is not
+//  touched but instead is made to look one timeout older than the current
+//  time.  this is used for resources brought in speculatively by a scan so
+//  that they are the first to go unless someone actually uses them.  the
+//  first real touch then counts as the first reference to the resource
 
 template< int m_Kmax, class CResource, PfnOffsetOf OffsetOfIC, class CKey >
 inline __TYPENAME CLRUKResourceUtilityManager< m_Kmax, CResource, OffsetOfIC, CKey >::ERR CLRUKResourceUtilityManager< m_Kmax, CResource, OffsetOfIC, CKey >::
-ErrCacheResource( const CKey& key, CResource* const pres, const BOOL fUseHistory )
+ErrCacheResource( const CKey& key, CResource* const pres, const BOOL fUseHistory, const BOOL fCold )
 	{
 	ERR						err = errSuccess;
 	CLock					lock;
@@ -876,11 +882,29 @@ ErrCacheResource( const CKey& key, CResource* const pres, const BOOL fUseHistory
 
 	//  we are supposed to use the history for this resource if available
 
+	BOOL fHistory = fFalse;
 	if ( fUseHistory )
 		{
 		//  restore the history for this resource
 
-		_RestoreHistory( key, pic, tickNow );
+		fHistory = _FRestoreHistory( key, pic, tickNow );
+		}
+
+	//  we have no history for this cold resource so age its touch times by
+	//  the timeout.  the next touch will not be correlated with this one
+
+	BOOL fAged = fFalse;
+	if ( fCold && !fHistory && m_ctickTimeout > m_ctickCorrelatedTouch )
+		{
+		const TICK tickCold = ( tickNow - m_ctickTimeout ) & tickMask;
+
+		for ( int K = 1; K <= m_Kmax; K++ )
+			{
+			pic->m_rgtick[ K - 1 ] = tickCold;
+			}
+		pic->m_tickLast = tickCold;
+
+		fAged = fTrue;
 		}
 
 	//  insert this resource into the resource LRUK at its Kth touch time or as
@@ -894,6 +918,24 @@ ErrCacheResource( const CKey& key, CResource* const pres, const BOOL fUseHistory
 		pic->m_tickIndex = tickK;
 		errLRUK = m_ResourceLRUK.ErrInsertEntry( &lock.m_lock, pres, fTrue );
 
+		//  we could not insert the aged resource so just cache it normally
+
+		if ( errLRUK != CResourceLRUK::errSuccess && fAged )
+			{
+			pic->m_tickIndex = tickNil;
+			m_ResourceLRUK.UnlockKeyPtr( &lock.m_lock );
+
+			for ( int K = 1; K <= m_Kmax; K++ )
+				{
+				pic->m_rgtick[ K - 1 ] = tickNow;
+				}
+			pic->m_tickLast = tickNow;
+
+			fAged = fFalse;
+			errLRUK = CResourceLRUK::errKeyRangeExceeded;
+			continue;
+			}
+
 		if ( errLRUK != CResourceLRUK::errSuccess )
 			{
 			pic->m_tickIndex = tickNil;
@@ -1636,14 +1678,16 @@ _TouchResource( CInvasiveContext* const pic, const TICK tickNow, const TICK tick
 		}
 	}
 
-//  restores the touch history for the specified resource if known
+//  restores the touch history for the specified resource if known, returning
+//  fTrue if history was restored
 
 template< int m_Kmax, class CResource, PfnOffsetOf OffsetOfIC, class CKey >
-inline void CLRUKResourceUtilityManager< m_Kmax, CResource, OffsetOfIC, CKey >::
-_RestoreHistory( const CKey& key, CInvasiveContext* const pic, const TICK tickNow )
+inline BOOL CLRUKResourceUtilityManager< m_Kmax, CResource, OffsetOfIC, CKey >::
+_FRestoreHistory( const CKey& key, CInvasiveContext* const pic, const TICK tickNow )
 	{
 	CHistoryTable::CLock	lockHist;
 	CHistoryEntry			he;
+	BOOL					fRestored	= fFalse;
 
 	//  this resource has history
 
@@ -1677,9 +1721,13 @@ _RestoreHistory( const CKey& key, CInvasiveContext* const pic, const TICK tickNo
 			//  touch this resource
 
 			TouchResource( _PresFromPic( pic ), tickNow );
+
+			fRestored = fTrue;
 			}
 		}
 	m_KeyHistory.ReadUnlockKey( &lockHist );
+
+	return fRestored;
 	}
 
 //  stores the touch history for a resource
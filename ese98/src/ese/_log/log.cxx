@@ -140,6 +140,38 @@ long LLGUsersWaitingCEFLPv( long iInstance, void *pvBuf )
 	return 0;
 	}
 
+PM_CEF_PROC LLGCommitBatchCEFLPv;
+PERFInstanceG<> cLGCommitBatch;
+long LLGCommitBatchCEFLPv( long iInstance, void *pvBuf )
+	{
+	cLGCommitBatch.PassTo( iInstance, pvBuf );
+	return 0;
+	}
+
+PM_CEF_PROC LLGCommitLatency50CEFLPv;
+PERFInstanceG<> cLGCommitLatency50;
+long LLGCommitLatency50CEFLPv( long iInstance, void *pvBuf )
+	{
+	cLGCommitLatency50.PassTo( iInstance, pvBuf );
+	return 0;
+	}
+
+PM_CEF_PROC LLGCommitLatency90CEFLPv;
+PERFInstanceG<> cLGCommitLatency90;
+long LLGCommitLatency90CEFLPv( long iInstance, void *pvBuf )
+	{
+	cLGCommitLatency90.PassTo( iInstance, pvBuf );
+	return 0;
+	}
+
+PM_CEF_PROC LLGCommitLatency99CEFLPv;
+PERFInstanceG<> cLGCommitLatency99;
+long LLGCommitLatency99CEFLPv( long iInstance, void *pvBuf )
+	{
+	cLGCommitLatency99.PassTo( iInstance, pvBuf );
+	return 0;
+	}
+
 PM_CEF_PROC LLGRecordCEFLPv;
 PERFInstanceG<> cLGRecord;
 long LLGRecordCEFLPv(long iInstance,void *pvBuf)
@@ -271,6 +303,9 @@ LOG::LOG( INST *pinst ) :
 	m_critLGResFiles( CLockBasicInfo( CSyncBasicInfo( szLGResFiles ), rankLGResFiles, 0 ) ),
 	m_ppibLGFlushQHead( ppibNil ),
 	m_ppibLGFlushQTail( ppibNil ),
+	m_cLGWaiting( 0 ),
+	m_cLGCommitBatchAvg( 0 ),
+	m_cLGCommitLatencySamples( 0 ),
 	m_cLGWrapAround( 0 ),
 	m_pcheckpoint( NULL ),
 	m_critCheckpoint( CLockBasicInfo( CSyncBasicInfo( szCheckpoint ), rankCheckpoint, CLockDeadlockDetectionInfo::subrankNoDeadlock ) ),
@@ -341,6 +376,11 @@ LOG::LOG( INST *pinst ) :
 	cLGBytesWritten.Clear( m_pinst );
 	cLGCheckpoint.Clear( m_pinst );
 	cLGRecordOffset.Clear( m_pinst );
+	cLGCommitBatch.Clear( m_pinst );
+	cLGCommitLatency50.Clear( m_pinst );
+	cLGCommitLatency90.Clear( m_pinst );
+	cLGCommitLatency99.Clear( m_pinst );
+	memset( (void *)m_rgcLGCommitLatency, 0, sizeof( m_rgcLGCommitLatency ) );
 	
 	INT	irhf;
 	for ( irhf = 0; irhf < crhfMax; irhf++ )
@@ -391,6 +431,10 @@ LOG::~LOG()
 	cLGBytesWritten.Clear( m_pinst );
 	cLGCheckpoint.Clear( m_pinst );
 	cLGRecordOffset.Clear( m_pinst );
+	cLGCommitBatch.Clear( m_pinst );
+	cLGCommitLatency50.Clear( m_pinst );
+	cLGCommitLatency90.Clear( m_pinst );
+	cLGCommitLatency99.Clear( m_pinst );
 	}
 
 
@@ -2219,6 +2263,7 @@ ERR LOG::ErrLGWaitCommit0Flush( PIB *ppib )
 	{
 	ERR		err			= JET_errSuccess;
 	BOOL	fFlushLog	= fFalse;
+	QWORD	qwStart;
 
 	//  if the log is disabled or we are recovering, skip the wait
 
@@ -2252,8 +2297,11 @@ ERR LOG::ErrLGWaitCommit0Flush( PIB *ppib )
 
 	//  add this session to the log flush wait queue
 	
+	qwStart = QwUtilHRTCount();
+
 	m_critLGWaitQ.Enter();
 	cLGUsersWaiting.Inc( m_pinst );
+	m_cLGWaiting++;
 	
 	Assert( !ppib->FLGWaiting() );
 	ppib->SetFLGWaiting();
@@ -2284,6 +2332,8 @@ ERR LOG::ErrLGWaitCommit0Flush( PIB *ppib )
 
 	ppib->asigWaitLogFlush.Wait();
 
+	LGIRecordCommitLatency( qwStart );
+
 	//  the log write failed
 
 	if ( m_fLGNoMoreLogWrite )
@@ -4538,6 +4588,19 @@ VOID LOG::LGFlushLog( const DWORD_PTR dwThreadContext, const DWORD fCalledFromFl
 		Assert( lCount >= 0 );
 		}
 
+	//	group commit: if recent flushes have been satisfying more committers
+	//	than are waiting right now, give the committers that are about to
+	//	arrive a brief chance to join this flush before we write
+	if ( !fCalledFromFlushAll && plog->m_cLGCommitBatchAvg > 16 )
+		{
+		for ( INT iYield = 0;
+			iYield < cLGGroupCommitYieldMax && plog->m_cLGWaiting * 16 < plog->m_cLGCommitBatchAvg;
+			iYield++ )
+			{
+			UtilSleep( 0 );
+			}
+		}
+
 	plog->m_critLGFlush.Enter();
 
 	LONG lStatus = AtomicCompareExchange( (LONG *)&plog->m_fLGFlushWait, 1, 0 );
@@ -4999,12 +5062,16 @@ BOOL LOG::FWakeWaitingQueue( LGPOS * plgposToFlush )
 	/*  also wake all threads if the log has gone down
 	/**/
 
-	/*	wake it up!
+	/*	unlink the waiters to wake under m_critLGWaitQ but signal them
+	/*	after leaving it, so that the woken sessions do not contend with
+	/*	us when they come back to commit their next transaction
 	/**/
 	m_critLGWaitQ.Enter();
 
 	PIB *	ppibT				= m_ppibLGFlushQHead;
 	BOOL	fWaitersExist		= fFalse;
+	PIB *	ppibWakeHead		= ppibNil;
+	LONG	cppibWake			= 0;
 
 	while ( ppibNil != ppibT )
 		{
@@ -5041,11 +5108,9 @@ BOOL LOG::FWakeWaitingQueue( LGPOS * plgposToFlush )
 				m_ppibLGFlushQTail = ppibT->ppibPrevWaitFlush;
 				}
 
-			//	WARNING: cannot reference ppibT after this point
-			//	because once we free the waiter, the PIB may
-			//	get released
-			ppibT->asigWaitLogFlush.Set();
-			cLGUsersWaiting.Dec( m_pinst );
+			ppibT->ppibNextWaitFlush = ppibWakeHead;
+			ppibWakeHead = ppibT;
+			cppibWake++;
 			}
 		else
 			{
@@ -5055,11 +5120,106 @@ BOOL LOG::FWakeWaitingQueue( LGPOS * plgposToFlush )
 		ppibT = ppibNext;
 		}
 
+	m_cLGWaiting -= cppibWake;
+
 	m_critLGWaitQ.Leave();
 
+	/*	wake them up!
+	/**/
+	while ( ppibNil != ppibWakeHead )
+		{
+		PIB	* const	ppibNext	= ppibWakeHead->ppibNextWaitFlush;
+
+		//	WARNING: cannot reference ppibWakeHead after this point
+		//	because once we free the waiter, the PIB may
+		//	get released
+		ppibWakeHead->asigWaitLogFlush.Set();
+		cLGUsersWaiting.Dec( m_pinst );
+
+		ppibWakeHead = ppibNext;
+		}
+
+	/*	track the size of the commit batches for group commit
+	/**/
+	if ( cppibWake > 0 )
+		{
+		//	moving average of commits per flush, scaled by 16
+		m_cLGCommitBatchAvg += cppibWake - ( m_cLGCommitBatchAvg + 8 ) / 16;
+		cLGCommitBatch.Set( m_pinst, ( m_cLGCommitBatchAvg + 8 ) / 16 );
+		LGIUpdateCommitLatencyCounters();
+		}
+
 	return fWaitersExist;
 	}
 
+//	Adds the wait of a commit that started waiting at qwStart to the commit
+//	latency histogram
+
+VOID LOG::LGIRecordCommitLatency( const QWORD qwStart )
+	{
+	const QWORD	qwFreq	= QwUtilHRTFreq();
+	QWORD		cusec	= qwFreq ? ( QwUtilHRTCount() - qwStart ) * 1000000 / qwFreq : 0;
+	INT			iBucket	= 0;
+
+	while ( cusec > 1 && iBucket < cLGCommitLatencyBuckets - 1 )
+		{
+		cusec >>= 1;
+		iBucket++;
+		}
+
+	AtomicIncrement( (LONG *)&m_rgcLGCommitLatency[ iBucket ] );
+	AtomicIncrement( (LONG *)&m_cLGCommitLatencySamples );
+	}
+
+//	Publishes the 50th, 90th and 99th percentile commit waits (in usec, as the
+//	upper bound of the histogram bucket) and ages the histogram so that the
+//	counters follow recent behaviour
+
+VOID LOG::LGIUpdateCommitLatencyCounters()
+	{
+	const LONG	cSamples		= m_cLGCommitLatencySamples;
+	LONG		cSoFar			= 0;
+	INT			iPercentile		= 0;
+	const LONG	rgpct[]			= { 50, 90, 99 };
+	LONG		rgcusec[]		= { 0, 0, 0 };
+
+	if ( cSamples <= 0 )
+		{
+		return;
+		}
+
+	for ( INT iBucket = 0; iBucket < cLGCommitLatencyBuckets && iPercentile < 3; iBucket++ )
+		{
+		cSoFar += m_rgcLGCommitLatency[ iBucket ];
+		while ( iPercentile < 3 && cSoFar * 100 >= cSamples * rgpct[ iPercentile ] )
+			{
+			//	bucket iBucket holds waits below 2 << iBucket usec, which no
+			//	longer fits the counter for the top buckets (and the last bucket
+			//	is open ended anyway) so those are published as LONG_MAX
+			const QWORD	cusecBound	= QWORD( 2 ) << iBucket;
+			rgcusec[ iPercentile++ ] = cusecBound < LONG_MAX ? LONG( cusecBound ) : LONG_MAX;
+			}
+		}
+
+	cLGCommitLatency50.Set( m_pinst, rgcusec[ 0 ] );
+	cLGCommitLatency90.Set( m_pinst, rgcusec[ 1 ] );
+	cLGCommitLatency99.Set( m_pinst, rgcusec[ 2 ] );
+
+	if ( cSamples > cLGCommitLatencySamplesMax )
+		{
+		//	the histogram is updated without a lock so the halving is only
+		//	approximate, which is fine for perfmon
+		LONG cRemoved = 0;
+		for ( INT iBucket = 0; iBucket < cLGCommitLatencyBuckets; iBucket++ )
+			{
+			const LONG cHalf = m_rgcLGCommitLatency[ iBucket ] / 2;
+			AtomicExchangeAdd( (LONG *)&m_rgcLGCommitLatency[ iBucket ], -cHalf );
+			cRemoved += cHalf;
+			}
+		AtomicExchangeAdd( (LONG *)&m_cLGCommitLatencySamples, -cRemoved );
+		}
+	}
+
 
 #ifdef LOGPATCH_UNIT_TEST
 
@@ -6807,6 +6807,11 @@ LOG::ErrLGIPrereadExecute(
 
 	// Notice that we remove consecutive duplicates (and pgnoNull) from our preread
 	// list, but that we count duplicates and null's to keep our bookkeeping simple.
+	//
+	// NOTE:  the window is measured in page references, not distinct pages, because
+	// redo measures its progress through it the same way (see CLGRIConsumePageRef).
+	// the non-consecutive duplicates removed below before the list is issued must
+	// still count here or the preread would run further and further ahead of redo
 
 	while ( ( JET_errSuccess == ( err = ErrLGGetNextRecFF( (BYTE **) &plr ) ) ) &&
 		cPagesReferenced < cPagesToPreread )
@@ -6888,6 +6893,17 @@ LOG::ErrLGIPrereadExecute(
 			if ( ifmp < ifmpMax && FIODatabaseOpen( ifmp ) )
 				{
 				Assert( rgipgno[idbid] <= ipgnoMax );
+
+				//	issue the pages in ascending order and without the
+				//	non-consecutive duplicates so that neighbouring pages
+				//	can be combined into larger I/Os and no page is queued
+				//	twice
+
+				PGNO * const	rgpgnoT	= rgrgpgno[idbid] + 1;
+				const INT		cpgnoT	= rgipgno[idbid] - 1;
+				sort( rgpgnoT, rgpgnoT + cpgnoT );
+				rgipgno[idbid] = INT( unique( rgpgnoT, rgpgnoT + cpgnoT ) - rgpgnoT ) + 1;
+
 				rgrgpgno[idbid][(rgipgno[idbid])++] = pgnoNull;
 				BFPrereadPageList( ifmp, rgrgpgno[idbid] + 1 );
 				}
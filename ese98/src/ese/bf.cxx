@@ -2317,7 +2317,7 @@ void BFPrereadPageRange( IFMP ifmp, PGNO pgnoFirst, CPG cpg, CPG* pcpgActual )
 
 	for ( ULONG pgno = pgnoFirst; pgno != pgnoFirst + cpg; pgno += lDir )
 		{
-		const ERR err = ErrBFIPrereadPage( ifmp, pgno );
+		const ERR err = ErrBFIPrereadPage( ifmp, pgno, fTrue );
 
 		if ( err == JET_errSuccess )
 			{
@@ -6406,7 +6406,8 @@ ERR ErrBFICachePage(	PBF* const	ppbf,
 						const PGNO	pgno,
 						const BOOL	fUseHistory,
 						const BOOL	fWait,
-						const BOOL	fMRU )
+						const BOOL	fMRU,
+						const BOOL	fCold )
 	{
 	ERR				err;
 	PGNOPBF			pgnopbf;
@@ -6463,7 +6464,7 @@ ERR ErrBFICachePage(	PBF* const	ppbf,
 
 	//  insert this IFMP / PGNO in the LRUK
 
-	errLRUK = bflruk.ErrCacheResource( IFMPPGNO( ifmp, pgno ), pgnopbf.pbf, fUseHistory );
+	errLRUK = bflruk.ErrCacheResource( IFMPPGNO( ifmp, pgno ), pgnopbf.pbf, fUseHistory, fCold );
 
 	//  we failed to insert this IFMP / PGNO in the LRUK
 
@@ -6741,7 +6742,11 @@ HandleError:
 	return err;
 	}
 
-ERR ErrBFIPrereadPage( IFMP ifmp, PGNO pgno )
+//  Prereads the given page.  Pages that are part of a sequential preread are
+//  cached cold so that a large scan cannot push the hot pages out of the cache.
+//  Such a page only gains priority once it is actually touched.
+
+ERR ErrBFIPrereadPage( IFMP ifmp, PGNO pgno, const BOOL fSequential )
 	{
 	ERR				err		= errBFPageCached;
 	PGNOPBF			pgnopbf;
@@ -6761,7 +6766,7 @@ ERR ErrBFIPrereadPage( IFMP ifmp, PGNO pgno )
 		//  try to add this page to the cache
 
 		PBF pbf;
-		err = ErrBFICachePage( &pbf, ifmp, pgno, fTrue, fFalse, fFalse );
+		err = ErrBFICachePage( &pbf, ifmp, pgno, fTrue, fFalse, fFalse, fSequential );
 
 		//  the page was added to the cache
 
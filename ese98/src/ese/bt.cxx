@@ -1535,8 +1535,9 @@ ERR ErrBTIPreread( FUCB *pfucb, CPG cpg, CPG * pcpgActual )
 									Pcsr( pfucb )->ILine() + 1 );
 
 
-	//  add 1 PGNO for null termination of the list
-	PGNO * rgpgnoPreread = (PGNO *)PvOSMemoryHeapAlloc( ( cpgPreread + 1 ) * sizeof(PGNO) );
+	//  add 1 PGNO for null termination of the list, and room for a second
+	//  copy of the list sorted by page number
+	PGNO * rgpgnoPreread = (PGNO *)PvOSMemoryHeapAlloc( 2 * ( cpgPreread + 1 ) * sizeof(PGNO) );
 	if( NULL == rgpgnoPreread )
 		{
 		return ErrERRCheck( JET_errOutOfMemory );
@@ -1609,7 +1610,37 @@ ERR ErrBTIPreread( FUCB *pfucb, CPG cpg, CPG * pcpgActual )
 
 	rgpgnoPreread[ipgnoPreread] = pgnoNull;
 
-	BFPrereadPageList( pfucb->u.pfcb->Ifmp(), rgpgnoPreread, pcpgActual );
+	//  issue the reads in page order so that leaf pages that are adjacent on
+	//  disk are combined into large reads
+
+	PGNO * const	rgpgnoSorted	= rgpgnoPreread + cpgPreread + 1;
+	CPG				cpgIssued;
+
+	UtilMemCpy( rgpgnoSorted, rgpgnoPreread, ( ipgnoPreread + 1 ) * sizeof(PGNO) );
+	sort( rgpgnoSorted, rgpgnoSorted + ipgnoPreread );
+
+	BFPrereadPageList( pfucb->u.pfcb->Ifmp(), rgpgnoSorted, &cpgIssued );
+
+	//  BF stops at the first page it fails to preread, so the pages issued
+	//  are those numbered below that page.  the caller counts the pages it
+	//  moves onto against our count, so report how many of the pages in key
+	//  order were issued before the first one that wasn't
+
+	if ( pcpgActual )
+		{
+		INT ipgnoIssued = ipgnoPreread;
+
+		if ( cpgIssued < ipgnoPreread )
+			{
+			for ( ipgnoIssued = 0;
+				  ipgnoIssued < ipgnoPreread && rgpgnoPreread[ipgnoIssued] < rgpgnoSorted[cpgIssued];
+				  ipgnoIssued++ )
+				{
+				}
+			}
+
+		*pcpgActual = ipgnoIssued;
+		}
 
 	OSMemoryHeapFree( rgpgnoPreread );
 	return JET_errSuccess;
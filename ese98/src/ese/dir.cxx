@@ -1222,6 +1222,47 @@ HandleError:
 	}
 
 
+//	prereads the leaf pages of the index range ahead of the cursor now
+//	instead of when the cursor first leaves its current leaf page
+//
+ERR ErrDIRPrereadIndexRange( FUCB *pfucb )
+	{
+	ERR		err		= JET_errSuccess;
+
+	CheckFUCB( pfucb->ppib, pfucb );
+	Assert( !FFUCBSpace( pfucb ) );
+	Assert( FFUCBLimstat( pfucb ) );
+	Assert( !Pcsr( pfucb )->FLatched() );
+
+	if ( locOnCurBM != pfucb->locLogical || !FFUCBPreread( pfucb ) )
+		{
+		return JET_errSuccess;
+		}
+
+	//	seek back down from the root so that BTDown extracts the pages to
+	//	preread from the parent of the current leaf page
+	//
+	BTUp( pfucb );
+	pfucb->cpgPrereadNotConsumed = 0;
+
+	err = ErrBTGet( pfucb );
+	if ( JET_errRecordDeleted == err )
+		{
+		//	the node went away under us, so the next move will
+		//	reseek and preread for itself
+		//
+		err = JET_errSuccess;
+		}
+	else if ( err >= JET_errSuccess )
+		{
+		err = ErrBTRelease( pfucb );
+		}
+
+	Assert( !Pcsr( pfucb )->FLatched() );
+	return err;
+	}
+
+
 
 //	************************************************
 //	UPDATE OPERATIONS
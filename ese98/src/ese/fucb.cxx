@@ -332,12 +332,12 @@ VOID FUCBSetIndexRange( FUCB *pfucb, JET_GRBIT grbit )
 	FUCBSetLimstat( pfucb );
 	if ( grbit & JET_bitRangeUpperLimit )
 		{
-		FUCBSetPrereadForward( pfucb, cpgPrereadSequential );
+		FUCBSetPrereadForward( pfucb, g_cpgPrereadIndexRange );
 		FUCBSetUpper( pfucb );
 		}
 	else
 		{
-		FUCBSetPrereadBackward( pfucb, cpgPrereadSequential );
+		FUCBSetPrereadBackward( pfucb, g_cpgPrereadIndexRange );
 		FUCBResetUpper( pfucb );
 		}
 	if ( grbit & JET_bitRangeInclusive )
@@ -2878,6 +2878,7 @@ LOCAL BOOL FAllowSetGlobalSysParamAfterStart( unsigned long paramid )
 		case JET_paramExceptionAction:
 		case JET_paramPageHintCacheSize:
 		case JET_paramOSSnapshotTimeout:
+		case JET_paramPrereadIndexRangeMax:
 			return fTrue;
 		}
 
@@ -3934,6 +3935,18 @@ ERR ErrSetSystemParameter(
 		g_cbPageHintCache = (LONG)ulParam;
 		break;
 
+	case JET_paramPrereadIndexRangeMax:
+		//	this is a cap that can only lower the read-ahead depth: BTDown
+		//	prereads from the parent of the current leaf, and a parent page of
+		//	any supported page size holds fewer than cpgPrereadSequential
+		//	children, so a larger value would buy nothing
+		if ( ulParam > ULONG_PTR( cpgPrereadSequential ) )
+			{
+			Call( ErrERRCheck( JET_errInvalidParameter ) );
+			}
+		g_cpgPrereadIndexRange = CPG( 0 == ulParam ? cpgPrereadIndexRangeDefault : ulParam );
+		break;
+
 	case JET_paramRecordUpgradeDirtyLevel:
 		switch( ulParam )
 			{
@@ -4612,6 +4625,10 @@ LOCAL ERR ErrGetSystemParameter(
 		*plParam = ULONG_PTR( g_cbPageHintCache );
 		break;
 
+	case JET_paramPrereadIndexRangeMax:
+		*plParam = ULONG_PTR( g_cpgPrereadIndexRange );
+		break;
+
 	case JET_paramRecordUpgradeDirtyLevel:
 		switch( CPAGE::bfdfRecordUpgradeFlags )
 			{
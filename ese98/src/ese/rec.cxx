@@ -1953,6 +1953,17 @@ ERR VTAPI ErrIsamSetIndexRange( JET_SESID sesid, JET_VTID vtid, JET_GRBIT grbit
 	/**/
 	KSReset( pfucb );
 
+	/*	start prereading the range now if requested.  The preread is only
+	/*	a hint, so a failure to issue it must not fail the index range; the
+	/*	cursor keeps its logical currency and the next move reseeks.
+	/**/
+	if ( err >= JET_errSuccess
+		&& ( grbit & JET_bitRangePreread )
+		&& !( grbit & JET_bitRangeInstantDuration ) )
+		{
+		(void)ErrDIRPrereadIndexRange( pfucb );
+		}
+
 	/*	if instant duration index range, then reset index range.
 	/**/
 	if ( grbit & JET_bitRangeInstantDuration )
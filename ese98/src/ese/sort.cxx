@@ -17,7 +17,10 @@ INLINE VOID SWAPSpair( SPAIR *pspair1, SPAIR *pspair2 );
 INLINE VOID SWAPPsrec( SREC **ppsrec1, SREC **ppsrec2 );
 INLINE VOID SWAPPmtnode( MTNODE **ppmtnode1, MTNODE **ppmtnode2 );
 LOCAL VOID SORTIInsertionSort( SCB *pscb, SPAIR *pspairMinIn, SPAIR *pspairMaxIn );
+INLINE SPAIR *PspairSORTIPartition( SCB * pscb, SPAIR *pspairMin, SPAIR *pspairMax );
 LOCAL VOID SORTIQuicksort( SCB * pscb, SPAIR *pspairMinIn, SPAIR *pspairMaxIn );
+LOCAL VOID SORTIParallelQuicksort( SCB * pscb, SPAIR *pspairMinIn, SPAIR *pspairMaxIn, const LONG cthread );
+LOCAL VOID SORTISortBuffer( SCB * pscb );
 LOCAL ERR ErrSORTIRunStart( SCB *pscb, QWORD cb, RUNINFO *pruninfo );
 LOCAL ERR ErrSORTIRunInsert( SCB *pscb, RUNINFO* pruninfo, SREC *psrec );
 INLINE VOID SORTIRunEnd( SCB * pscb, RUNINFO* pruninfo );
@@ -124,6 +127,7 @@ ERR ErrSORTOpen( PIB *ppib, FUCB **ppfucb, const BOOL fRemoveDuplicateKey, const
 	/*	initialize sort pair buffer
 	/**/
 	pscb->ispairMac	= 0;
+	pscb->cspairMax	= cspairSortMax;
 
 	/*	initialize record buffer
 	/**/
@@ -203,7 +207,7 @@ ERR ErrSORTInsert( FUCB *pfucb, const KEY& key, const DATA& data )
 
 	//  check SCB
 	
-	Assert( pscb->crecBuf <= cspairSortMax );
+	Assert( pscb->crecBuf <= pscb->cspairMax );
 	Assert( pscb->irecMac <= irecSortMax );
 
 	//  calculate required normal memory/record indexes to store this record
@@ -211,14 +215,33 @@ ERR ErrSORTInsert( FUCB *pfucb, const KEY& key, const DATA& data )
 	INT cbNormNeeded = CbSRECSizeCbCb( key.Cb(), data.Cb() );
 	INT cirecNeeded = CirecToStoreCb( cbNormNeeded );
 
+	//  if we are out of fast memory but not normal memory, this sort is big
+	//  enough to be worth a larger sort pair buffer.  we only pay for it once
+	//  we get here so that small sorts keep using cbSortMemFast.  if we can't
+	//  get the memory we just carry on with the buffer we have
+
+	if (	pscb->crecBuf == pscb->cspairMax &&
+			pscb->cspairMax < cspairSortMaxGrown &&
+			pscb->irecMac * cbIndexGran + cbNormNeeded <= cbSortMemNormUsed )
+		{
+		SPAIR * const rgspairGrown = ( SPAIR * )( PvOSMemoryPageAlloc( cbSortMemFastMaxUsed, NULL ) );
+		if ( rgspairGrown )
+			{
+			UtilMemCpy( rgspairGrown, pscb->rgspair, pscb->ispairMac * sizeof( SPAIR ) );
+			OSMemoryPageFree( pscb->rgspair );
+			pscb->rgspair	= rgspairGrown;
+			pscb->cspairMax	= cspairSortMaxGrown;
+			}
+		}
+
 	//  if we are out of fast or normal memory, output a run
 	
 	if (	pscb->irecMac * cbIndexGran + cbNormNeeded > cbSortMemNormUsed ||
-			pscb->crecBuf == cspairSortMax )
+			pscb->crecBuf == pscb->cspairMax )
 		{
 		//  sort previously inserted records into a run
 
-		SORTIQuicksort( pscb, pscb->rgspair, pscb->rgspair + pscb->ispairMac );
+		SORTISortBuffer( pscb );
 
 		//  move the new run to disk
 		
@@ -283,7 +306,7 @@ ERR ErrSORTInsert( FUCB *pfucb, const KEY& key, const DATA& data )
 
 	//  check SCB
 	
-	Assert( pscb->crecBuf <= cspairSortMax );
+	Assert( pscb->crecBuf <= pscb->cspairMax );
 	Assert( pscb->irecMac <= irecSortMax );
 
 HandleError:
@@ -322,7 +345,7 @@ ERR ErrSORTEndInsert( FUCB *pfucb )
 
 	//  sort records in memory
 
-	SORTIQuicksort( pscb, pscb->rgspair, pscb->rgspair + pscb->ispairMac );
+	SORTISortBuffer( pscb );
 
 	//  do we have any runs on disk?
 
@@ -1352,7 +1375,8 @@ LOCAL VOID SORTIInsertionSort( SCB *pscb, SPAIR *pspairMinIn, SPAIR *pspairMaxIn
 	{
 	SPAIR	*pspairLast;
 	SPAIR	*pspairFirst;
-	SPAIR	*pspairKey = pscb->rgspair + cspairSortMax;
+	SPAIR	spairKey;
+	SPAIR	*pspairKey = &spairKey;
 
 	//  This loop is optimized so that we only scan for the current pair's new
 	//  position if the previous pair in the list is greater than the current
@@ -1385,6 +1409,76 @@ LOCAL VOID SORTIInsertionSort( SCB *pscb, SPAIR *pspairMinIn, SPAIR *pspairMaxIn
 	}
 
 
+//  partitions the given sort pairs around a divisor chosen as the median of the
+//  first, middle and last pairs into two smaller partitions (<=, >) and returns
+//  the final position of the divisor
+
+INLINE SPAIR *PspairSORTIPartition( SCB * pscb, SPAIR *pspairMin, SPAIR *pspairMax )
+	{
+	SPAIR	*pspairFirst;
+	SPAIR	*pspairLast;
+
+	Assert( pspairMax - pspairMin >= cspairQSortMin );
+
+	//  determine divisor by sorting the first, middle, and last pairs and
+	//  taking the resulting middle pair as the divisor (stored in first place)
+
+	pspairFirst	= pspairMin + ( ( pspairMax - pspairMin ) >> 1 );
+	pspairLast	= pspairMax - 1;
+
+	if ( ISORTICmpPspairPspair( pscb, pspairFirst, pspairMin ) > 0 )
+		SWAPSpair( pspairFirst, pspairMin );
+	if ( ISORTICmpPspairPspair( pscb, pspairFirst, pspairLast ) > 0 )
+		SWAPSpair( pspairFirst, pspairLast );
+	if ( ISORTICmpPspairPspair( pscb, pspairMin, pspairLast ) > 0 )
+		SWAPSpair( pspairMin, pspairLast );
+
+	//  sort large partition into two smaller partitions (<=, >)
+	//
+	//  NOTE:  we are not sorting the two end pairs as the first pair is the
+	//  divisor and the last pair is already known to be > the divisor
+
+	pspairFirst = pspairMin + 1;
+	pspairLast--;
+
+	Assert( pspairFirst <= pspairLast );
+	
+	forever
+		{
+		//  advance past all pairs <= the divisor
+		
+		while (	pspairFirst <= pspairLast &&
+				ISORTICmpPspairPspair( pscb, pspairFirst, pspairMin ) <= 0 )
+			pspairFirst++;
+
+		//  advance past all pairs > the divisor
+		
+		while (	pspairFirst <= pspairLast &&
+				ISORTICmpPspairPspair( pscb, pspairLast, pspairMin ) > 0 )
+			pspairLast--;
+
+		//  if we have found a pair to swap, swap them and continue
+
+		Assert( pspairFirst != pspairLast );
+		
+		if ( pspairFirst < pspairLast )
+			SWAPSpair( pspairFirst++, pspairLast-- );
+
+		//  no more pairs to compare, partitioning complete
+		
+		else
+			break;
+		}
+
+	//  place the divisor at the end of the <= partition
+
+	if ( pspairLast != pspairMin )
+		SWAPSpair( pspairMin, pspairLast );
+
+	return pspairLast;
+	}
+
+
 //  SORTIQuicksort is a cache optimized Quicksort that sorts sort pair arrays
 //  generated by ErrSORTInsert.  It is designed to sort large arrays of data
 //  without any CPU data cache misses.  To do this, it uses a special comparator
@@ -1430,60 +1524,9 @@ LOCAL VOID SORTIQuicksort( SCB * pscb, SPAIR *pspairMinIn, SPAIR *pspairMaxIn )
 			continue;
 			}
 
-		//  determine divisor by sorting the first, middle, and last pairs and
-		//  taking the resulting middle pair as the divisor (stored in first place)
-
-		pspairFirst	= pspairMin + ( ( pspairMax - pspairMin ) >> 1 );
-		pspairLast	= pspairMax - 1;
-
-		if ( ISORTICmpPspairPspair( pscb, pspairFirst, pspairMin ) > 0 )
-			SWAPSpair( pspairFirst, pspairMin );
-		if ( ISORTICmpPspairPspair( pscb, pspairFirst, pspairLast ) > 0 )
-			SWAPSpair( pspairFirst, pspairLast );
-		if ( ISORTICmpPspairPspair( pscb, pspairMin, pspairLast ) > 0 )
-			SWAPSpair( pspairMin, pspairLast );
-
 		//  sort large partition into two smaller partitions (<=, >)
-		//
-		//  NOTE:  we are not sorting the two end pairs as the first pair is the
-		//  divisor and the last pair is already known to be > the divisor
 
-		pspairFirst = pspairMin + 1;
-		pspairLast--;
-
-		Assert( pspairFirst <= pspairLast );
-		
-		forever
-			{
-			//  advance past all pairs <= the divisor
-			
-			while (	pspairFirst <= pspairLast &&
-					ISORTICmpPspairPspair( pscb, pspairFirst, pspairMin ) <= 0 )
-				pspairFirst++;
-
-			//  advance past all pairs > the divisor
-			
-			while (	pspairFirst <= pspairLast &&
-					ISORTICmpPspairPspair( pscb, pspairLast, pspairMin ) > 0 )
-				pspairLast--;
-
-			//  if we have found a pair to swap, swap them and continue
-
-			Assert( pspairFirst != pspairLast );
-			
-			if ( pspairFirst < pspairLast )
-				SWAPSpair( pspairFirst++, pspairLast-- );
-
-			//  no more pairs to compare, partitioning complete
-			
-			else
-				break;
-			}
-
-		//  place the divisor at the end of the <= partition
-
-		if ( pspairLast != pspairMin )
-			SWAPSpair( pspairMin, pspairLast );
+		pspairLast = PspairSORTIPartition( pscb, pspairMin, pspairMax );
 
 		//  set first/last to delimit larger partition (as min/max) and set
 		//  min/max to delimit smaller partition for next iteration
@@ -1511,6 +1554,123 @@ LOCAL VOID SORTIQuicksort( SCB * pscb, SPAIR *pspairMinIn, SPAIR *pspairMaxIn )
 		}
 	}
 
+
+//  a partition of a sort buffer handed to another thread to Quicksort.  whoever
+//  claims the partition first (the task or the thread waiting for it) sorts it
+//  and the last one to release the context frees it
+
+class SORTPARTTASK
+	{
+	public:
+
+		SORTPARTTASK( SCB * const pscb, SPAIR * const pspairMin, SPAIR * const pspairMax, const LONG cthread )
+			:	m_pscb( pscb ),
+				m_pspairMin( pspairMin ),
+				m_pspairMax( pspairMax ),
+				m_cthread( cthread ),
+				m_fClaimed( fFalse ),
+				m_cref( 2 ),
+				m_msigDone( CSyncBasicInfo( _T( "SORTPARTTASK::m_msigDone" ) ) )
+			{
+			}
+
+		BOOL FClaim()		{ return !AtomicExchange( (LONG *)&m_fClaimed, fTrue ); }
+		VOID Sort()			{ SORTIParallelQuicksort( m_pscb, m_pspairMin, m_pspairMax, m_cthread ); }
+		VOID Release()		{ if ( 0 == AtomicDecrement( (LONG *)&m_cref ) ) delete this; }
+
+		static DWORD DispatchGP( VOID *pv )
+			{
+			SORTPARTTASK * const ptask = (SORTPARTTASK *)pv;
+
+			if ( ptask->FClaim() )
+				{
+				ptask->Sort();
+				ptask->m_msigDone.Set();
+				}
+			ptask->Release();
+			return 0;
+			}
+
+	public:
+
+		SCB * const			m_pscb;
+		SPAIR * const		m_pspairMin;
+		SPAIR * const		m_pspairMax;
+		const LONG			m_cthread;
+		volatile LONG		m_fClaimed;
+		volatile LONG		m_cref;
+		CManualResetSignal	m_msigDone;
+	};
+
+
+//  SORTIParallelQuicksort splits a large sort pair array into two partitions
+//  and sorts one of them on a task thread while sorting the other one on this
+//  thread, splitting further until each of cthread threads has a partition.
+//  If the partition cannot be handed off, it is sorted on this thread.
+
+LOCAL VOID SORTIParallelQuicksort( SCB * pscb, SPAIR *pspairMinIn, SPAIR *pspairMaxIn, const LONG cthread )
+	{
+	if ( cthread < 2 || pspairMaxIn - pspairMinIn < cspairQSortParallelMin )
+		{
+		SORTIQuicksort( pscb, pspairMinIn, pspairMaxIn );
+		return;
+		}
+
+	//  sort large partition into two smaller partitions (<=, >)
+
+	SPAIR * const	pspairDivisor	= PspairSORTIPartition( pscb, pspairMinIn, pspairMaxIn );
+	const LONG		cthreadTask		= cthread / 2;
+
+	//  hand off the upper partition
+
+	INST * const	pinst	= PinstFromIfmp( pscb->fcb.Ifmp() );
+	SORTPARTTASK *	ptask	= NULL;
+
+	if ( !pinst->m_fTermInProgress )
+		{
+		ptask = new SORTPARTTASK( pscb, pspairDivisor + 1, pspairMaxIn, cthreadTask );
+		}
+	if ( ptask != NULL && pinst->Taskmgr().ErrTMPost( SORTPARTTASK::DispatchGP, ptask ) < JET_errSuccess )
+		{
+		delete ptask;
+		ptask = NULL;
+		}
+
+	//  sort the lower partition ourself
+
+	SORTIParallelQuicksort( pscb, pspairMinIn, pspairDivisor, cthread - cthreadTask );
+
+	//  sort the upper partition ourself if it could not be handed off or the
+	//  task has not started yet, otherwise wait for the task to finish it
+
+	if ( ptask == NULL )
+		{
+		SORTIParallelQuicksort( pscb, pspairDivisor + 1, pspairMaxIn, cthreadTask );
+		}
+	else
+		{
+		if ( ptask->FClaim() )
+			{
+			ptask->Sort();
+			}
+		else
+			{
+			ptask->m_msigDone.Wait();
+			}
+		ptask->Release();
+		}
+	}
+
+
+//  sorts the sort pairs in the sort buffer
+
+LOCAL VOID SORTISortBuffer( SCB * pscb )
+	{
+	const LONG cthread = min( (LONG)CUtilProcessProcessor(), cthreadQSortParallelMax );
+
+	SORTIParallelQuicksort( pscb, pscb->rgspair, pscb->rgspair + pscb->ispairMac, cthread );
+	}
+
 //  Create a new run with the supplied parameters.  The new run's id and size
 //  in pages is returned on success
 
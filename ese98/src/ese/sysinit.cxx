@@ -105,6 +105,8 @@ BOOL	g_fCleanupMismatchedLogFiles = fFalse;
 
 LONG	g_cbPageHintCache = cbPageHintCacheDefault;
 
+CPG		g_cpgPrereadIndexRange = cpgPrereadIndexRangeDefault;
+
 BOOL	g_fOneDatabasePerSession	= fFalse;
 
 char const *szCheckpoint			= "Checkpoint";
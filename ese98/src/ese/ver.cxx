@@ -31,6 +31,7 @@ PERFInstanceG<> cVERAsyncCleanupDispatched;
 PERFInstanceG<> cVERSyncCleanupDispatched;
 PERFInstanceG<> cVERCleanupDiscarded;
 PERFInstanceG<> cVERCleanupFailed;
+PERFInstanceG<> cVERRCECleanPinnedTime;
 
 PM_CEF_PROC LVERcbucketAllocatedCEFLPv;
 PM_CEF_PROC	LVERcbucketDeleteAllocatedCEFLPv;
@@ -41,6 +42,7 @@ PM_CEF_PROC LVERAsyncCleanupDispatchedCEFLPv;
 PM_CEF_PROC LVERSyncCleanupDispatchedCEFLPv;
 PM_CEF_PROC LVERCleanupDiscardedCEFLPv;
 PM_CEF_PROC LVERCleanupFailedCEFLPv;
+PM_CEF_PROC LVERRCECleanPinnedTimeCEFLPv;
 
 
 //  ================================================================
@@ -149,6 +151,14 @@ LONG LVERCleanupFailedCEFLPv( LONG iInstance, VOID * pvBuf )
 	return 0;
 	}
 
+//  ================================================================
+LONG LVERRCECleanPinnedTimeCEFLPv( LONG iInstance, VOID * pvBuf )
+//  ================================================================
+	{
+	cVERRCECleanPinnedTime.PassTo( iInstance, pvBuf );
+	return 0;
+	}
+
 
 
 //  ****************************************************************
@@ -198,6 +208,8 @@ VER::VER( INST *pinst ) :
 		m_trxBegin0LastLongRunningTransaction( trxMin ),
 		m_ppibTrxOldestLastLongRunningTransaction( ppibNil ),
 		m_dwTrxContextLastLongRunningTransaction( 0 ),
+		m_trxRCECleanPinned( trxMax ),
+		m_tickRCECleanPinned( 0 ),
 #ifdef GLOBAL_VERSTORE_MEMPOOL
 		m_pcresVERPool( g_pcresVERPool )
 #else
@@ -3082,6 +3094,7 @@ ERR VER::ErrVERInit( INT cbucketMost, INT cbucketPreferred, INT cSessions )
 	cVERAsyncCleanupDispatched.Clear( m_pinst );	//  cleanup operations dispatched asynchronously
 	cVERCleanupDiscarded.Clear( m_pinst );			//  cleanup operations dispatched but failed
 	cVERCleanupFailed.Clear( m_pinst );				//  cleanup operations discarded
+	cVERRCECleanPinnedTime.Clear( m_pinst );		//  time the oldest transaction pins RCE clean
 #endif	//  VERPERF
 
 	AssertRTL( TrxCmp( trxMax, trxMax ) == 0 );
@@ -3265,6 +3278,7 @@ VOID VER::VERTerm( BOOL fNormal )
 	cVERAsyncCleanupDispatched.Clear( m_pinst );	//  cleanup operations dispatched asynchronously
 	cVERCleanupDiscarded.Clear( m_pinst );			//  cleanup operations dispatched but failed
 	cVERCleanupFailed.Clear( m_pinst );				//  cleanup operations discarded
+	cVERRCECleanPinnedTime.Clear( m_pinst );		//  time the oldest transaction pins RCE clean
 #endif // VERPERF
 	}
 
@@ -6693,12 +6707,47 @@ HandleError:
 		//	record when we performed this pass of version cleanup
 		//
 		m_tickLastRCEClean = TickOSTimeCurrent();
+
+		//	if we could not clean everything then the oldest transaction
+		//	is holding back version cleanup
+		//
+		VERIUpdateRCECleanPinned( JET_wrnRemainingVersions == err ? TrxOldest( m_pinst ) : trxMax );
 		}
 
 	return err;
 	}
 
 
+//  ================================================================
+VOID VER::VERIUpdateRCECleanPinned( const TRX trxOldest )
+//  ================================================================
+//
+//	Track how long RCE clean has been held back by the same oldest
+//	transaction so that a long-running transaction can be spotted
+//	before it runs the version store out of memory
+//
+//-
+	{
+	Assert( m_critRCEClean.FOwner() );
+
+	const TICK	tickNow		= TickOSTimeCurrent();
+
+	if ( trxMax == trxOldest )
+		{
+		m_trxRCECleanPinned = trxMax;
+		}
+	else if ( trxOldest != m_trxRCECleanPinned )
+		{
+		m_trxRCECleanPinned = trxOldest;
+		m_tickRCECleanPinned = tickNow;
+		}
+
+	cVERRCECleanPinnedTime.Set(
+		m_pinst,
+		trxMax == m_trxRCECleanPinned ? 0 : LONG( ( tickNow - m_tickRCECleanPinned ) / 1000 ) );
+	}
+
+
 //  ================================================================
 VOID VERICommitRegisterCallback( const RCE * const prce, const TRX trxCommit0 )
 //  ================================================================
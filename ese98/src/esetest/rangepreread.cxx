@@ -0,0 +1,270 @@
+#include "unittest.hxx"
+
+//  ================================================================
+class RANGEPREREAD : public UNITTEST
+//  ================================================================
+	{
+	private:
+		static RANGEPREREAD s_instance;
+
+	protected:
+		RANGEPREREAD() {}
+
+	public:
+		~RANGEPREREAD() {}
+
+	public:
+		const char * SzName() const;
+		const char * SzDescription() const;
+
+		bool FRunUnderESE98() const;
+		bool FRunUnderESENT() const;
+		bool FRunUnderESE97() const;
+
+		JET_ERR ErrTest(
+				const JET_INSTANCE instance,
+				const JET_SESID sesid,
+				JET_DBID& dbid );
+	};
+
+RANGEPREREAD RANGEPREREAD::s_instance;
+
+
+//  ================================================================
+const char * RANGEPREREAD::SzName() const
+//  ================================================================
+	{
+	return "rangepreread";
+	}
+
+
+//  ================================================================
+const char * RANGEPREREAD::SzDescription() const
+//  ================================================================
+	{
+	return	"Test JET_bitRangePreread and JET_paramPrereadIndexRangeMax. An index range set\r\n"
+			"with JET_bitRangePreread over many leaf pages must return every record of the\r\n"
+			"range exactly once and in key order, whatever the read-ahead depth.";
+	}
+
+
+//  ================================================================
+bool RANGEPREREAD::FRunUnderESE98() const
+//  ================================================================
+	{
+	return 1;
+	}
+
+
+//  ================================================================
+bool RANGEPREREAD::FRunUnderESENT() const
+//  ================================================================
+	{
+	return 0;
+	}
+
+
+//  ================================================================
+bool RANGEPREREAD::FRunUnderESE97() const
+//  ================================================================
+	{
+	return 0;
+	}
+
+
+static const char szMyTable[]		= "RANGEPREREAD::table";
+
+static JET_COLUMNCREATE	rgcolumncreate[] = {
+	{
+	sizeof( JET_COLUMNCREATE ),		// size of structure
+	"long",							// name of column
+	JET_coltypLong,					// type of column
+	0,								// cbMax
+	0,								// grbit
+	NULL,							// pvDefault
+	0,								// cbDefault
+	0,								// code page
+	0,								// returned columnid
+	JET_errSuccess					// returned err
+	},
+	{
+	sizeof( JET_COLUMNCREATE ),		// size of structure
+	"binary",						// name of column
+	JET_coltypBinary,				// type of column
+	0,								// cbMax
+	0,								// grbit
+	NULL,							// pvDefault
+	0,								// cbDefault
+	0,								// code page
+	0,								// returned columnid
+	JET_errSuccess					// returned err
+	},
+};
+
+static const char szIndex1Name[]	= "primary-index";
+static const char szIndex1Key[]		= "+long\0";
+
+static JET_INDEXCREATE rgindexcreate[] = {
+	{
+	sizeof( JET_INDEXCREATE ),		// size of this structure (for future expansion)
+	const_cast<char *>( szIndex1Name ),				// index name
+	const_cast<char *>( szIndex1Key ),				// index key
+	sizeof( szIndex1Key ),			// length of key
+	JET_bitIndexPrimary,			// index options
+	100,							// index density
+	0,								// lcid for the index
+	0,								// maximum length of variable length columns in index key
+	NULL,							// pointer to conditional column structure
+	0,								// number of conditional columns
+	JET_errSuccess					// returned error code
+	},
+};
+
+static JET_TABLECREATE tablecreate = {
+	sizeof( JET_TABLECREATE ),				// size of this structure
+	const_cast<char *>( szMyTable ),		// name of table
+	NULL,									// name of base table
+	16,										// initial pages
+	100,									// density
+	rgcolumncreate,							// columns to create
+	sizeof( rgcolumncreate ) / sizeof( JET_COLUMNCREATE ), // number of columns to create
+	rgindexcreate,							// array of index creation info
+	sizeof( rgindexcreate ) / sizeof( JET_INDEXCREATE ), // number of indexes to create
+	0,										// grbit
+	0,										// returned tableid
+	0										// returned count of objects created
+};
+
+//	enough records, with enough padding, that the range spans many leaf pages
+//	and more than one parent page
+
+static const long	lRecordMax		= 20000;
+static const long	lRangeStart		= 1000;
+static const long	lRangeEnd		= 15000;
+
+static unsigned char rgbPad[200];
+
+
+//  ================================================================
+static JET_ERR ErrCheckRange(
+	const JET_SESID sesid,
+	const JET_TABLEID tableid,
+	const JET_COLUMNID columnid )
+//  ================================================================
+	{
+	JET_ERR			err			= 0;
+	long			lStart		= lRangeStart;
+	long			lEnd		= lRangeEnd;
+	long			lExpected	= lRangeStart;
+	long			l;
+	unsigned long	cbActual;
+
+	Call( JetMakeKey( sesid, tableid, &lStart, sizeof( lStart ), JET_bitNewKey ) );
+	Call( JetSeek( sesid, tableid, JET_bitSeekEQ ) );
+	Call( JetMakeKey( sesid, tableid, &lEnd, sizeof( lEnd ), JET_bitNewKey ) );
+	Call( JetSetIndexRange(
+			sesid,
+			tableid,
+			JET_bitRangeUpperLimit | JET_bitRangeInclusive | JET_bitRangePreread ) );
+
+	do
+		{
+		Call( JetRetrieveColumn( sesid, tableid, columnid, &l, sizeof( l ), &cbActual, NO_GRBIT, NULL ) );
+		if ( l != lExpected )
+			{
+			printf( "\trecord %d returned where %d was expected\r\n", l, lExpected );
+			err = -1;
+			goto HandleError;
+			}
+		lExpected++;
+		}
+	while ( JET_errSuccess == ( err = JetMove( sesid, tableid, JET_MoveNext, NO_GRBIT ) ) );
+
+	Fail( err, JET_errNoCurrentRecord );
+	err = JET_errSuccess;
+
+	if ( lExpected != lRangeEnd + 1 )
+		{
+		printf( "\trange ended at %d instead of %d\r\n", lExpected - 1, lRangeEnd );
+		err = -1;
+		}
+
+HandleError:
+	return err;
+	}
+
+
+//  ================================================================
+JET_ERR RANGEPREREAD::ErrTest(
+	const JET_INSTANCE instance,
+	const JET_SESID sesid,
+	JET_DBID& dbid )
+//  ================================================================
+	{
+	JET_ERR			err			= 0;
+	JET_TABLEID 	tableid		= 0;
+	JET_COLUMNID	columnid;
+	JET_COLUMNID	columnidPad;
+	JET_INSTANCE	instanceT	= instance;
+	JET_API_PTR		ulParam;
+	long			l;
+
+	Call( JetBeginTransaction( sesid ) );
+	Call( JetCreateTableColumnIndex( sesid, dbid, &tablecreate ) );
+	Call( JetCloseTable( sesid, tablecreate.tableid ) );
+	Call( JetCommitTransaction( sesid, 0 ) );
+
+	columnid	= tablecreate.rgcolumncreate[0].columnid;
+	columnidPad	= tablecreate.rgcolumncreate[1].columnid;
+
+	Call( JetOpenTable( sesid, dbid, szMyTable, NULL, 0, 0, &tableid ) );
+
+	printf( "\tInserting %d records...\r\n", lRecordMax );
+	memset( rgbPad, 'x', sizeof( rgbPad ) );
+	Call( JetBeginTransaction( sesid ) );
+	for ( l = 0; l < lRecordMax; l++ )
+		{
+		Call( JetPrepareUpdate( sesid, tableid, JET_prepInsert ) );
+		Call( JetSetColumn( sesid, tableid, columnid, &l, sizeof( l ), NO_GRBIT, NULL ) );
+		Call( JetSetColumn( sesid, tableid, columnidPad, rgbPad, sizeof( rgbPad ), NO_GRBIT, NULL ) );
+		Call( JetUpdate( sesid, tableid, NULL, 0, NULL ) );
+
+		if ( 0 == ( l + 1 ) % 1000 )
+			{
+			Call( JetCommitTransaction( sesid, JET_bitCommitLazyFlush ) );
+			Call( JetBeginTransaction( sesid ) );
+			}
+		}
+	Call( JetCommitTransaction( sesid, JET_bitCommitLazyFlush ) );
+
+	//	the read-ahead depth is capped at 1024 pages
+
+	printf( "\tChecking JET_paramPrereadIndexRangeMax...\r\n" );
+	Fail( JetSetSystemParameter( &instanceT, 0, JET_paramPrereadIndexRangeMax, 1025, NULL ), JET_errInvalidParameter );
+	Call( JetSetSystemParameter( &instanceT, 0, JET_paramPrereadIndexRangeMax, 1024, NULL ) );
+	Call( JetSetSystemParameter( &instanceT, 0, JET_paramPrereadIndexRangeMax, 4, NULL ) );
+	Call( JetGetSystemParameter( instance, sesid, JET_paramPrereadIndexRangeMax, &ulParam, NULL, 0 ) );
+	if ( 4 != ulParam )
+		{
+		printf( "\tJET_paramPrereadIndexRangeMax is %d instead of 4\r\n", ulParam );
+		err = -1;
+		goto HandleError;
+		}
+
+	//	walk the range with a shallow and with the full read-ahead depth
+
+	printf( "\tWalking range with a read-ahead depth of 4...\r\n" );
+	Call( ErrCheckRange( sesid, tableid, columnid ) );
+
+	Call( JetSetSystemParameter( &instanceT, 0, JET_paramPrereadIndexRangeMax, 1024, NULL ) );
+	printf( "\tWalking range with a read-ahead depth of 1024...\r\n" );
+	Call( ErrCheckRange( sesid, tableid, columnid ) );
+
+HandleError:
+	(void)JetSetSystemParameter( &instanceT, 0, JET_paramPrereadIndexRangeMax, 0, NULL );
+	if ( 0 != tableid )
+		{
+		(void)JetCloseTable( sesid, tableid );
+		}
+	return err;
+	}
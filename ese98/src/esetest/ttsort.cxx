@@ -0,0 +1,159 @@
+#include "unittest.hxx"
+
+//  ================================================================
+class TTSORT : public UNITTEST
+//  ================================================================
+	{
+	private:
+		static TTSORT s_instance;
+
+	protected:
+		TTSORT() {}
+
+	public:
+		~TTSORT() {}
+
+	public:
+		const char * SzName() const;
+		const char * SzDescription() const;
+
+		bool FRunUnderESE98() const;
+		bool FRunUnderESENT() const;
+		bool FRunUnderESE97() const;
+
+		JET_ERR ErrTest(
+				const JET_INSTANCE instance,
+				const JET_SESID sesid,
+				JET_DBID& dbid );
+	};
+
+TTSORT TTSORT::s_instance;
+
+
+//  ================================================================
+const char * TTSORT::SzName() const
+//  ================================================================
+	{
+	return "ttsort";
+	}
+
+
+//  ================================================================
+const char * TTSORT::SzDescription() const
+//  ================================================================
+	{
+	return	"Sort a forward-only temp table with more records than fit in the initial\r\n"
+			"sort pair buffer and in one run, and check that every record comes back\r\n"
+			"once, in key order, with its own data.";
+	}
+
+
+//  ================================================================
+bool TTSORT::FRunUnderESE98() const
+//  ================================================================
+	{
+	return 1;
+	}
+
+
+//  ================================================================
+bool TTSORT::FRunUnderESENT() const
+//  ================================================================
+	{
+	return 0;
+	}
+
+
+//  ================================================================
+bool TTSORT::FRunUnderESE97() const
+//  ================================================================
+	{
+	return 0;
+	}
+
+
+//	enough records to outgrow the initial sort pair buffer and then the grown
+//	one, so that the sort goes through the parallel in-memory sort and a merge
+
+static const long	lRecordMax	= 40000;
+
+//	a multiplier prime to lRecordMax, used to insert the keys out of order
+
+static const long	lScramble	= 7919;
+
+
+//  ================================================================
+JET_ERR TTSORT::ErrTest(
+	const JET_INSTANCE instance,
+	const JET_SESID sesid,
+	JET_DBID& dbid )
+//  ================================================================
+	{
+	JET_ERR			err			= 0;
+	JET_TABLEID		tableid		= 0;
+	JET_COLUMNDEF	rgcolumndef[2];
+	JET_COLUMNID	rgcolumnid[2];
+	long			lExpected	= 0;
+	long			l;
+	long			lKey;
+	long			lData;
+	unsigned long	cbActual;
+
+	memset( rgcolumndef, 0, sizeof( rgcolumndef ) );
+	rgcolumndef[0].cbStruct	= sizeof( JET_COLUMNDEF );
+	rgcolumndef[0].coltyp	= JET_coltypLong;
+	rgcolumndef[0].grbit	= JET_bitColumnTTKey;
+	rgcolumndef[1].cbStruct	= sizeof( JET_COLUMNDEF );
+	rgcolumndef[1].coltyp	= JET_coltypLong;
+
+	Call( JetOpenTempTable(
+			sesid,
+			rgcolumndef,
+			sizeof( rgcolumndef ) / sizeof( JET_COLUMNDEF ),
+			JET_bitTTForwardOnly,
+			&tableid,
+			rgcolumnid ) );
+
+	printf( "\tInserting %d records...\r\n", lRecordMax );
+	for ( l = 0; l < lRecordMax; l++ )
+		{
+		lKey	= ( l * lScramble ) % lRecordMax;
+		lData	= lKey * 3;
+		Call( JetPrepareUpdate( sesid, tableid, JET_prepInsert ) );
+		Call( JetSetColumn( sesid, tableid, rgcolumnid[0], &lKey, sizeof( lKey ), NO_GRBIT, NULL ) );
+		Call( JetSetColumn( sesid, tableid, rgcolumnid[1], &lData, sizeof( lData ), NO_GRBIT, NULL ) );
+		Call( JetUpdate( sesid, tableid, NULL, 0, NULL ) );
+		}
+
+	printf( "\tReading sorted records...\r\n" );
+	err = JetMove( sesid, tableid, JET_MoveFirst, NO_GRBIT );
+	while ( JET_errSuccess == err )
+		{
+		Call( JetRetrieveColumn( sesid, tableid, rgcolumnid[0], &lKey, sizeof( lKey ), &cbActual, NO_GRBIT, NULL ) );
+		Call( JetRetrieveColumn( sesid, tableid, rgcolumnid[1], &lData, sizeof( lData ), &cbActual, NO_GRBIT, NULL ) );
+		if ( lKey != lExpected || lData != lExpected * 3 )
+			{
+			printf( "\trecord %d (data %d) returned where %d was expected\r\n", lKey, lData, lExpected );
+			err = -1;
+			goto HandleError;
+			}
+		lExpected++;
+		err = JetMove( sesid, tableid, JET_MoveNext, NO_GRBIT );
+		}
+
+	Fail( err, JET_errNoCurrentRecord );
+	err = JET_errSuccess;
+
+	if ( lExpected != lRecordMax )
+		{
+		printf( "\t%d records returned instead of %d\r\n", lExpected, lRecordMax );
+		err = -1;
+		}
+
+HandleError:
+	if ( 0 != tableid )
+		{
+		(void)JetCloseTable( sesid, tableid );
+		}
+	return err;
+	}
@@ -621,9 +621,10 @@ ERR ErrBFICachePage(	PBF* const	ppbf,
 						const PGNO	pgno,
 						const BOOL	fUseHistory	= fTrue,
 						const BOOL	fWait		= fTrue,
-						const BOOL	fMRU		= fTrue );
+						const BOOL	fMRU		= fTrue,
+						const BOOL	fCold		= fFalse );
 ERR ErrBFIVersionPage( PBF pbf, PBF* ppbfOld );
-ERR ErrBFIPrereadPage( IFMP ifmp, PGNO pgno );
+ERR ErrBFIPrereadPage( IFMP ifmp, PGNO pgno, const BOOL fSequential = fFalse );
 
 INLINE ERR ErrBFIValidatePage( const PBF pbf, const BFLatchType bflt );
 ERR ErrBFIValidatePageSlowly( PBF pbf, const BFLatchType bflt );
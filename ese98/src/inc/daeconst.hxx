@@ -37,6 +37,7 @@ const LONG lSLVDefragMoveThresholdDefault = 5;  // chunks whose free % is <= thi
 //  preread constants
 const CPG	cpgPrereadSequential		= 1024;	//  number of pages to preread in a table opened sequentially
 const CPG	cpgPrereadPredictive		= 16;	//  number of pages to preread if we guess we are prereading
+const CPG	cpgPrereadIndexRangeDefault	= cpgPrereadSequential;	//  default number of pages to preread on an index range
 
 const LONG	cbSequentialDataPrereadThreshold	= 64 * 1024;
 
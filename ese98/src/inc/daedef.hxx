@@ -499,6 +499,8 @@ extern LONG g_lSLVDefragMoveThreshold;  // chunks whose free % is <= this will b
 
 extern LONG	g_cbPageHintCache;
 
+extern CPG	g_cpgPrereadIndexRange;
+
 extern BOOL	g_fOneDatabasePerSession;
 
 extern ULONG g_ulVERTasksPostMax;
@@ -162,6 +162,7 @@ INLINE VOID DIRAfterLast( FUCB *pfucb )		{ pfucb->locLogical = locAfterLast; }
 VOID DIRSetIndexRange( FUCB *pfucb, JET_GRBIT grbit );
 VOID DIRResetIndexRange( FUCB *pfucb );
 ERR ErrDIRCheckIndexRange( FUCB *pfucb );
+ERR ErrDIRPrereadIndexRange( FUCB *pfucb );
 
 //	********************************************
 //	update operations
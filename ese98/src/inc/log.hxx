@@ -550,6 +550,12 @@ class NODELOC
 #define fRedoLogFile			2
 #define fNormalClose			3
 
+//	group commit
+
+const INT	cLGCommitLatencyBuckets		= 32;		//	log2( usec ) histogram of commit waits
+const LONG	cLGCommitLatencySamplesMax	= 4096;		//	histogram is halved past this many samples
+const INT	cLGGroupCommitYieldMax		= 4;		//	max yields spent gathering a commit batch
+
 
 
 #ifdef UNLIMITED_DB
@@ -892,6 +898,14 @@ public:
 	PIB				*m_ppibLGFlushQHead;
 	PIB				*m_ppibLGFlushQTail;
 
+	//	group commit: sessions on the wait queue, recent commits per flush
+	//	(scaled by 16) and a histogram of how long commits waited for the log
+
+	volatile LONG	m_cLGWaiting;
+	volatile LONG	m_cLGCommitBatchAvg;
+	volatile LONG	m_rgcLGCommitLatency[ cLGCommitLatencyBuckets ];
+	volatile LONG	m_cLGCommitLatencySamples;
+
 
 	//  Perfmon stuff: also monitoring statistics
 
@@ -1140,6 +1154,10 @@ VOID SetupLastFileChecksum(
 BOOL FWakeWaitingQueue(
 	LGPOS* plgposToFlush
 	);
+VOID LGIRecordCommitLatency(
+	const QWORD qwStart
+	);
+VOID LGIUpdateCommitLatencyCounters();
 ERR ErrLGIWriteFullSectors(
 	IFileSystemAPI *const pfsapi,
 	const UINT			csecFull,
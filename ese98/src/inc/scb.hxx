@@ -6,9 +6,14 @@
 
 //  tune these constants for optimal performance
 
-//  maximum amount of fast memory (cache) to use for sorting
+//  amount of fast memory (cache) to use for sorting
 const LONG cbSortMemFast = ( 16 * ( 4088 + 1 ) );
 
+//  maximum amount of fast memory (cache) to use for a sort that outgrows cbSortMemFast
+//  NOTE:  sized so that runs of small records are bounded by normal memory
+//  rather than by the number of sort pairs
+const LONG cbSortMemFastMax = ( 16 * ( 16376 + 1 ) );
+
 //  maximum amount of normal memory to use for sorting
 const LONG cbSortMemNorm = ( 1024 * 1024 );
 
@@ -22,6 +27,12 @@ const LONG cspairQSortMin = 32;
 //  maximum partition stack depth for Quicksort
 const LONG cpartQSortMax = 16;
 
+//  minimum count of sort pairs worth splitting across threads for Quicksort
+const LONG cspairQSortParallelMin = 4096;
+
+//  maximum count of threads used to Quicksort one sort buffer
+const LONG cthreadQSortParallelMax = 4;
+
 //  maximum count of runs to merge at once (fan-in)
 const LONG crunFanInMax = 16;
 
@@ -127,12 +138,18 @@ struct SPAIR
 #define irecSortMax ( cbSortMemNormUsed / cbIndexGran )
 
 //  maximum count of SPAIRs' data that can be stored in fast sort memory
-//  NOTE:  we are reserving one for temporary sort key storage (at cspairSortMax)
+//  NOTE:  one spare SPAIR is allocated past the end (at cspairSortMax)
 const INT cspairSortMax = cbSortMemFast / sizeof( SPAIR ) - 1;
 
 //  amount of fast memory actually used for sorting (counting reserve SPAIR)
 const INT cbSortMemFastUsed = ( cspairSortMax + 1 ) * sizeof( SPAIR );
 
+//  maximum count of SPAIRs' data that can be stored in grown fast sort memory
+const INT cspairSortMaxGrown = cbSortMemFastMax / sizeof( SPAIR ) - 1;
+
+//  amount of grown fast memory actually used for sorting (counting reserve SPAIR)
+const INT cbSortMemFastMaxUsed = ( cspairSortMaxGrown + 1 ) * sizeof( SPAIR );
+
 //  count of "Sort Record indexes" required to store count bytes of data
 //      (This is fast if numbers are chosen to make cbIndexGran a power of 2
 //      (especially 1) due to compiler optimizations)
@@ -305,7 +322,7 @@ struct SCB
 //	392 bytes
 
 	//  merge duplicate removal
-	BYTE		rgbReserved1[4];			//  FREE SPACE
+	LONG		cspairMax;					//  capacity of sort pair buffer
 	BFLatch		bflLast;					//  last used read ahead buffer
 //	400 bytes
 	VOID		*pvAssyLast;				//  last used assembly buffer
@@ -1597,6 +1597,11 @@ public:
 	DWORD_PTR			m_dwTrxContextLastLongRunningTransaction;
 	TRX					m_trxBegin0LastLongRunningTransaction;
 
+	//	oldest transaction that held back the last pass of RCE clean and
+	//	when it was first seen doing so (trxMax if RCE clean was not held back)
+	TRX					m_trxRCECleanPinned;
+	TICK				m_tickRCECleanPinned;
+
 	BOOL				m_fSyncronousTasks;
 
 	//	WARNING: if GLOBAL_VERSTORE_MEMPOOL, this will simply point to g_pcresVERPool
@@ -1628,6 +1633,7 @@ private:
 
 	VOID VERIReportDiscardedDeletes( const RCE * const prce );
 	VOID VERIReportVersionStoreOOM( const BOOL fCleanupBlocked );
+	VOID VERIUpdateRCECleanPinned( const TRX trxOldest );
 
 	//  BUCKET LAYER
 
@@ -66,10 +66,17 @@ typedef struct {
  * LHBFS is faster than LHOnline but the implementation is more
  * complicated. It can take an existing matching as input and incrementally
  * improve it until it becomes optimal.
+ *
+ * LH_ALG_BFS_CSR runs the LHBFS algorithm on a compact array copy of the
+ * graph, which is friendlier to the cache on large graphs. On
+ * multiprocessor machines, large BFS levels are expanded by several
+ * threads. The resulting matching is also optimal but may differ from the
+ * one LH_ALG_BFS finds.
  */
 typedef enum {
     LH_ALG_ONLINE,
-    LH_ALG_BFS
+    LH_ALG_BFS,
+    LH_ALG_BFS_CSR
 } LHALGTYPE;
 #define LH_ALG_DEFAULT       LH_ALG_BFS
 
@@ -151,6 +158,82 @@ int LHAddEdge( LHGRAPH graph, int lhsVtx, int rhsVtx );
 int LHSetMatchingEdge( LHGRAPH graph, int lhsVtx, int rhsVtx );
 
 
+/***** LHRemoveEdge *****/
+/*
+ * Description:
+ *
+ *      Remove the edge connecting lhsVtx and rhsVtx from the graph. If it
+ *      was a matching edge, lhsVtx becomes unmatched until the next call
+ *      to LHRepairMatching or LHFindLHMatching.
+ *
+ * Parameters:
+ *
+ *      IN  graph       A graph successfully created by LHGraphCreate.
+ *      
+ *      IN  lhsVtx      The ID of the left-hand vertex. Legal values are
+ *                      0 <= lhsVtx < numLHSVtx
+ *
+ *      IN  rhsVtx      The ID of the right-hand vertex. Legal values are
+ *                      0 <= rhsVtx < numRHSVtx
+ *
+ *  Return Value:
+ *
+ *      Error Code. LH_PARAM_ERR if the edge does not exist.
+ */
+int LHRemoveEdge( LHGRAPH graph, int lhsVtx, int rhsVtx );
+
+
+/***** LHAddVertices *****/
+/*
+ * Description:
+ *
+ *      Add vertices to the graph. The new vertices have no edges and
+ *      receive the next unused IDs on their side of the graph; existing
+ *      edges and the current matching are preserved.
+ *
+ * Parameters:
+ *
+ *      IN  graph       A graph successfully created by LHGraphCreate.
+ *
+ *      IN  numLHSVtx   The number of vertices to add on the left-hand
+ *                      side. Must be >= 0.
+ *
+ *      IN  numRHSVtx   The number of vertices to add on the right-hand
+ *                      side. Must be >= 0.
+ *
+ *  Return Value:
+ *
+ *      Error Code
+ */
+int LHAddVertices( LHGRAPH graph, int numLHSVtx, int numRHSVtx );
+
+
+/***** LHIsolateVertex *****/
+/*
+ * Description:
+ *
+ *      Remove all edges incident to a vertex. Vertex IDs are never reused
+ *      or renumbered, so this is how a vertex is removed from the graph:
+ *      an isolated left-hand vertex stays unmatched and an isolated
+ *      right-hand vertex carries no load.
+ *
+ * Parameters:
+ *
+ *      IN  graph       A graph successfully created by LHGraphCreate.
+ *      
+ *      IN  vtxID       The ID of the vertex to isolate.
+ *
+ *      IN  left        If the vertex is a left-vertex, this parameter
+ *                      should be TRUE. If the vertex is a right-vertex,
+ *                      this parameter should be FALSE.
+ *
+ *  Return Value:
+ *
+ *      Error Code
+ */
+int LHIsolateVertex( LHGRAPH graph, int vtxID, char left );
+
+
 /***** LHGetDegree *****/
 /*
  * Description:
@@ -249,6 +332,31 @@ int LHGetNeighbour( LHGRAPH graph, int vtxID, char left, int n );
 int LHFindLHMatching( LHGRAPH graph, LHALGTYPE alg );
 
 
+/***** LHRepairMatching *****/
+/*
+ * Description:
+ *
+ *      Bring the current matching back to optimal after the graph was
+ *      edited with LHAddEdge, LHRemoveEdge, LHIsolateVertex, LHAddVertices
+ *      or LHSetMatchingEdge. Unlike LHFindLHMatching, this keeps as much
+ *      of the current matching as possible: left-hand vertices that lost
+ *      their matching edge are assigned greedily and the existing
+ *      matching is then improved, which is much cheaper than building a
+ *      new graph and matching it from scratch. The cost of the resulting
+ *      matching is the same as LHFindLHMatching would produce.
+ *      
+ * Parameters:
+ *
+ *      IN  graph       A graph successfully created by LHGraphCreate,
+ *                      for which LHFindLHMatching was previously called.
+ *
+ *  Return Value:
+ *
+ *      Error Code
+ */
+int LHRepairMatching( LHGRAPH graph );
+
+
 /***** LHGetMatchedVtx *****/
 /*
  * Description:
@@ -332,3 +332,59 @@ int LHAlgBFS(Graph *g) {
 
     return LH_SUCCESS;
 }
+
+/***** LHAlgRepair *****/
+/* Restore an optimal matching after the graph was edited. The matching
+ * that survived the edits is kept: LHS vertices left unmatched are
+ * assigned to their lowest-load neighbour, and the main loop then only
+ * has to find the few cost-reducing paths the edits created, instead
+ * of starting from a fresh greedy assignment of every LHS vertex. */
+int LHAlgRepair(Graph *g) {
+    Vertex  *u, *r, *bestR;
+    int     i, j, err;
+
+    DPRINT( printf("--- LHMatch Repair Started ---\n"); )
+    #ifdef STATS
+        memset( &g->stats, 0, sizeof(Stats) );
+    #endif
+
+    /* Assign unmatched LHS vertices */
+    for(i=0;i<g->numLHSVtx;i++) {
+        u=&g->lVtx[i];
+        if( NULL!=u->matchedWith || 0==u->degree ) continue;
+
+        /* Find right-hand neighbour with lowest matching-degree */
+        bestR = u->adjList[0];
+        for(j=1;j<u->degree;j++) {
+            r=u->adjList[j];
+            if(r->numMatched<bestR->numMatched)
+                bestR=r;
+        }
+
+        /* Assign LHS vertex to lowest matching-degree RHS vertex */
+        u->matchedWith = bestR;
+        u->numMatched = 1;
+        bestR->numMatched++;
+    }
+
+    err = InitializeBFS(g);
+    if( LH_SUCCESS!=err ) {
+        return err;
+    }
+
+    err = InitializeRHSBuckets(g);
+    if( LH_SUCCESS!=err ) {
+        DestroyQueue(g);
+        return err;
+    }
+
+    MainLoop(g);
+
+    /* Cleanup */
+    DestroyQueue(g);
+    DestroyBuckets(g);
+    PrintStats(g);
+    DPRINT( printf("--- LHMatch Repair Finished ---\n"); )
+
+    return LH_SUCCESS;
+}
@@ -0,0 +1,536 @@
+/******************************************************************************
+ *
+ * LHMatch BFS over a CSR graph
+ *
+ * Algorithm Description:
+ *
+ * This is the LHBFS algorithm (see LHBFS.c) run on a frozen copy of the
+ * graph. After the initial greedy assignment, the adjacency lists are
+ * packed into compressed-sparse-row arrays and all per-vertex state is
+ * kept in parallel integer arrays indexed by vertex ID. The breadth-first
+ * searches then walk contiguous memory instead of chasing Vertex and
+ * adjacency-list pointers. When the search is done the matching is
+ * copied back into the Vertex structures.
+ *
+ * Vertex IDs are the same as Vertex.id: left-hand vertices are numbered
+ * 0..numLHSVtx-1 and right-hand vertices numLHSVtx..numLHSVtx+numRHSVtx-1.
+ *
+ * Parallelism:
+ *
+ * On multiprocessor machines, large graphs are searched with a pool of
+ * worker threads. Each BFS proceeds level by level; a level with at least
+ * CSR_PARALLEL_FRONTIER vertices is expanded by all threads at once, which
+ * claim vertices with an interlocked compare-exchange on their parent
+ * entry. Any cost-reducing path is as good as another, so the BFS tree
+ * found by the threads may differ from the serial one but the resulting
+ * matching has the same (optimal) cost.
+ *
+ ******************************************************************************/
+
+/***** Header Files *****/
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "LHMatchInt.h"
+
+
+/***** Constants *****/
+/* CSR_PARALLEL_MIN_EDGES: Graphs with fewer edges are searched serially */
+#define CSR_PARALLEL_MIN_EDGES      (64*1024)
+
+/* CSR_PARALLEL_FRONTIER: Smallest BFS level that is expanded in parallel */
+#define CSR_PARALLEL_FRONTIER       1024
+
+/* CSR_CHUNK: Number of queue entries a thread takes at a time */
+#define CSR_CHUNK                   64
+
+/* CSR_LOCAL_QUEUE: Size of the per-thread buffer of discovered vertices */
+#define CSR_LOCAL_QUEUE             256
+
+/* CSR_MAX_THREADS: Maximum number of worker threads */
+#define CSR_MAX_THREADS             32
+
+#define CSR_NONE                    (-1)
+
+
+/***** CSR Graph Structure *****/
+typedef struct {
+    /* g: The graph this is a copy of */
+    Graph   *g;
+
+    int     numLHSVtx;
+    int     numRHSVtx;
+
+    /* lOffset, lAdj: Neighbours (RHS IDs) of LHS vertex i are
+     * lAdj[lOffset[i]] .. lAdj[lOffset[i+1]-1]. */
+    int     *lOffset, *lAdj;
+
+    /* rOffset, rAdj: Neighbours (LHS IDs) of RHS vertex j are
+     * rAdj[rOffset[j]] .. rAdj[rOffset[j+1]-1]. Indexed by ID-numLHSVtx. */
+    int     *rOffset, *rAdj;
+
+    /* match: For each LHS vertex, the ID of its partner or CSR_NONE */
+    int     *match;
+
+    /* load: For each RHS vertex, the number of matched neighbours */
+    int     *load;
+
+    /* parent: For each vertex, its parent in the BFS tree or CSR_NONE */
+    volatile LONG *parent;
+
+    /* queue, qSize: Vertices visited since the marks were last cleared */
+    int     *queue;
+    volatile LONG qSize;
+
+    /* bucket, fLink, bLink: RHS vertices in doubly-linked lists by load.
+     * fLink and bLink are indexed by ID-numLHSVtx. */
+    int     *bucket, *fLink, *bLink;
+    int     maxRHSLoad;
+
+    /* Parallel search state */
+    int     cThreads;
+    HANDLE  rghThread[CSR_MAX_THREADS];
+    HANDLE  hStart;             /* Semaphore: one count per worker per level */
+    HANDLE  hDone;              /* Auto-reset: last thread finished the level */
+    volatile LONG cBusy;        /* Threads still expanding the level */
+    volatile LONG fExit;        /* Workers should exit */
+    volatile LONG nextQ;        /* Next queue entry to expand */
+    int     qEnd;               /* End of the level being expanded */
+    int     goal;               /* Load a vertex needs to end a path */
+    volatile LONG found;        /* End of a cost-reducing path, or CSR_NONE */
+} CsrGraph;
+
+
+/***** CsrFree *****/
+static void CsrFree( CsrGraph *c ) {
+    free(c->lOffset);
+    free(c->lAdj);
+    free(c->rOffset);
+    free(c->rAdj);
+    free(c->match);
+    free(c->load);
+    free((void*) c->parent);
+    free(c->queue);
+    free(c->bucket);
+    free(c->fLink);
+    free(c->bLink);
+}
+
+/***** CsrFreeze *****/
+/* Build the CSR copy of g, including its current matching */
+static int CsrFreeze( Graph *g, CsrGraph *c ) {
+    int     i, j, k, numEdges, numVtx, maxRHSLoad;
+    Vertex  *v;
+
+    memset(c, 0, sizeof(CsrGraph));
+    c->g = g;
+    c->numLHSVtx = g->numLHSVtx;
+    c->numRHSVtx = g->numRHSVtx;
+    numVtx = g->numLHSVtx + g->numRHSVtx;
+
+    numEdges = 0;
+    maxRHSLoad = 0;
+    for(j=0;j<g->numRHSVtx;j++) {
+        numEdges += g->rVtx[j].degree;
+        maxRHSLoad = INTMAX(maxRHSLoad, g->rVtx[j].numMatched);
+    }
+
+    c->lOffset = (int*) malloc( (g->numLHSVtx+1)*sizeof(int) );
+    c->lAdj = (int*) malloc( INTMAX(numEdges,1)*sizeof(int) );
+    c->rOffset = (int*) malloc( (g->numRHSVtx+1)*sizeof(int) );
+    c->rAdj = (int*) malloc( INTMAX(numEdges,1)*sizeof(int) );
+    c->match = (int*) malloc( g->numLHSVtx*sizeof(int) );
+    c->load = (int*) malloc( g->numRHSVtx*sizeof(int) );
+    c->parent = (volatile LONG*) malloc( numVtx*sizeof(LONG) );
+    c->queue = (int*) malloc( numVtx*sizeof(int) );
+    c->bucket = (int*) malloc( (maxRHSLoad+1)*sizeof(int) );
+    c->fLink = (int*) malloc( g->numRHSVtx*sizeof(int) );
+    c->bLink = (int*) malloc( g->numRHSVtx*sizeof(int) );
+    if( !c->lOffset || !c->lAdj || !c->rOffset || !c->rAdj || !c->match
+        || !c->load || !c->parent || !c->queue || !c->bucket
+        || !c->fLink || !c->bLink )
+    {
+        CsrFree(c);
+        return LH_MEM_ERR;
+    }
+
+    /* Pack the adjacency lists */
+    for(i=0,k=0;i<g->numLHSVtx;i++) {
+        v = &g->lVtx[i];
+        c->lOffset[i] = k;
+        for(j=0;j<v->degree;j++) {
+            c->lAdj[k++] = v->adjList[j]->id;
+        }
+        c->match[i] = v->matchedWith ? v->matchedWith->id : CSR_NONE;
+    }
+    c->lOffset[i] = k;
+    for(i=0,k=0;i<g->numRHSVtx;i++) {
+        v = &g->rVtx[i];
+        c->rOffset[i] = k;
+        for(j=0;j<v->degree;j++) {
+            c->rAdj[k++] = v->adjList[j]->id;
+        }
+        c->load[i] = v->numMatched;
+    }
+    c->rOffset[i] = k;
+
+    /* Clear the marks */
+    for(i=0;i<numVtx;i++) {
+        c->parent[i] = CSR_NONE;
+    }
+    c->qSize = 0;
+
+    /* Insert all RHS vertices with neighbours into buckets */
+    c->maxRHSLoad = maxRHSLoad;
+    for(i=0;i<=maxRHSLoad;i++) {
+        c->bucket[i] = CSR_NONE;
+    }
+    for(i=0;i<g->numRHSVtx;i++) {
+        if( c->rOffset[i+1]>c->rOffset[i] ) {
+            j = c->load[i];
+            c->fLink[i] = c->bucket[j];
+            c->bLink[i] = CSR_NONE;
+            if( CSR_NONE!=c->bucket[j] ) c->bLink[c->bucket[j]] = i;
+            c->bucket[j] = i;
+        }
+    }
+
+    c->found = CSR_NONE;
+    return LH_SUCCESS;
+}
+
+/***** CsrThaw *****/
+/* Copy the matching back into g */
+static void CsrThaw( CsrGraph *c ) {
+    Graph   *g = c->g;
+    int     i;
+
+    for(i=0;i<g->numLHSVtx;i++) {
+        g->lVtx[i].matchedWith = (CSR_NONE==c->match[i])
+            ? NULL : &g->rVtx[c->match[i]-g->numLHSVtx];
+    }
+    for(i=0;i<g->numRHSVtx;i++) {
+        g->rVtx[i].numMatched = c->load[i];
+    }
+}
+
+/***** CsrMoveVtx *****/
+/* Move RHS vertex r (index, not ID) from bucket 'from' to bucket 'to' */
+static void CsrMoveVtx( CsrGraph *c, int r, int from, int to ) {
+    if( CSR_NONE!=c->fLink[r] ) c->bLink[c->fLink[r]] = c->bLink[r];
+    if( CSR_NONE!=c->bLink[r] ) {
+        c->fLink[c->bLink[r]] = c->fLink[r];
+    } else {
+        c->bucket[from] = c->fLink[r];
+    }
+
+    c->fLink[r] = c->bucket[to];
+    c->bLink[r] = CSR_NONE;
+    if( CSR_NONE!=c->bucket[to] ) c->bLink[c->bucket[to]] = r;
+    c->bucket[to] = r;
+}
+
+/***** CsrUpdateNegPath *****/
+/* Switch the matching along the path from u to v found by the BFS and
+ * move the endpoints to their new buckets. u and v are IDs. */
+static void CsrUpdateNegPath( CsrGraph *c, int u, int v ) {
+    int     w, p, L = c->numLHSVtx;
+
+    assert( c->load[u-L] <= c->load[v-L]-2 );
+
+    w=v;
+    do {
+        p=c->parent[w];
+        assert( p<L );
+        w=c->parent[p];
+        c->match[p]=w;
+    } while(w!=u);
+
+    CsrMoveVtx(c, u-L, c->load[u-L], c->load[u-L]+1);
+    c->load[u-L]++;
+    CsrMoveVtx(c, v-L, c->load[v-L], c->load[v-L]-1);
+    c->load[v-L]--;
+}
+
+/***** CsrExpandSerial *****/
+/* Expand queue entries q..qEnd-1 (one BFS level). Returns the end of a
+ * cost-reducing path or CSR_NONE. */
+static int CsrExpandSerial( CsrGraph *c, int q, int qEnd ) {
+    const int   L = c->numLHSVtx;
+    int         v, n, m, k, kEnd;
+
+    for(; q<qEnd; q++ ) {
+
+        v = c->queue[q];
+        if( v<L ) {
+            continue;       /* LHS vertices are only queued to be unmarked */
+        }
+
+        /* Examine each of v's neighbours */
+        kEnd = c->rOffset[v-L+1];
+        for( k=c->rOffset[v-L]; k<kEnd; k++ ) {
+            n = c->rAdj[k];
+            if( c->match[n]==v || CSR_NONE!=c->parent[n] ) {
+                continue;
+            }
+            c->parent[n] = v;
+            c->queue[c->qSize++] = n;
+
+            m = c->match[n];
+            if( CSR_NONE!=c->parent[m] ) {
+                continue;
+            }
+            c->parent[m] = n;
+            c->queue[c->qSize++] = m;
+            if( c->load[m-L]>=c->goal ) {
+                return m;
+            }
+        }
+    }
+
+    return CSR_NONE;
+}
+
+/***** CsrFlush *****/
+/* Append a thread's buffer of discovered vertices to the queue */
+static __forceinline void CsrFlush( CsrGraph *c, int *buf, int *pCount ) {
+    LONG    q;
+
+    if( *pCount ) {
+        q = InterlockedExchangeAdd( (LONG*) &c->qSize, *pCount );
+        memcpy( &c->queue[q], buf, *pCount*sizeof(int) );
+        *pCount = 0;
+    }
+}
+
+/***** CsrExpandParallel *****/
+/* Body run by every thread to expand queue entries nextQ..qEnd-1. Vertices
+ * are claimed by setting their parent with a compare-exchange, so each one
+ * is queued by exactly one thread. */
+static void CsrExpandParallel( CsrGraph *c ) {
+    const int   L = c->numLHSVtx;
+    int         buf[CSR_LOCAL_QUEUE], count=0;
+    int         q, qEnd, v, n, m, k, kEnd;
+
+    for(;;) {
+        q = InterlockedExchangeAdd( (LONG*) &c->nextQ, CSR_CHUNK );
+        if( q>=c->qEnd || CSR_NONE!=c->found ) {
+            break;
+        }
+        qEnd = INTMIN( q+CSR_CHUNK, c->qEnd );
+
+        for(; q<qEnd; q++ ) {
+            v = c->queue[q];
+            if( v<L ) {
+                continue;
+            }
+
+            kEnd = c->rOffset[v-L+1];
+            for( k=c->rOffset[v-L]; k<kEnd; k++ ) {
+                n = c->rAdj[k];
+                if( c->match[n]==v || CSR_NONE!=c->parent[n] ) {
+                    continue;
+                }
+                if( CSR_NONE!=InterlockedCompareExchange(
+                        (LONG*) &c->parent[n], v, CSR_NONE ) ) {
+                    continue;   /* Another thread got there first */
+                }
+                if( count>CSR_LOCAL_QUEUE-2 ) {
+                    CsrFlush(c, buf, &count);
+                }
+                buf[count++] = n;
+
+                m = c->match[n];
+                if( CSR_NONE!=c->parent[m]
+                    || CSR_NONE!=InterlockedCompareExchange(
+                        (LONG*) &c->parent[m], n, CSR_NONE ) ) {
+                    continue;
+                }
+                buf[count++] = m;
+                if( c->load[m-L]>=c->goal ) {
+                    InterlockedCompareExchange( (LONG*) &c->found, m, CSR_NONE );
+                    goto done;
+                }
+            }
+        }
+    }
+
+done:
+    CsrFlush(c, buf, &count);
+}
+
+/***** CsrWorker *****/
+static DWORD WINAPI CsrWorker( LPVOID arg ) {
+    CsrGraph *c = (CsrGraph*) arg;
+
+    for(;;) {
+        WaitForSingleObject( c->hStart, INFINITE );
+        if( c->fExit ) {
+            break;
+        }
+        CsrExpandParallel(c);
+        if( 0==InterlockedDecrement((LONG*) &c->cBusy) ) {
+            SetEvent( c->hDone );
+        }
+    }
+
+    return 0;
+}
+
+/***** CsrStopThreads *****/
+static void CsrStopThreads( CsrGraph *c ) {
+    int i;
+
+    if( c->cThreads ) {
+        c->fExit = TRUE;
+        ReleaseSemaphore( c->hStart, c->cThreads, NULL );
+        WaitForMultipleObjects( c->cThreads, c->rghThread, TRUE, INFINITE );
+        for(i=0;i<c->cThreads;i++) {
+            CloseHandle( c->rghThread[i] );
+        }
+        c->cThreads = 0;
+    }
+    if( c->hStart ) CloseHandle( c->hStart );
+    if( c->hDone )  CloseHandle( c->hDone );
+    c->hStart = c->hDone = NULL;
+}
+
+/***** CsrStartThreads *****/
+/* Start one worker per additional processor. If anything fails, the
+ * search simply runs with fewer (or no) workers. */
+static void CsrStartThreads( CsrGraph *c ) {
+    SYSTEM_INFO si;
+    int         i, cWanted;
+
+    GetSystemInfo(&si);
+    cWanted = INTMIN( (int) si.dwNumberOfProcessors - 1, CSR_MAX_THREADS );
+    if( cWanted<=0 || c->rOffset[c->numRHSVtx]<CSR_PARALLEL_MIN_EDGES ) {
+        return;
+    }
+
+    c->hStart = CreateSemaphore( NULL, 0, CSR_MAX_THREADS, NULL );
+    c->hDone = CreateEvent( NULL, FALSE, FALSE, NULL );
+    if( NULL==c->hStart || NULL==c->hDone ) {
+        CsrStopThreads(c);
+        return;
+    }
+
+    for(i=0;i<cWanted;i++) {
+        c->rghThread[c->cThreads] = CreateThread( NULL, 0, CsrWorker, c, 0, NULL );
+        if( NULL!=c->rghThread[c->cThreads] ) {
+            c->cThreads++;
+        }
+    }
+}
+
+/***** CsrBFS *****/
+/* Start a BFS from RHS vertex u (an ID) for a cost-reducing path.
+ * Returns the end of the path or CSR_NONE. */
+static int CsrBFS( CsrGraph *c, int u ) {
+    int q, qEnd, m;
+
+    c->parent[u] = u;
+    q = c->qSize;
+    c->queue[c->qSize++] = u;
+    c->goal = c->load[u-c->numLHSVtx]+2;
+
+    /* Expand one level at a time */
+    while( q<c->qSize ) {
+        qEnd = c->qSize;
+
+        if( c->cThreads && qEnd-q>=CSR_PARALLEL_FRONTIER ) {
+            /* Large level: expand it with all threads */
+            c->nextQ = q;
+            c->qEnd = qEnd;
+            c->found = CSR_NONE;
+            c->cBusy = c->cThreads+1;
+            ReleaseSemaphore( c->hStart, c->cThreads, NULL );
+            CsrExpandParallel(c);
+            if( 0!=InterlockedDecrement((LONG*) &c->cBusy) ) {
+                WaitForSingleObject( c->hDone, INFINITE );
+            }
+            m = c->found;
+        } else {
+            m = CsrExpandSerial(c, q, qEnd);
+        }
+
+        if( CSR_NONE!=m ) {
+            return m;
+        }
+        q = qEnd;
+    }
+
+    return CSR_NONE;
+}
+
+/***** CsrFullScan *****/
+/* Iterate over all RHS vertices from low-load to high-load and search
+ * from each unmarked one for a cost-reducing path, as DoFullScan does.
+ * Returns TRUE if any augmentations were made. */
+static char CsrFullScan( CsrGraph *c ) {
+    const int   L = c->numLHSVtx;
+    int         b, r, nextR, m;
+    char        fAugmentedSinceStart=FALSE;
+
+    for( b=0; b<=c->maxRHSLoad-2; b++ ) {
+        for( r=c->bucket[b]; CSR_NONE!=r; r=nextR ) {
+            assert( c->load[r]==b );
+            nextR = c->fLink[r];
+
+            if( CSR_NONE!=c->parent[r+L] ) {
+                continue;       /* Already visited in this pass */
+            }
+
+            m = CsrBFS(c, r+L);
+            if( CSR_NONE!=m ) {
+                CsrUpdateNegPath(c, r+L, m);
+                fAugmentedSinceStart = TRUE;
+            }
+        }
+    }
+
+    /* Update maxRHSLoad */
+    while( CSR_NONE==c->bucket[c->maxRHSLoad] ) c->maxRHSLoad--;
+
+    return fAugmentedSinceStart;
+}
+
+/***** LHAlgBFSCsr *****/
+/* Compute an LH Matching with the LHBFS algorithm on a CSR copy of the
+ * graph, using all processors for large searches. */
+int LHAlgBFSCsr( Graph *g ) {
+    CsrGraph    c;
+    int         err, j;
+    char        fMadeImprovement;
+
+    DPRINT( printf("--- LHMatch BFS (CSR) Started ---\n"); )
+
+    /* Compute an initial greedy assignment on the original graph */
+    err = OrderedGreedyAssignment(g);
+    if( LH_SUCCESS!=err ) {
+        return err;
+    }
+
+    err = CsrFreeze(g, &c);
+    if( LH_SUCCESS!=err ) {
+        return err;
+    }
+    CsrStartThreads(&c);
+
+    /* Main loop: repeat full scans until no more improvements are made */
+    do {
+        for(j=0;j<c.qSize;j++) c.parent[c.queue[j]]=CSR_NONE;
+        c.qSize=0;
+
+        fMadeImprovement = CsrFullScan(&c);
+    } while( fMadeImprovement );
+
+    CsrStopThreads(&c);
+    CsrThaw(&c);
+    CsrFree(&c);
+
+    DPRINT( printf("--- LHMatch BFS (CSR) Finished ---\n"); )
+    return LH_SUCCESS;
+}
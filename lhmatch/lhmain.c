@@ -448,6 +448,235 @@ int LHAddEdge( LHGRAPH graph, int lhsVtx, int rhsVtx ) {
     return LH_SUCCESS;
 }
 
+/***** RemoveAdjListEntry *****/
+/* Remove n from v's adjacency list. Returns FALSE if n was not found. */
+static char RemoveAdjListEntry( Vertex *v, Vertex *n ) {
+    int i;
+
+    for( i=0; i<v->degree; i++ ) {
+        if( v->adjList[i]==n ) {
+            v->adjList[i] = v->adjList[--v->degree];
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/***** RemoveEdge *****/
+/* Remove the edge (lv,rv), which must exist. If it was a matching
+ * edge, lv is left unmatched. */
+static void RemoveEdge( Vertex *lv, Vertex *rv ) {
+    char fFound;
+
+    fFound = RemoveAdjListEntry(lv, rv);
+    assert( fFound );
+    fFound = RemoveAdjListEntry(rv, lv);
+    assert( fFound );
+
+    if( lv->matchedWith==rv ) {
+        lv->matchedWith = NULL;
+        rv->numMatched--;
+    }
+}
+
+/***** LHRemoveEdge *****/
+/*
+ * Description:
+ *
+ *        Remove the edge connecting lhsVtx and rhsVtx from the graph. If it
+ *        was a matching edge, lhsVtx becomes unmatched until the next call
+ *        to LHRepairMatching or LHFindLHMatching.
+ *
+ * Parameters:
+ *
+ *        IN  graph         A graph successfully created by LHGraphCreate.
+ *        
+ *        IN  lhsVtx        The ID of the left-hand vertex. Legal values are
+ *                          0 <= lhsVtx < numLHSVtx
+ *
+ *        IN  rhsVtx        The ID of the right-hand vertex. Legal values are
+ *                          0 <= rhsVtx < numRHSVtx
+ *
+ * Return Value:
+ *
+ *        Error Code. LH_PARAM_ERR if the edge does not exist.
+ */
+int LHRemoveEdge( LHGRAPH graph, int lhsVtx, int rhsVtx ) {
+    Graph     *g;
+    Vertex    *lv, *rv;
+    int        i;
+
+    /* Check parameters */
+    g = CheckGraph(graph);
+    if( NULL==g ) {
+        return LH_PARAM_ERR;
+    }
+    if( lhsVtx<0 || lhsVtx>=g->numLHSVtx ) {
+        return LH_PARAM_ERR;
+    }
+    if( rhsVtx<0 || rhsVtx>=g->numRHSVtx ) {
+        return LH_PARAM_ERR;
+    }
+    
+    /* Get pointers to the two vertices */
+    lv = &g->lVtx[lhsVtx];
+    rv = &g->rVtx[rhsVtx];
+
+    /* Verify that the edge exists */
+    for(i=0;i<lv->degree;i++) {
+        if(lv->adjList[i]==rv) {
+            break;
+        }
+    }
+    if(i==lv->degree) {
+        /* Edge does not exist */
+        return LH_PARAM_ERR;
+    }
+
+    RemoveEdge(lv, rv);
+    return LH_SUCCESS;
+}
+
+/***** LHIsolateVertex *****/
+/*
+ * Description:
+ *
+ *        Remove all edges incident to a vertex. Vertex IDs are never
+ *        reused or renumbered, so this is how a vertex is removed from
+ *        the graph: an isolated left-hand vertex stays unmatched and an
+ *        isolated right-hand vertex carries no load.
+ *
+ * Parameters:
+ *
+ *        IN  graph         A graph successfully created by LHGraphCreate.
+ *        
+ *        IN  vtxID         The ID of the vertex to isolate.
+ *
+ *        IN  left          If the vertex is a left-vertex, this parameter
+ *                          should be TRUE. If the vertex is a right-vertex,
+ *                          this parameter should be FALSE.
+ *
+ * Return Value:
+ *
+ *        Error Code
+ */
+int LHIsolateVertex( LHGRAPH graph, int vtxID, char left ) {
+    Graph     *g;
+    Vertex    *v;
+
+    /* Leverage the LHGetDegree function to do the input validation */
+    if( LHGetDegree(graph, vtxID, left)<0 ) {
+        return LH_PARAM_ERR;
+    }
+    g = CheckGraph(graph);
+
+    if( left ) {
+        v = &g->lVtx[vtxID];
+        while( v->degree>0 ) {
+            RemoveEdge(v, v->adjList[v->degree-1]);
+        }
+    } else {
+        v = &g->rVtx[vtxID];
+        while( v->degree>0 ) {
+            RemoveEdge(v->adjList[v->degree-1], v);
+        }
+    }
+
+    return LH_SUCCESS;
+}
+
+/***** TranslateVtx *****/
+/* Map a pointer into the old vertex arrays to the new ones */
+static Vertex* TranslateVtx( Graph *g, Vertex *v, Vertex *newLVtx, Vertex *newRVtx ) {
+    if( NULL==v ) {
+        return NULL;
+    }
+    if( v>=g->lVtx && v<g->lVtx+g->numLHSVtx ) {
+        return newLVtx + (v-g->lVtx);
+    }
+    assert( v>=g->rVtx && v<g->rVtx+g->numRHSVtx );
+    return newRVtx + (v-g->rVtx);
+}
+
+/***** LHAddVertices *****/
+/*
+ * Description:
+ *
+ *        Add vertices to the graph. The new vertices have no edges and
+ *        receive the next unused IDs on their side of the graph; existing
+ *        edges and the current matching are preserved.
+ *
+ * Parameters:
+ *
+ *        IN  graph         A graph successfully created by LHGraphCreate.
+ *
+ *        IN  numLHSVtx     The number of vertices to add on the left-hand
+ *                          side. Must be >= 0.
+ *
+ *        IN  numRHSVtx     The number of vertices to add on the right-hand
+ *                          side. Must be >= 0.
+ *
+ * Return Value:
+ *
+ *        Error Code
+ */
+int LHAddVertices( LHGRAPH graph, int numLHSVtx, int numRHSVtx ) {
+    Graph     *g;
+    Vertex    *newLVtx, *newRVtx, *v;
+    int        i, j, newNumLHSVtx, newNumRHSVtx;
+
+    /* Check parameters */
+    g = CheckGraph(graph);
+    if( NULL==g || numLHSVtx<0 || numRHSVtx<0 ) {
+        return LH_PARAM_ERR;
+    }
+    newNumLHSVtx = g->numLHSVtx + numLHSVtx;
+    newNumRHSVtx = g->numRHSVtx + numRHSVtx;
+    if( newNumLHSVtx<g->numLHSVtx || newNumRHSVtx<g->numRHSVtx ) {
+        return LH_PARAM_ERR;
+    }
+
+    /* Allocate the new vertex arrays. Adjacency lists hold pointers into
+     * the vertex arrays, so realloc cannot be used. */
+    newLVtx = (Vertex*) calloc( newNumLHSVtx, sizeof(Vertex) );
+    newRVtx = (Vertex*) calloc( newNumRHSVtx, sizeof(Vertex) );
+    if( NULL==newLVtx || NULL==newRVtx ) {
+        free(newLVtx);
+        free(newRVtx);
+        return LH_MEM_ERR;
+    }
+    memcpy( newLVtx, g->lVtx, g->numLHSVtx*sizeof(Vertex) );
+    memcpy( newRVtx, g->rVtx, g->numRHSVtx*sizeof(Vertex) );
+
+    /* Redirect all vertex pointers to the new arrays. The algorithm state
+     * (parent, bucket links) is not live between API calls. */
+    for(i=0;i<newNumLHSVtx+newNumRHSVtx;i++) {
+        v = (i<newNumLHSVtx) ? &newLVtx[i] : &newRVtx[i-newNumLHSVtx];
+        for(j=0;j<v->degree;j++) {
+            v->adjList[j] = TranslateVtx(g, v->adjList[j], newLVtx, newRVtx);
+        }
+        v->matchedWith = TranslateVtx(g, v->matchedWith, newLVtx, newRVtx);
+        v->parent = v->fLink = v->bLink = NULL;
+    }
+
+    /* Renumber: right-hand IDs follow the left-hand ones */
+    for(i=0;i<newNumLHSVtx;i++) {
+        newLVtx[i].id = i;
+    }
+    for(i=0;i<newNumRHSVtx;i++) {
+        newRVtx[i].id = i+newNumLHSVtx;
+    }
+
+    free(g->lVtx);
+    free(g->rVtx);
+    g->lVtx = newLVtx;
+    g->rVtx = newRVtx;
+    g->numLHSVtx = newNumLHSVtx;
+    g->numRHSVtx = newNumRHSVtx;
+
+    return LH_SUCCESS;
+}
+
 /***** LHSetMatchingEdge *****/
 /*
  * Description:
@@ -713,12 +942,49 @@ int LHFindLHMatching( LHGRAPH graph, LHALGTYPE alg ) {
             return LHAlgBFS(g);
             break;
 
+        case LH_ALG_BFS_CSR:
+            return LHAlgBFSCsr(g);
+            break;
+
         default:
             /* Invalid algorithm selection */
             return LH_PARAM_ERR;
     }
 }
 
+/***** LHRepairMatching *****/
+/*
+ * Description:
+ *
+ *        Bring the current matching back to optimal after edges or
+ *        vertices were added or removed with LHAddEdge, LHRemoveEdge,
+ *        LHIsolateVertex, LHAddVertices or LHSetMatchingEdge. Left-hand
+ *        vertices that lost their matching edge are assigned greedily and
+ *        the BFS algorithm then improves the existing matching, which
+ *        usually needs only a few augmentations and one verifying scan.
+ *        The cost is the same as that of a full recomputation.
+ *        
+ * Parameters:
+ *
+ *        IN  graph         A graph successfully created by LHGraphCreate,
+ *                          for which a matching was previously computed.
+ *
+ * Return Value:
+ *
+ *        Error Code
+ */
+int LHRepairMatching( LHGRAPH graph ) {
+    Graph    *g;
+
+    g = CheckGraph(graph);
+    if( NULL==g ) {
+        return LH_PARAM_ERR;
+    }
+
+    ClearAlgState(g);
+    return LHAlgRepair(g);
+}
+
 /***** LHGetMatchedVtx *****/
 /*
  * Description:
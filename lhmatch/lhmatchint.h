@@ -152,6 +152,8 @@ typedef struct {
 /***** Function Prototypes *****/
 int  LHAlgOnline(Graph *g);
 int  LHAlgBFS(Graph *g);
+int  LHAlgRepair(Graph *g);
+int  LHAlgBFSCsr(Graph *g);
 
 void AddVtxToBucket(Graph *g, Vertex *v, int b);
 void RemoveVtxFromBucket(Graph *g, Vertex *v, int b);
@@ -212,6 +212,18 @@ bad:
 #endif /* i386 */
 
 
+// unaligned 8-byte moves are cheap on x86 and amd64 only
+#if defined (i386) || defined (i386compat) || defined (_M_AMD64)
+#define WIDE_COPY 1
+#else
+#define WIDE_COPY 0
+#endif
+
+// copy 8 bytes at once; "dst" shall be at least 8 bytes ahead of "src"
+#define COPY_WORD_8(dst,src) \
+  ((__unaligned __int64 *) (dst))[0] = ((__unaligned __int64 *) (src))[0]
+
+
 #define BIORD(bits) \
   (Mask >> (sizeof (Mask) * 8 - (bits)))
 
@@ -300,12 +312,9 @@ if (Bits < 0)                            \
 #endif
 
 
-XPRESS_EXPORT
-int
-XPRESS_CALL
-XpressDecode
+static int decode_block
 (
-  XpressDecodeStream stream,
+  decode_info       *info,
   void              *orig,
   int                orig_size,
   int                decode_size,
@@ -313,18 +322,8 @@ XpressDecode
   int                comp_size
 )
 {
-  decode_info *info;
   const uchar *src;
 
-#if ALLOCATE_ON_STACK
-  decode_info stack_info;
-  info = &stack_info;
-  info->src.beg = (void *) stream;
-#else
-  if (stream == 0 || (info = (decode_info *) stream)->magic != MAGIC_DECODE || (uint) decode_size > (uint) orig_size)
-    return (-1);
-#endif
-
   if (comp_size == orig_size)
     return (decode_size);
 
@@ -357,8 +356,8 @@ XpressDecode
 
   // we may read at most 7 bytes
   #define RESERVE_SRC ((7 * 8 + 2) * sizeof (tag_t))
-  info->src.careful = info->src.beg;
-  if (info->src.end - info->src.beg > RESERVE_SRC)
+  info->src.careful = src;
+  if (info->src.end - src > RESERVE_SRC)
     info->src.careful = info->src.end - RESERVE_SRC;
 
 #if CODING & (CODING_HUFF_LEN | CODING_HUFF_PTR | CODING_HUFF_ALL)
@@ -366,9 +365,6 @@ XpressDecode
     return (-1);
   src += HUFF_SIZE >> 1;
 #endif
-#if CODING == CODING_BY_BIT
-  bit_to_len_init ();
-#endif
 
   info->src.beg = src;
   info->result = 0;
@@ -384,6 +380,88 @@ XpressDecode
   return (decode_size);
 }
 
+
+XPRESS_EXPORT
+int
+XPRESS_CALL
+XpressDecode
+(
+  XpressDecodeStream stream,
+  void              *orig,
+  int                orig_size,
+  int                decode_size,
+  const void        *comp,
+  int                comp_size
+)
+{
+  decode_info *info;
+
+#if ALLOCATE_ON_STACK
+  decode_info stack_info;
+  info = &stack_info;
+#else
+  if (stream == 0 || (info = (decode_info *) stream)->magic != MAGIC_DECODE || (uint) decode_size > (uint) orig_size)
+    return (-1);
+#endif
+
+#if CODING == CODING_BY_BIT
+  bit_to_len_init ();
+#endif
+
+  return (decode_block (info, orig, orig_size, decode_size, comp, comp_size));
+}
+
+
+XPRESS_EXPORT
+int
+XPRESS_CALL
+XpressDecodeBlocks
+(
+  XpressDecodeStream stream,
+  XpressDecodeBlock *block,
+  int                block_count
+)
+{
+  decode_info *info;
+  int i;
+
+#if ALLOCATE_ON_STACK
+  decode_info stack_info;
+  info = &stack_info;
+#else
+  if (stream == 0 || (info = (decode_info *) stream)->magic != MAGIC_DECODE)
+    return (-1);
+#endif
+
+  if (block == 0 || block_count < 0)
+    return (-1);
+
+#if CODING == CODING_BY_BIT
+  bit_to_len_init ();
+#endif
+
+  for (i = 0; i < block_count; ++i, ++block)
+  {
+#if !ALLOCATE_ON_STACK
+    if ((uint) block->DecodeSize > (uint) block->OrigSize)
+      return (i);
+#endif
+    if (block->CompSize == block->OrigSize)
+    {
+      // stored block: move it in place unless decoding in place
+      if (block->DecodeSize > 0 && block->OrigAdr != block->CompAdr)
+        memmove (block->OrigAdr, block->CompAdr, block->DecodeSize);
+    }
+    else if (decode_block (info, block->OrigAdr, block->OrigSize, block->DecodeSize,
+                           block->CompAdr, block->CompSize) < 0)
+    {
+      return (i);
+    }
+  }
+
+  return (block_count);
+}
+
 XPRESS_EXPORT
 XpressDecodeStream
 XPRESS_CALL
@@ -728,6 +728,17 @@ LABEL (copy_byte):
   *dst++ = *src++;            // copy next byte
 
 LABEL (next):
+#if !CAREFUL && WIDE_COPY
+  // next 8 tokens are literals: copy them at once (sentinel bit in bmask
+  // is nonzero, so it is never shifted out here)
+  while ((utag_t) bmask < (1 << (sizeof (tag_t) * 8 - 8)))
+  {
+    COPY_WORD_8 (dst, src);
+    dst += 8;
+    src += 8;
+    bmask <<= 8;
+  }
+#endif /* !CAREFUL && WIDE_COPY */
   if (bmask >= 0) do            // while MSB(bmask) == 0
   {
     bmask <<= 1;
@@ -770,7 +781,7 @@ LABEL (next):
   {
     const uchar *src1 = dst + ofs;
 
-#if defined (i386) || defined (i386compat)	// unligned access is faster only on x86
+#if WIDE_COPY
     if (ofs < ~2)
     {
       if (src1 < info->dst.beg) RET_ERR;         // check for buffer underrun
@@ -783,7 +794,7 @@ LABEL (next):
       dst += len + MIN_MATCH;                   // dst = next output position
       goto LABEL (next);                        // decode next token
     }
-#endif
+#endif /* WIDE_COPY */
 
     if (src1 < info->dst.beg) RET_ERR;          // check for buffer overrun
 
@@ -849,6 +860,27 @@ careful_copy_tail:
 
   if (src < info->dst.beg) RET_ERR;
 
+#if !CAREFUL && WIDE_COPY
+  // copy 16 bytes per step when source is at least 8 bytes behind; may
+  // write up to 15 bytes past the end of the block, which is fine since
+  // dst + len is below info->dst.careful
+  if (ofs <= ~7)
+  {
+    uchar *end = dst + len;
+    do
+    {
+      COPY_WORD_8 (dst, src);
+      COPY_WORD_8 (dst + 8, src + 8);
+      dst += 16;
+      src += 16;
+    }
+    while (dst < end);
+    dst = end;
+    src = info->src.last;               // restore input buffer ptr
+    goto LABEL (next);
+  }
+#endif /* !CAREFUL && WIDE_COPY */
+
   COPY_BLOCK_SLOW (dst, src, len);      // copy block
 
   src = info->src.last;                 // restore input buffer ptr
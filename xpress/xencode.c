@@ -7,6 +7,11 @@
 /*                                                                          */
 /* ------------------------------------------------------------------------ */
 
+#if !defined (UNIX) && !defined (XPRESS_NO_THREADS)
+#define XPRESS_THREADS 1
+#include <windows.h>
+#endif
+
 #include "xprs.h"
 
 #define MAX_CHAIN       9
@@ -1279,6 +1284,48 @@ restart:
 
 #endif /* CODING */
 
+
+/* ------------------------ Match extension ---------------------------- */
+/*                          ---------------                              */
+
+#ifdef _WIN64
+#define match_word_t unsigned __int64
+#else
+#define match_word_t uint32
+#endif
+
+// returns # of leading bytes that are the same in p1 and p2 (p2 < p1 <= end);
+// compares whole machine words and locates the first mismatching byte
+// within the word (little-endian), so match lengths are exactly the
+// same as with byte-by-byte comparison and the output does not change
+INLINE xint match_extend (const uchar *p1, const uchar *p2, const uchar *end)
+{
+  const uchar *p0 = p1;
+  match_word_t d;
+
+  while ((xint) (end - p1) >= (xint) sizeof (match_word_t))
+  {
+    d = *(const __unaligned match_word_t *) p1 ^ *(const __unaligned match_word_t *) p2;
+    if (d != 0)
+    {
+      while ((d & 0xff) == 0)
+      {
+        d >>= 8;
+        ++p1;
+      }
+      return ((xint) (p1 - p0));
+    }
+    p1 += sizeof (match_word_t);
+    p2 += sizeof (match_word_t);
+  }
+  while (p1 != end && *p1 == *p2)
+  {
+    ++p1;
+    ++p2;
+  }
+  return ((xint) (p1 - p0));
+}
+
 #define CHAIN 0
 #define encode_pass1 encode0_pass1
 #include "xencode.i"
@@ -1753,4 +1800,172 @@ XpressEncodeGetMaxCompressionLevel (
   if (info != 0 && info->magic == MAGIC_ENCODE)
     return (info->max_chain);
   return (-1);
-}
\ No newline at end of file
+}
+
+
+/* ------------------------ Parallel encoder --------------------------- */
+/*                          ----------------                             */
+
+#define XPRESS_MAX_THREADS  32
+
+typedef struct
+{
+  const uchar   *orig;                  // original data
+  uchar         *comp;                  // output; block i is encoded at comp + i*XPRESS_MAX_BLOCK
+  int            orig_size;             // size of original data
+  int           *block_size;            // per-block compressed sizes
+  int            blocks;                // # of blocks
+  volatile long  next;                  // next block to encode
+  volatile long  failed;                // set if any block failed
+} parallel_info;
+
+typedef struct
+{
+  parallel_info     *info;
+  XpressEncodeStream stream;
+} parallel_worker;
+
+static void parallel_encode (parallel_worker *w)
+{
+  parallel_info *pi = w->info;
+  const uchar *orig;
+  uchar *comp;
+  int i, size, comp_size;
+
+  for (;;)
+  {
+#ifdef XPRESS_THREADS
+    i = InterlockedIncrement ((long *) &pi->next) - 1;
+#else
+    i = pi->next++;
+#endif
+    if (i >= pi->blocks || pi->failed)
+      break;
+
+    orig = pi->orig + i * XPRESS_MAX_BLOCK;
+    comp = pi->comp + i * XPRESS_MAX_BLOCK;
+    size = pi->orig_size - i * XPRESS_MAX_BLOCK;
+    if (size > XPRESS_MAX_BLOCK)
+      size = XPRESS_MAX_BLOCK;
+
+    // block output slot is as large as the block itself, so a block
+    // that does not compress is reported as such and stored as is
+    comp_size = XpressEncode (w->stream, comp, size, orig, size, 0, 0, 0);
+    if (comp_size <= 0)
+    {
+      pi->failed = 1;
+      break;
+    }
+    if (comp_size >= size)
+    {
+      memcpy (comp, orig, size);
+      comp_size = size;
+    }
+    pi->block_size[i] = comp_size;
+  }
+}
+
+#ifdef XPRESS_THREADS
+static DWORD WINAPI parallel_thread (LPVOID arg)
+{
+  parallel_encode ((parallel_worker *) arg);
+  return (0);
+}
+#endif
+
+XPRESS_EXPORT
+int
+XPRESS_CALL
+XpressEncodeParallel (
+  void              *CompAdr,
+  int                CompSize,
+  const void        *OrigAdr,
+  int                OrigSize,
+  int               *BlockCompSize,
+  int                CompressionLevel,
+  int                MaxThreads,
+  void              *Context,
+  XpressAllocFn     *AllocFn,
+  XpressFreeFn      *FreeFn
+)
+{
+  parallel_info info;
+  parallel_worker worker[XPRESS_MAX_THREADS];
+#ifdef XPRESS_THREADS
+  HANDLE thread[XPRESS_MAX_THREADS];
+  int started = 0;
+#endif
+  int workers, i, comp_size;
+
+  if (CompAdr == 0 || OrigAdr == 0 || BlockCompSize == 0 || AllocFn == 0 || FreeFn == 0
+    || OrigSize <= 0 || CompSize < OrigSize)
+    return (0);
+
+  info.orig = (const uchar *) OrigAdr;
+  info.comp = (uchar *) CompAdr;
+  info.orig_size = OrigSize;
+  info.block_size = BlockCompSize;
+  info.blocks = (OrigSize + XPRESS_MAX_BLOCK - 1) >> XPRESS_MAX_BLOCK_LOG;
+  info.next = 0;
+  info.failed = 0;
+
+  if (MaxThreads > XPRESS_MAX_THREADS)
+    MaxThreads = XPRESS_MAX_THREADS;
+  if (MaxThreads > info.blocks)
+    MaxThreads = info.blocks;
+#ifndef XPRESS_THREADS
+  MaxThreads = 1;
+#endif
+
+  // create all workspaces up front on this thread: it keeps initialization
+  // of static hash tables single-threaded, and running short of memory
+  // merely reduces parallelism
+  for (workers = 0; workers < MaxThreads || workers == 0; ++workers)
+  {
+    worker[workers].info = &info;
+    worker[workers].stream = XpressEncodeCreate (XPRESS_MAX_BLOCK, Context, AllocFn, CompressionLevel);
+    if (worker[workers].stream == 0)
+      break;
+  }
+  if (workers == 0)
+    return (0);
+
+#ifdef XPRESS_THREADS
+  for (i = 1; i < workers; ++i)
+  {
+    thread[started] = CreateThread (0, 0, parallel_thread, &worker[i], 0, 0);
+    if (thread[started] != 0)
+      ++started;
+  }
+#endif
+
+  // the calling thread is a worker too
+  parallel_encode (&worker[0]);
+
+#ifdef XPRESS_THREADS
+  if (started != 0)
+  {
+    WaitForMultipleObjects (started, thread, TRUE, INFINITE);
+    for (i = 0; i < started; ++i)
+      CloseHandle (thread[i]);
+  }
+#endif
+
+  for (i = 0; i < workers; ++i)
+    XpressEncodeClose (worker[i].stream, Context, FreeFn);
+
+  if (info.failed)
+    return (0);
+
+  // pack encoded blocks; block i never moves past its own slot so
+  // compaction in ascending order never overwrites unprocessed data
+  comp_size = 0;
+  for (i = 0; i < info.blocks; ++i)
+  {
+    if (comp_size != i * XPRESS_MAX_BLOCK)
+      memmove (info.comp + comp_size, info.comp + i * XPRESS_MAX_BLOCK, BlockCompSize[i]);
+    comp_size += BlockCompSize[i];
+  }
+
+  return (comp_size);
+}
@@ -163,47 +163,24 @@ INLINE int find_match (prs *p)
       }
 #endif /* i386compat */
 
-      if (p1 <= v.orig.end_16)
-      {
-        goto entry4;
-        do
-        {
-#define X(i) if (p1[i] != p2[i]) {p1 += i; goto chk;}
-          X(0); X(1); X(2); X(3);
-        entry4:
-          X(4); X(5); X(6); X(7); X(8);
-          X(9); X(10); X(11); X(12); X(13); X(14); X(15);
-#undef  X
-          p1 += 16; p2 += 16;
-        }
-        while (p1 <= v.orig.end_16);
-      }
-      while (p1 != v.orig.end)
+      p1 += match_extend (p1, p2, v.orig.end);
+
+      n = -n;
+      n += (xint) (p1 - v.orig.ptr);
+      if (CHAIN < 3 || n > v.match.len)
       {
-        if (*p1 != *p2)
-          goto chk;
-        ++p1;
-        ++p2;
-      }
-#define SET_LENGTH() \
-      n = -n; \
-      n += (xint) (p1 - v.orig.ptr); \
-      if (CHAIN < 3 || n > v.match.len) \
-      { \
-        v.match.len = n; \
-        v.match.pos = k; \
+        v.match.len = n;
+        v.match.pos = k;
       }
-      SET_LENGTH ();
 #if CHAIN < 3
       return (1);
 #else
-      return (v.match.len >= MIN_MATCH);
+      // match reaching the end of input cannot be improved upon
+      if (p1 == v.orig.end)
+        return (v.match.len >= MIN_MATCH);
 #endif /* CHAIN < 3 */
     }
-  chk:
-    SET_LENGTH ();
 #if CHAIN < 3
-    return (1);
   cont:
     return (0);
 #else
@@ -345,32 +322,11 @@ static void encode_pass1 (prs *p)
 
     {
       const uchar *b0 = b;
+      xint len = 3 + match_extend (b + 3, b1 + 3, v.orig.end);
 
-      if (b <= v.orig.end_16)
-        goto match_entry_3;
-      goto match_careful;
-
-      do
-      {
-#define X(i) if (b1[i] != b[i]) {b += i; b1 += i; goto eval_len;}
-        X(0); X(1); X(2);
-      match_entry_3:
-        X(3); X(4); X(5); X(6); X(7);
-        X(8); X(9); X(10); X(11);
-        X(12); X(13); X(14); X(15);
-#undef  X
-        b += 16; b1 += 16;
-      }
-      while (b <= v.orig.end_16);
-
-    match_careful:
-      while (b != v.orig.end && *b1 == *b)
-      {
-        ++b;
-        ++b1;
-      }
+      b += len;
+      b1 += len;
 
-    eval_len:
 #if BUFF_SIZE_LOG > 16
 #error
 #endif
@@ -145,6 +145,30 @@ XpressEncodeClose (
 );
 
 
+// compress consecutive XPRESS_MAX_BLOCK-sized blocks of input independently
+// using up to MaxThreads threads (including the calling one); every block
+// is encoded exactly as XpressEncode would encode it, and blocks are packed
+// back to back into output memory region. BlockCompSize[i] receives size
+// of i-th block; if it equals size of original block then block did not
+// compress and is stored as is. CompSize shall be at least OrigSize.
+// Returns total size of output data or 0 if compression failed
+XPRESS_EXPORT
+int
+XPRESS_CALL
+XpressEncodeParallel (
+  void              *CompAdr,           // address of beggining of output memory region
+  int                CompSize,          // size of output memory region (bytes)
+  const void        *OrigAdr,           // address of beggining of input data
+  int                OrigSize,          // input data size (bytes)
+  int               *BlockCompSize,     // (OrigSize + XPRESS_MAX_BLOCK - 1) / XPRESS_MAX_BLOCK entries
+  int                CompressionLevel,  // use 0 for speed, 9 for quality
+  int                MaxThreads,        // max. # of threads to use
+  void              *Context,           // user-defined context info (will be passed to AllocFn and FreeFn)
+  XpressAllocFn     *AllocFn,           // memory allocation callback
+  XpressFreeFn      *FreeFn             // memory release callback
+);
+
+
 /* ----------------------------- Decoder ------------------------------ */
 /*                               -------                                */
 
@@ -173,6 +197,30 @@ XpressDecode (
   int                CompSize           // size of compressed data block (bytes)
 );
 
+// description of one block for XpressDecodeBlocks; arguments are the same
+// as of XpressDecode
+typedef struct
+{
+  void              *OrigAdr;           // address of beginning out output memory region
+  int                OrigSize;          // size of output memory region (bytes)
+  int                DecodeSize;        // # of bytes to decode ( <= OrigSize)
+  const void        *CompAdr;           // address of beginning of compressed data block
+  int                CompSize;          // size of compressed data block (bytes)
+} XpressDecodeBlock;
+
+// decode array of blocks in one call; blocks that were stored as is
+// (CompSize == OrigSize) are copied to OrigAdr. Returns # of blocks
+// decoded successfully (BlockCount if all of them) or -1 if arguments
+// are invalid
+XPRESS_EXPORT
+int
+XPRESS_CALL
+XpressDecodeBlocks (
+  XpressDecodeStream DecodeStream,      // decoder's workspace
+  XpressDecodeBlock *Block,             // array of blocks to decode
+  int                BlockCount         // # of blocks
+);
+
 // invalidate decoding stream and release workspace memory
 XPRESS_EXPORT
 void